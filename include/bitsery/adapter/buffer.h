@@ -79,6 +79,17 @@ namespace bitsery {
             }
         }
 
+        //returns pointer to `size` bytes at current position and moves position past them,
+        //or nullptr if there is not enough data, in this case position is not changed and error is not set.
+        const TValue* readBlock(size_t size) {
+            using TDistance = typename std::iterator_traits<TIterator>::difference_type;
+            if (std::distance(this->posIt, this->endIt) < static_cast<TDistance>(size))
+                return nullptr;
+            auto res = std::addressof(*this->posIt);
+            this->posIt += size;
+            return res;
+        }
+
         ReaderError error() const {
             auto res = std::distance(this->endIt, this->posIt);
             if (res > 0) {
@@ -125,6 +136,13 @@ namespace bitsery {
             std::memcpy(data, std::addressof(*tmp), size);
         }
 
+        const TValue* readBlock(size_t size) {
+            auto res = std::addressof(*this->posIt);
+            this->posIt += size;
+            assert(std::distance(this->posIt, this->endIt) >= 0);
+            return res;
+        }
+
         ReaderError error() const {
             return err;
         }
@@ -163,6 +181,12 @@ namespace bitsery {
             writeInternal(data, size, TResizable{});
         }
 
+        //returns pointer to `size` bytes of contiguous memory at current position and moves position past them.
+        //caller must fill this memory before any other call to adapter.
+        TValue* writeBlock(size_t size) {
+            return writeBlockInternal(size, TResizable{});
+        }
+
         void flush() {
             //this function might be useful for stream adapters
         }
@@ -222,6 +246,19 @@ namespace bitsery {
             }
         }
 
+        TValue* writeBlockInternal(size_t size, std::true_type) {
+            using TDistance = typename std::iterator_traits<TIterator>::difference_type;
+            while (std::distance(_outIt, _end) < static_cast<TDistance>(size)) {
+                const auto pos = std::distance(std::begin(*_buffer), _outIt);
+                traits::BufferAdapterTraits<Buffer>::increaseBufferSize(*_buffer);
+                _end = std::end(*_buffer);
+                _outIt = std::next(std::begin(*_buffer), pos);
+            }
+            auto res = std::addressof(*_outIt);
+            _outIt += size;
+            return res;
+        }
+
         /*
          * non resizable buffer
          */
@@ -237,6 +274,13 @@ namespace bitsery {
             assert(std::distance(_outIt, _end) >= 0);
             memcpy(std::addressof(*tmp), data, size);
         }
+
+        TValue* writeBlockInternal(size_t size, std::false_type) {
+            auto res = std::addressof(*_outIt);
+            _outIt += size;
+            assert(std::distance(_outIt, _end) >= 0);
+            return res;
+        }
     };
 
 }
@@ -0,0 +1,402 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_ADAPTER_CHUNKED_BUFFER_H
+#define BITSERY_ADAPTER_CHUNKED_BUFFER_H
+
+#include "../details/adapter_common.h"
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace bitsery {
+
+    namespace details {
+        //chunk header, data is allocated right after it
+        struct Chunk {
+            Chunk* next;
+            size_t capacity;
+            size_t size;
+
+            char* data() {
+                return reinterpret_cast<char*>(this + 1);
+            }
+
+            const char* data() const {
+                return reinterpret_cast<const char*>(this + 1);
+            }
+        };
+    }
+
+    //free list of fixed size chunks, chunks are reused by all buffers that share the pool.
+    //pool is not thread safe.
+    class ChunkPool {
+    public:
+        static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+        explicit ChunkPool(size_t chunkSize = DefaultChunkSize)
+                : _chunkSize{chunkSize > 0 ? chunkSize : 1}
+        {
+        }
+
+        ChunkPool(const ChunkPool&) = delete;
+        ChunkPool& operator=(const ChunkPool&) = delete;
+
+        ~ChunkPool() {
+            shrink();
+        }
+
+        size_t chunkSize() const {
+            return _chunkSize;
+        }
+
+        size_t freeChunksCount() const {
+            return _freeCount;
+        }
+
+        //releases all free chunks to the system
+        void shrink() {
+            while (_free) {
+                auto next = _free->next;
+                ::operator delete(_free);
+                _free = next;
+            }
+            _freeCount = 0;
+        }
+
+        //chunks larger than chunk size are not pooled, they are allocated and released directly
+        details::Chunk* acquire(size_t minCapacity) {
+            details::Chunk* res{};
+            if (minCapacity <= _chunkSize && _free) {
+                res = _free;
+                _free = res->next;
+                --_freeCount;
+            } else {
+                auto capacity = minCapacity > _chunkSize ? minCapacity : _chunkSize;
+                res = static_cast<details::Chunk*>(::operator new(sizeof(details::Chunk) + capacity));
+                res->capacity = capacity;
+            }
+            res->next = nullptr;
+            res->size = 0;
+            return res;
+        }
+
+        //releases linked list of chunks
+        void release(details::Chunk* chunks) {
+            while (chunks) {
+                auto next = chunks->next;
+                if (chunks->capacity == _chunkSize) {
+                    chunks->next = _free;
+                    _free = chunks;
+                    ++_freeCount;
+                } else {
+                    ::operator delete(chunks);
+                }
+                chunks = next;
+            }
+        }
+
+    private:
+        size_t _chunkSize;
+        details::Chunk* _free{};
+        size_t _freeCount{};
+    };
+
+    /*
+     * output buffer made of linked list of chunks, growing never copies already written data.
+     * written data can be iterated as segments of contiguous memory, or flattened to single container.
+     */
+    class ChunkedBuffer {
+    public:
+        //contiguous part of buffer
+        struct Segment {
+            const char* data;
+            size_t size;
+        };
+
+        class SegmentIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Segment;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Segment*;
+            using reference = Segment;
+
+            explicit SegmentIterator(const details::Chunk* chunk = nullptr)
+                    : _chunk{chunk}
+            {
+            }
+
+            Segment operator*() const {
+                return Segment{_chunk->data(), _chunk->size};
+            }
+
+            SegmentIterator& operator++() {
+                _chunk = _chunk->next;
+                return *this;
+            }
+
+            SegmentIterator operator++(int) {
+                auto tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            bool operator==(const SegmentIterator& other) const {
+                return _chunk == other._chunk;
+            }
+
+            bool operator!=(const SegmentIterator& other) const {
+                return _chunk != other._chunk;
+            }
+
+        private:
+            const details::Chunk* _chunk;
+        };
+
+        //creates buffer with own pool
+        explicit ChunkedBuffer(size_t chunkSize = ChunkPool::DefaultChunkSize)
+                : _pool{std::make_shared<ChunkPool>(chunkSize)}
+        {
+        }
+
+        //creates buffer that shares pool with other buffers
+        explicit ChunkedBuffer(std::shared_ptr<ChunkPool> pool)
+                : _pool{std::move(pool)}
+        {
+        }
+
+        ChunkedBuffer(const ChunkedBuffer&) = delete;
+        ChunkedBuffer& operator=(const ChunkedBuffer&) = delete;
+
+        ChunkedBuffer(ChunkedBuffer&& other) noexcept
+                : _pool{std::move(other._pool)},
+                  _head{other._head},
+                  _tail{other._tail},
+                  _size{other._size}
+        {
+            other._head = other._tail = nullptr;
+            other._size = 0;
+        }
+
+        ChunkedBuffer& operator=(ChunkedBuffer&& other) noexcept {
+            if (this != &other) {
+                clear();
+                _pool = std::move(other._pool);
+                _head = other._head;
+                _tail = other._tail;
+                _size = other._size;
+                other._head = other._tail = nullptr;
+                other._size = 0;
+            }
+            return *this;
+        }
+
+        ~ChunkedBuffer() {
+            clear();
+        }
+
+        //returns all chunks to the pool
+        void clear() {
+            if (_pool)
+                _pool->release(_head);
+            _head = _tail = nullptr;
+            _size = 0;
+        }
+
+        size_t size() const {
+            return _size;
+        }
+
+        bool empty() const {
+            return _size == 0;
+        }
+
+        size_t segmentsCount() const {
+            size_t res{};
+            for (auto it = begin(); it != end(); ++it)
+                ++res;
+            return res;
+        }
+
+        SegmentIterator begin() const {
+            return SegmentIterator{_head};
+        }
+
+        SegmentIterator end() const {
+            return SegmentIterator{};
+        }
+
+        //copies all data to contiguous memory, `out` must have at least size() bytes
+        void copyTo(char* out) const {
+            for (auto it = begin(); it != end(); ++it) {
+                auto s = *it;
+                std::memcpy(out, s.data, s.size);
+                out += s.size;
+            }
+        }
+
+        std::vector<char> flatten() const {
+            std::vector<char> res(_size);
+            if (_size)
+                copyTo(res.data());
+            return res;
+        }
+
+        const std::shared_ptr<ChunkPool>& pool() const {
+            return _pool;
+        }
+
+    private:
+        friend class OutputChunkedBufferAdapter;
+
+        details::Chunk* append(size_t minCapacity) {
+            auto chunk = _pool->acquire(minCapacity);
+            if (_tail)
+                _tail->next = chunk;
+            else
+                _head = chunk;
+            _tail = chunk;
+            return chunk;
+        }
+
+        std::shared_ptr<ChunkPool> _pool;
+        details::Chunk* _head{};
+        details::Chunk* _tail{};
+        size_t _size{};
+    };
+
+    //writes to chunked buffer from the beginning, buffer is cleared on construction.
+    //buffer size and segments are updated on flush.
+    class OutputChunkedBufferAdapter {
+    public:
+        using TValue = char;
+        using TIterator = void;
+
+        OutputChunkedBufferAdapter(ChunkedBuffer& buffer)
+                : _buffer{std::addressof(buffer)}
+        {
+            buffer.clear();
+        }
+
+        OutputChunkedBufferAdapter(const OutputChunkedBufferAdapter&) = delete;
+        OutputChunkedBufferAdapter& operator=(const OutputChunkedBufferAdapter&) = delete;
+
+        //moved from adapter doesn't update buffer on flush
+        OutputChunkedBufferAdapter(OutputChunkedBufferAdapter&& other) noexcept
+                : _buffer{other._buffer},
+                  _chunk{other._chunk},
+                  _pos{other._pos},
+                  _end{other._end},
+                  _written{other._written}
+        {
+            other.detach();
+        }
+
+        OutputChunkedBufferAdapter& operator=(OutputChunkedBufferAdapter&& other) noexcept {
+            _buffer = other._buffer;
+            _chunk = other._chunk;
+            _pos = other._pos;
+            _end = other._end;
+            _written = other._written;
+            other.detach();
+            return *this;
+        }
+
+        void write(const TValue* data, size_t size) {
+            if (static_cast<size_t>(_end - _pos) >= size) {
+                std::memcpy(_pos, data, size);
+                _pos += size;
+            } else {
+                writeSlow(data, size);
+            }
+        }
+
+        //block that doesn't fit in current chunk is written to the new chunk, leaving unused space in current one
+        TValue* writeBlock(size_t size) {
+            if (static_cast<size_t>(_end - _pos) < size)
+                nextChunk(size);
+            auto res = _pos;
+            _pos += size;
+            return res;
+        }
+
+        void flush() {
+            commit();
+        }
+
+        size_t writtenBytesCount() const {
+            return _chunk ? _written + static_cast<size_t>(_pos - _chunk->data()) : _written;
+        }
+
+    private:
+
+        void writeSlow(const TValue* data, size_t size) {
+            for (;;) {
+                auto count = static_cast<size_t>(_end - _pos);
+                count = count < size ? count : size;
+                //_pos might be nullptr before first chunk
+                if (count) {
+                    std::memcpy(_pos, data, count);
+                    _pos += count;
+                    data += count;
+                    size -= count;
+                }
+                if (size == 0)
+                    return;
+                nextChunk(0);
+            }
+        }
+
+        void nextChunk(size_t minCapacity) {
+            commit();
+            if (_chunk)
+                _written += _chunk->size;
+            _chunk = _buffer->append(minCapacity);
+            _pos = _chunk->data();
+            _end = _pos + _chunk->capacity;
+        }
+
+        void commit() {
+            if (_chunk) {
+                _chunk->size = static_cast<size_t>(_pos - _chunk->data());
+                _buffer->_size = _written + _chunk->size;
+            }
+        }
+
+        void detach() {
+            _chunk = nullptr;
+            _pos = _end = nullptr;
+        }
+
+        ChunkedBuffer* _buffer;
+        details::Chunk* _chunk{};
+        TValue* _pos{};
+        TValue* _end{};
+        size_t _written{};
+    };
+
+}
+
+#endif //BITSERY_ADAPTER_CHUNKED_BUFFER_H
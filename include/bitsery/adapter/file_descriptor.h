@@ -0,0 +1,272 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_ADAPTER_FILE_DESCRIPTOR_H
+#define BITSERY_ADAPTER_FILE_DESCRIPTOR_H
+
+/*
+ * POSIX only.
+ * adapters that read/write directly to file descriptor (file, pipe, socket) with read/write/pread,
+ * using own buffer instead of iostreams.
+ * file descriptor is not owned by adapter, and is not closed.
+ */
+
+#include "../details/adapter_common.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace bitsery {
+
+    namespace details {
+        //buffer aligned to page boundary, so that it could also be used with O_DIRECT
+        struct FdBufferDeleter {
+            void operator()(char* p) const {
+                std::free(p);
+            }
+        };
+
+        using FdBuffer = std::unique_ptr<char, FdBufferDeleter>;
+
+        inline FdBuffer allocateFdBuffer(size_t size) {
+            void* p{};
+            if (posix_memalign(&p, 4096, size ? size : 1) != 0)
+                throw std::bad_alloc{};
+            return FdBuffer{static_cast<char*>(p)};
+        }
+    }
+
+    class InputFdAdapter {
+    public:
+        using TValue = char;
+        using TIterator = void;//TIterator is used with sessions, but file descriptors cannot be used with sessions
+
+        static constexpr size_t DefaultBufferSize = 64 * 1024;
+
+        //if offset is not negative, data is read with pread starting from offset, and file position is not changed
+        explicit InputFdAdapter(int fd, size_t bufferSize = DefaultBufferSize, off_t offset = -1)
+                :_fd{fd},
+                 _offset{offset},
+                 _buf{details::allocateFdBuffer(bufferSize)},
+                 _bufSize{bufferSize}
+        {
+        }
+
+        template <typename T>
+        void read(T& data) {
+            read(reinterpret_cast<TValue*>(&data), sizeof(T));
+        }
+
+        void read(TValue* data, size_t size) {
+            //after error all reads go through slow path, that zeroes data
+            if (_end - _pos >= size && _err == ReaderError::NoError) {
+                std::memcpy(data, _buf.get() + _pos, size);
+                _pos += size;
+            } else {
+                readSlow(data, size);
+            }
+        }
+
+        ReaderError error() const {
+            return _err;
+        }
+
+        //checks if there is no more data, for pipes and sockets it waits until other end is closed
+        bool isCompletedSuccessfully() const {
+            if (_err != ReaderError::NoError)
+                return false;
+            if (_pos != _end)
+                return false;
+            return fill() == 0 && _err == ReaderError::NoError;
+        }
+
+        void setError(ReaderError error) {
+            _err = error;
+        }
+
+    private:
+
+        void readSlow(TValue* data, size_t size) {
+            if (_err != ReaderError::NoError) {
+                std::memset(data, 0, size);
+                return;
+            }
+            //on failure whole value is zeroed, same as buffer adapter does
+            auto begin = data;
+            auto total = size;
+            auto available = _end - _pos;
+            std::memcpy(data, _buf.get() + _pos, available);
+            _pos = _end;
+            data += available;
+            size -= available;
+            //read large data directly, without copying to buffer
+            while (size >= _bufSize) {
+                auto res = readSome(data, size);
+                if (res == 0) {
+                    setReadError(begin, total);
+                    return;
+                }
+                data += res;
+                size -= res;
+            }
+            while (size > 0) {
+                auto res = fill();
+                if (res == 0) {
+                    setReadError(begin, total);
+                    return;
+                }
+                auto count = res < size ? res : size;
+                std::memcpy(data, _buf.get(), count);
+                _pos = count;
+                data += count;
+                size -= count;
+            }
+        }
+
+        void setReadError(TValue* data, size_t size) {
+            std::memset(data, 0, size);
+            if (_err == ReaderError::NoError)
+                _err = ReaderError::DataOverflow;
+        }
+
+        //refills buffer, returns bytes count, zero on end of data or error
+        size_t fill() const {
+            _pos = 0;
+            _end = readSome(_buf.get(), _bufSize);
+            return _end;
+        }
+
+        //returns zero on end of data or error, sets ReadingError on error
+        size_t readSome(TValue* data, size_t size) const {
+            for (;;) {
+                auto res = _offset < 0
+                           ? ::read(_fd, data, size)
+                           : ::pread(_fd, data, size, _offset);
+                if (res > 0) {
+                    if (_offset >= 0)
+                        _offset += res;
+                    return static_cast<size_t>(res);
+                }
+                if (res == 0)
+                    return 0;
+                if (errno != EINTR) {
+                    _err = ReaderError::ReadingError;
+                    return 0;
+                }
+            }
+        }
+
+        int _fd;
+        //checking for end of data refills buffer, so reading state is mutable
+        mutable off_t _offset;
+        details::FdBuffer _buf;
+        size_t _bufSize;
+        mutable size_t _pos{};
+        mutable size_t _end{};
+        mutable ReaderError _err{ReaderError::NoError};
+    };
+
+    class OutputFdAdapter {
+    public:
+        using TValue = char;
+        using TIterator = void;//TIterator is used with sessions, but file descriptors cannot be used with sessions
+
+        static constexpr size_t DefaultBufferSize = 64 * 1024;
+
+        explicit OutputFdAdapter(int fd, size_t bufferSize = DefaultBufferSize)
+                :_fd{fd},
+                 _buf{details::allocateFdBuffer(bufferSize)},
+                 _bufSize{bufferSize}
+        {
+        }
+
+        template <typename T>
+        void write(const T& data) {
+            write(reinterpret_cast<const TValue*>(&data), sizeof(T));
+        }
+
+        void write(const TValue* data, size_t size) {
+            if (_bufSize - _used >= size) {
+                std::memcpy(_buf.get() + _used, data, size);
+                _used += size;
+            } else {
+                writeSlow(data, size);
+            }
+        }
+
+        //writes buffered data to file descriptor, but doesn't call fsync
+        void flush() {
+            writeAll(_buf.get(), _used);
+            _used = 0;
+        }
+
+        size_t writtenBytesCount() const {
+            return _written + _used;
+        }
+
+        //this method is only for stream writing
+        bool isValidState() const {
+            return !_failed;
+        }
+
+    private:
+
+        void writeSlow(const TValue* data, size_t size) {
+            flush();
+            if (size >= _bufSize) {
+                writeAll(data, size);
+            } else {
+                std::memcpy(_buf.get(), data, size);
+                _used = size;
+            }
+        }
+
+        //handles short writes and EINTR, after error all data is discarded.
+        //write that makes no progress is treated as error, otherwise it would loop forever
+        void writeAll(const TValue* data, size_t size) {
+            _written += size;
+            while (size > 0 && !_failed) {
+                auto res = ::write(_fd, data, size);
+                if (res > 0) {
+                    data += res;
+                    size -= static_cast<size_t>(res);
+                } else if (res == 0 || errno != EINTR) {
+                    _failed = true;
+                }
+            }
+        }
+
+        int _fd;
+        details::FdBuffer _buf;
+        size_t _bufSize;
+        size_t _used{};
+        size_t _written{};
+        bool _failed{};
+    };
+
+}
+
+#endif //BITSERY_ADAPTER_FILE_DESCRIPTOR_H
@@ -0,0 +1,713 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_ADAPTER_IO_URING_H
+#define BITSERY_ADAPTER_IO_URING_H
+
+/*
+ * Linux only.
+ * adapters that keep several buffers in flight using io_uring (raw syscalls, liburing is not required),
+ * so that serialization continues while previous buffers are written, and reader keeps reads queued ahead.
+ * if io_uring is not available (old kernel or headers, disabled by sysctl or seccomp) or IoMode::Sync is used,
+ * the same buffers are written/read synchronously with pwrite/pread.
+ * file descriptor must be seekable (regular file or block device), it is not owned by adapter.
+ * when file descriptor is opened with O_DIRECT, starting offset must be aligned to 4096, last partial block
+ * is padded with zeros and file is truncated to the end of written data on flush.
+ */
+
+#include "file_descriptor.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+//read/write opcodes and probing are available since 5.6 headers
+#if defined(IORING_FEAT_RW_CUR_POS) && defined(__NR_io_uring_setup)
+#define BITSERY_HAS_IO_URING 1
+#endif
+#endif
+#endif
+
+#ifndef BITSERY_HAS_IO_URING
+#define BITSERY_HAS_IO_URING 0
+#endif
+
+namespace bitsery {
+
+    enum class IoMode {
+        Auto,//use io_uring when available, otherwise synchronous I/O
+        Sync
+    };
+
+    namespace details {
+
+        constexpr size_t IoBlockSize = 4096;
+
+        inline size_t alignIoSize(size_t size) {
+            return (size + IoBlockSize - 1) / IoBlockSize * IoBlockSize;
+        }
+
+        inline bool isDirectIo(int fd) {
+#ifdef O_DIRECT
+            auto flags = fcntl(fd, F_GETFL);
+            return flags != -1 && (flags & O_DIRECT) != 0;
+#else
+            (void)fd;
+            return false;
+#endif
+        }
+
+        //submits read/write requests to io_uring, or executes them immediately when io_uring is not available.
+        //completions are identified by tag, result is transferred bytes count or negative errno.
+        class IoQueue {
+        public:
+            IoQueue(int fd, unsigned entries, IoMode mode)
+                    :_fd{fd}
+            {
+#if BITSERY_HAS_IO_URING
+                if (mode == IoMode::Auto)
+                    setupRing(entries);
+#else
+                (void)entries;
+                (void)mode;
+#endif
+            }
+
+            IoQueue(const IoQueue&) = delete;
+            IoQueue& operator=(const IoQueue&) = delete;
+
+            ~IoQueue() {
+#if BITSERY_HAS_IO_URING
+                if (_ring >= 0)
+                    closeRing();
+#endif
+            }
+
+            bool isAsync() const {
+                return _ring >= 0;
+            }
+
+            //returns false if request cannot be submitted
+            bool submit(bool isWrite, char* data, size_t size, off_t offset, size_t tag) {
+#if BITSERY_HAS_IO_URING
+                if (_ring >= 0)
+                    return submitRing(isWrite, data, size, offset, tag);
+#endif
+                ssize_t res{};
+                do {
+                    res = isWrite
+                          ? ::pwrite(_fd, data, size, offset)
+                          : ::pread(_fd, data, size, offset);
+                } while (res < 0 && errno == EINTR);
+                _completed.emplace_back(tag, res < 0 ? -errno : res);
+                return true;
+            }
+
+            //waits for any completed request, returns false if waiting failed
+            bool wait(size_t& tag, ssize_t& res) {
+#if BITSERY_HAS_IO_URING
+                if (_ring >= 0)
+                    return waitRing(tag, res);
+#endif
+                if (_completed.empty())
+                    return false;
+                tag = _completed.front().first;
+                res = _completed.front().second;
+                _completed.erase(_completed.begin());
+                return true;
+            }
+
+        private:
+#if BITSERY_HAS_IO_URING
+            static int ringSetup(unsigned entries, io_uring_params* p) {
+                return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+            }
+
+            static int ringEnter(int ring, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+                return static_cast<int>(::syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, flags, nullptr, 0));
+            }
+
+            static bool isOpSupported(int ring) {
+                constexpr unsigned OpsCount = 256;
+                std::vector<char> mem(sizeof(io_uring_probe) + OpsCount * sizeof(io_uring_probe_op));
+                auto probe = reinterpret_cast<io_uring_probe*>(mem.data());
+                if (::syscall(__NR_io_uring_register, ring, IORING_REGISTER_PROBE, probe, OpsCount) < 0)
+                    return false;
+                return probe->last_op >= IORING_OP_WRITE
+                       && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)
+                       && (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+            }
+
+            void setupRing(unsigned entries) {
+                io_uring_params p{};
+                auto ring = ringSetup(entries, &p);
+                if (ring < 0)
+                    return;
+                if (!isOpSupported(ring)) {
+                    ::close(ring);
+                    return;
+                }
+                _sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+                _cqSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+                _sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+                _singleMmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (_singleMmap)
+                    _sqSize = _cqSize = _sqSize > _cqSize ? _sqSize : _cqSize;
+                auto map = [ring](size_t size, off_t off) {
+                    return ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, off);
+                };
+                _sq = map(_sqSize, static_cast<off_t>(IORING_OFF_SQ_RING));
+                _cq = _singleMmap ? _sq : map(_cqSize, static_cast<off_t>(IORING_OFF_CQ_RING));
+                auto sqes = map(_sqesSize, static_cast<off_t>(IORING_OFF_SQES));
+                _sqes = sqes == MAP_FAILED ? nullptr : static_cast<io_uring_sqe*>(sqes);
+                _ring = ring;
+                if (_sq == MAP_FAILED || _cq == MAP_FAILED || _sqes == nullptr) {
+                    closeRing();
+                    return;
+                }
+                auto sq = static_cast<char*>(_sq);
+                auto cq = static_cast<char*>(_cq);
+                _sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+                _sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+                _sqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+                _sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+                _cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+                _cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+                _cqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+                _cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+            }
+
+            void closeRing() {
+                if (_sqes != nullptr)
+                    ::munmap(_sqes, _sqesSize);
+                if (_cq != MAP_FAILED && !_singleMmap)
+                    ::munmap(_cq, _cqSize);
+                if (_sq != MAP_FAILED)
+                    ::munmap(_sq, _sqSize);
+                ::close(_ring);
+                _ring = -1;
+            }
+
+            //at most one request per buffer is in flight, so submission queue never overflows
+            bool submitRing(bool isWrite, char* data, size_t size, off_t offset, size_t tag) {
+                auto tail = *_sqTail;
+                auto idx = tail & _sqMask;
+                auto& sqe = _sqes[idx];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+                sqe.fd = _fd;
+                sqe.addr = reinterpret_cast<uintptr_t>(data);
+                sqe.len = static_cast<uint32_t>(size);
+                sqe.off = static_cast<uint64_t>(offset);
+                sqe.user_data = tag;
+                _sqArray[idx] = idx;
+                __atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+                for (;;) {
+                    auto res = ringEnter(_ring, 1, 0, 0);
+                    //once kernel consumed entry, request is in flight and its completion must be reaped
+                    if (res > 0 || __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) != tail)
+                        return true;
+                    if (res < 0 && errno == EINTR)
+                        continue;
+                    //entry was not consumed, withdraw it so it isn't submitted later with another request
+                    __atomic_store_n(_sqTail, tail, __ATOMIC_RELEASE);
+                    return false;
+                }
+            }
+
+            bool waitRing(size_t& tag, ssize_t& res) {
+                for (;;) {
+                    auto head = *_cqHead;
+                    if (head != __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE)) {
+                        auto& cqe = _cqes[head & _cqMask];
+                        tag = static_cast<size_t>(cqe.user_data);
+                        res = cqe.res;
+                        __atomic_store_n(_cqHead, head + 1, __ATOMIC_RELEASE);
+                        return true;
+                    }
+                    if (ringEnter(_ring, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                        return false;
+                }
+            }
+
+            void* _sq{MAP_FAILED};
+            void* _cq{MAP_FAILED};
+            io_uring_sqe* _sqes{};
+            size_t _sqSize{};
+            size_t _cqSize{};
+            size_t _sqesSize{};
+            bool _singleMmap{};
+            unsigned* _sqHead{};
+            unsigned* _sqTail{};
+            unsigned _sqMask{};
+            unsigned* _sqArray{};
+            unsigned* _cqHead{};
+            unsigned* _cqTail{};
+            unsigned _cqMask{};
+            io_uring_cqe* _cqes{};
+#endif
+            int _fd;
+            int _ring{-1};
+            std::vector<std::pair<size_t, ssize_t>> _completed{};
+        };
+
+        //aligned buffer, and state of request that it is used in
+        struct IoSlot {
+            FdBuffer buf;
+            size_t size;//requested bytes count
+            size_t done;//transferred bytes count
+            off_t offset;
+            bool pending;
+            bool failed;
+        };
+
+        //keeps buffers and their requests, buffers are used in round-robin order
+        class IoSlots {
+        public:
+            IoSlots(int fd, bool isWrite, size_t bufferSize, size_t count, IoMode mode)
+                    :_queue{fd, static_cast<unsigned>(count), mode},
+                     _isWrite{isWrite},
+                     _direct{isDirectIo(fd)}
+            {
+                for (size_t i = 0; i < count; ++i)
+                    _slots.push_back(IoSlot{allocateFdBuffer(bufferSize), 0, 0, 0, false, false});
+            }
+
+            IoSlots(const IoSlots&) = delete;
+            IoSlots& operator=(const IoSlots&) = delete;
+
+            //buffers cannot be released while kernel is using them
+            ~IoSlots() {
+                waitAll();
+            }
+
+            bool isAsync() const {
+                return _queue.isAsync();
+            }
+
+            IoSlot& operator[](size_t i) {
+                return _slots[i];
+            }
+
+            size_t count() const {
+                return _slots.size();
+            }
+
+            bool isDirect() const {
+                return _direct;
+            }
+
+            void submit(size_t i, size_t size, off_t offset) {
+                auto& s = _slots[i];
+                s.size = size;
+                s.done = 0;
+                s.offset = offset;
+                s.failed = false;
+                s.pending = true;
+                resubmit(i);
+            }
+
+            void waitFor(size_t i) {
+                while (_slots[i].pending)
+                    completeOne();
+            }
+
+            void waitAll() {
+                for (size_t i = 0; i < _slots.size(); ++i)
+                    waitFor(i);
+            }
+
+        private:
+
+            void resubmit(size_t i) {
+                auto& s = _slots[i];
+                if (!_queue.submit(_isWrite, s.buf.get() + s.done, s.size - s.done,
+                                   s.offset + static_cast<off_t>(s.done), i)) {
+                    s.failed = true;
+                    s.pending = false;
+                }
+            }
+
+            //short transfers are continued, except reads with O_DIRECT, where short read means end of file
+            void completeOne() {
+                size_t i{};
+                ssize_t res{};
+                if (!_queue.wait(i, res)) {
+                    for (auto& s: _slots) {
+                        s.failed = s.failed || s.pending;
+                        s.pending = false;
+                    }
+                    return;
+                }
+                auto& s = _slots[i];
+                if (res == -EINTR || res == -EAGAIN) {
+                    resubmit(i);
+                } else if (res < 0) {
+                    s.failed = true;
+                    s.pending = false;
+                } else {
+                    s.done += static_cast<size_t>(res);
+                    auto eof = res == 0 || (!_isWrite && _direct);
+                    if (s.done == s.size || eof) {
+                        //write that doesn't make progress is an error
+                        s.failed = _isWrite && s.done != s.size;
+                        s.pending = false;
+                    } else {
+                        resubmit(i);
+                    }
+                }
+            }
+
+            IoQueue _queue;
+            std::vector<IoSlot> _slots{};
+            bool _isWrite;
+            bool _direct;
+        };
+
+        class IoUringWriter {
+        public:
+            IoUringWriter(int fd, off_t offset, size_t bufferSize, size_t queueDepth, IoMode mode)
+                    :_fd{fd},
+                     _slots{fd, true, bufferSize, queueDepth, mode},
+                     _offset{offset}
+            {
+            }
+
+            char* current() {
+                return _slots[_cur].buf.get();
+            }
+
+            //submits full current buffer, returns next free buffer
+            char* submit(size_t size) {
+                submitCurrent(size);
+                _offset += static_cast<off_t>(size);
+                _cur = (_cur + 1) % _slots.count();
+                _slots.waitFor(_cur);
+                checkFailed(_cur);
+                return current();
+            }
+
+            //submits current buffer and waits for all writes to complete.
+            //returns bytes count left in current buffer, this is unaligned tail when O_DIRECT is used
+            size_t flush(size_t size) {
+                size_t tail{};
+                if (size > 0) {
+                    auto submitSize = size;
+                    if (_slots.isDirect()) {
+                        tail = size % IoBlockSize;
+                        submitSize = alignIoSize(size);
+                        std::memset(current() + size, 0, submitSize - size);
+                    }
+                    submitCurrent(submitSize);
+                    auto prev = _cur;
+                    _cur = (_cur + 1) % _slots.count();
+                    _slots.waitAll();
+                    for (size_t i = 0; i < _slots.count(); ++i)
+                        checkFailed(i);
+                    if (tail > 0) {
+                        //padding was written, so truncate file and keep tail, it will be written again with next block
+                        _failed = _failed || ::ftruncate(_fd, _offset + static_cast<off_t>(size)) != 0;
+                        std::memcpy(current(), _slots[prev].buf.get() + (size - tail), tail);
+                    }
+                    _offset += static_cast<off_t>(size - tail);
+                } else {
+                    _slots.waitAll();
+                    for (size_t i = 0; i < _slots.count(); ++i)
+                        checkFailed(i);
+                }
+                return tail;
+            }
+
+            bool failed() const {
+                return _failed;
+            }
+
+            bool isAsync() const {
+                return _slots.isAsync();
+            }
+
+        private:
+
+            void submitCurrent(size_t size) {
+                //after failure data is discarded
+                if (!_failed)
+                    _slots.submit(_cur, size, _offset);
+            }
+
+            void checkFailed(size_t i) {
+                _failed = _failed || _slots[i].failed;
+                _slots[i].failed = false;
+            }
+
+            int _fd;
+            IoSlots _slots;
+            off_t _offset;
+            size_t _cur{};
+            bool _failed{};
+        };
+
+        class IoUringReader {
+        public:
+            IoUringReader(int fd, off_t offset, size_t bufferSize, size_t queueDepth, IoMode mode)
+                    :_slots{fd, false, bufferSize, queueDepth, mode},
+                     _bufSize{bufferSize},
+                     _offset{offset}
+            {
+                for (size_t i = 0; i < _slots.count(); ++i)
+                    submitNext(i);
+            }
+
+            //releases current buffer for next read, and waits for next buffer.
+            //returns false on end of data or error
+            bool next(const char*& data, size_t& size, ReaderError& err) {
+                if (_started) {
+                    if (isLast(_cur))
+                        return false;
+                    submitNext(_cur);
+                    _cur = (_cur + 1) % _slots.count();
+                }
+                _started = true;
+                _slots.waitFor(_cur);
+                auto& s = _slots[_cur];
+                if (s.failed) {
+                    err = ReaderError::ReadingError;
+                    return false;
+                }
+                data = s.buf.get();
+                size = s.done;
+                return size > 0;
+            }
+
+            //checks if there is no more data after current buffer
+            bool isAtEnd() {
+                if (_started && isLast(_cur))
+                    return true;
+                auto i = _started ? (_cur + 1) % _slots.count() : _cur;
+                _slots.waitFor(i);
+                return _slots[i].done == 0 && !_slots[i].failed;
+            }
+
+            bool isAsync() const {
+                return _slots.isAsync();
+            }
+
+        private:
+
+            bool isLast(size_t i) {
+                return _slots[i].done < _slots[i].size;
+            }
+
+            void submitNext(size_t i) {
+                _slots.submit(i, _bufSize, _offset);
+                _offset += static_cast<off_t>(_bufSize);
+            }
+
+            IoSlots _slots;
+            size_t _bufSize;
+            off_t _offset;
+            size_t _cur{};
+            bool _started{};
+        };
+
+        inline size_t ioQueueDepth(size_t queueDepth) {
+            //reader needs at least two buffers, to check for end of data without releasing current buffer
+            return queueDepth < 2 ? 2 : queueDepth;
+        }
+    }
+
+    class OutputIoUringAdapter {
+    public:
+        using TValue = char;
+        using TIterator = void;//TIterator is used with sessions, but file descriptors cannot be used with sessions
+
+        static constexpr size_t DefaultBufferSize = 1024 * 1024;
+        static constexpr size_t DefaultQueueDepth = 4;
+
+        //buffer size is rounded up to 4096, at most queueDepth buffers are written concurrently
+        explicit OutputIoUringAdapter(int fd, off_t offset = 0, size_t bufferSize = DefaultBufferSize,
+                                      size_t queueDepth = DefaultQueueDepth, IoMode mode = IoMode::Auto)
+                :_impl{new details::IoUringWriter{fd, offset, details::alignIoSize(bufferSize),
+                                                  details::ioQueueDepth(queueDepth), mode}},
+                 _buf{_impl->current()},
+                 _bufSize{details::alignIoSize(bufferSize)}
+        {
+        }
+
+        OutputIoUringAdapter(const OutputIoUringAdapter&) = delete;
+        OutputIoUringAdapter& operator=(const OutputIoUringAdapter&) = delete;
+        OutputIoUringAdapter(OutputIoUringAdapter&&) = default;
+        OutputIoUringAdapter& operator=(OutputIoUringAdapter&&) = default;
+
+        template <typename T>
+        void write(const T& data) {
+            write(reinterpret_cast<const TValue*>(&data), sizeof(T));
+        }
+
+        void write(const TValue* data, size_t size) {
+            if (_bufSize - _used >= size) {
+                std::memcpy(_buf + _used, data, size);
+                _used += size;
+            } else {
+                writeSlow(data, size);
+            }
+        }
+
+        //waits until all buffered data is written, but doesn't call fsync
+        void flush() {
+            if (!_impl)
+                return;
+            auto tail = _impl->flush(_used);
+            _written += _used - tail;
+            _used = tail;
+            _buf = _impl->current();
+        }
+
+        size_t writtenBytesCount() const {
+            return _written + _used;
+        }
+
+        //this method is only for stream writing
+        bool isValidState() const {
+            return _impl && !_impl->failed();
+        }
+
+        //false when io_uring is not available and synchronous I/O is used
+        bool isAsync() const {
+            return _impl && _impl->isAsync();
+        }
+
+    private:
+
+        void writeSlow(const TValue* data, size_t size) {
+            for (;;) {
+                auto count = _bufSize - _used < size ? _bufSize - _used : size;
+                std::memcpy(_buf + _used, data, count);
+                _used += count;
+                data += count;
+                size -= count;
+                if (size == 0)
+                    return;
+                _buf = _impl->submit(_used);
+                _written += _used;
+                _used = 0;
+            }
+        }
+
+        std::unique_ptr<details::IoUringWriter> _impl;
+        char* _buf;
+        size_t _bufSize;
+        size_t _used{};
+        size_t _written{};
+    };
+
+    class InputIoUringAdapter {
+    public:
+        using TValue = char;
+        using TIterator = void;//TIterator is used with sessions, but file descriptors cannot be used with sessions
+
+        static constexpr size_t DefaultBufferSize = 1024 * 1024;
+        static constexpr size_t DefaultQueueDepth = 4;
+
+        //buffer size is rounded up to 4096, reads for all queueDepth buffers are submitted ahead
+        explicit InputIoUringAdapter(int fd, off_t offset = 0, size_t bufferSize = DefaultBufferSize,
+                                     size_t queueDepth = DefaultQueueDepth, IoMode mode = IoMode::Auto)
+                :_impl{new details::IoUringReader{fd, offset, details::alignIoSize(bufferSize),
+                                                  details::ioQueueDepth(queueDepth), mode}}
+        {
+        }
+
+        InputIoUringAdapter(const InputIoUringAdapter&) = delete;
+        InputIoUringAdapter& operator=(const InputIoUringAdapter&) = delete;
+        InputIoUringAdapter(InputIoUringAdapter&&) = default;
+        InputIoUringAdapter& operator=(InputIoUringAdapter&&) = default;
+
+        template <typename T>
+        void read(T& data) {
+            read(reinterpret_cast<TValue*>(&data), sizeof(T));
+        }
+
+        void read(TValue* data, size_t size) {
+            if (_end - _pos >= size) {
+                std::memcpy(data, _buf + _pos, size);
+                _pos += size;
+            } else {
+                readSlow(data, size);
+            }
+        }
+
+        ReaderError error() const {
+            return _err;
+        }
+
+        //waits for next read to complete, if current buffer is fully read
+        bool isCompletedSuccessfully() const {
+            return _err == ReaderError::NoError && _pos == _end && _impl && _impl->isAtEnd();
+        }
+
+        void setError(ReaderError error) {
+            _err = error;
+        }
+
+        //false when io_uring is not available and synchronous I/O is used
+        bool isAsync() const {
+            return _impl && _impl->isAsync();
+        }
+
+    private:
+
+        void readSlow(TValue* data, size_t size) {
+            //on failure whole value is zeroed, same as buffer adapter does
+            auto begin = data;
+            auto total = size;
+            while (_err == ReaderError::NoError) {
+                auto count = _end - _pos < size ? _end - _pos : size;
+                //buffer is null before first chunk is read
+                if (count)
+                    std::memcpy(data, _buf + _pos, count);
+                _pos += count;
+                data += count;
+                size -= count;
+                if (size == 0)
+                    return;
+                _pos = 0;
+                _end = 0;
+                if (!_impl->next(_buf, _end, _err) && _err == ReaderError::NoError)
+                    _err = ReaderError::DataOverflow;
+            }
+            std::memset(begin, 0, total);
+        }
+
+        std::unique_ptr<details::IoUringReader> _impl;
+        const char* _buf{};
+        size_t _pos{};
+        size_t _end{};
+        ReaderError _err{ReaderError::NoError};
+    };
+
+}
+
+#endif //BITSERY_ADAPTER_IO_URING_H
@@ -0,0 +1,308 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_ADAPTER_SEGMENTED_BUFFER_H
+#define BITSERY_ADAPTER_SEGMENTED_BUFFER_H
+
+#include "../details/adapter_common.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace bitsery {
+
+    //contiguous part of input, segments are not copied, so they must outlive the adapter
+    struct BufferSegment {
+        const char* data;
+        size_t size;
+    };
+
+    namespace details {
+        struct SegmentInfo {
+            const char* data;
+            const char* end;
+            size_t offset;//position of first byte in whole input
+        };
+
+        //non empty segments, followed by empty sentinel segment at the end of input
+        using SegmentTable = std::vector<SegmentInfo>;
+    }
+
+    //random access iterator over chain of segments, it is used by sessions reader.
+    //position at the end of segment is the same as position at the beginning of the next one.
+    class SegmentedBufferIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = char;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char*;
+        using reference = const char&;
+
+        SegmentedBufferIterator() = default;
+
+        SegmentedBufferIterator(const details::SegmentTable* table, size_t pos)
+                : _table{table}
+        {
+            locate(pos);
+        }
+
+        reference operator*() const {
+            return *(_ptr != _seg->end ? _ptr : (_seg + 1)->data);
+        }
+
+        pointer operator->() const {
+            return std::addressof(**this);
+        }
+
+        reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        SegmentedBufferIterator& operator++() {
+            if (_ptr == _seg->end) {
+                ++_seg;
+                _ptr = _seg->data;
+            }
+            ++_ptr;
+            return *this;
+        }
+
+        SegmentedBufferIterator operator++(int) {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        SegmentedBufferIterator& operator--() {
+            if (_ptr == _seg->data) {
+                --_seg;
+                _ptr = _seg->end;
+            }
+            --_ptr;
+            return *this;
+        }
+
+        SegmentedBufferIterator operator--(int) {
+            auto tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        SegmentedBufferIterator& operator+=(difference_type n) {
+            auto inSegment = (_ptr - _seg->data) + n;
+            if (inSegment >= 0 && inSegment <= _seg->end - _seg->data)
+                _ptr += n;
+            else
+                locate(static_cast<size_t>(static_cast<difference_type>(position()) + n));
+            return *this;
+        }
+
+        SegmentedBufferIterator& operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        friend SegmentedBufferIterator operator+(SegmentedBufferIterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend SegmentedBufferIterator operator+(difference_type n, SegmentedBufferIterator it) {
+            return it += n;
+        }
+
+        friend SegmentedBufferIterator operator-(SegmentedBufferIterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const SegmentedBufferIterator& lhs, const SegmentedBufferIterator& rhs) {
+            return static_cast<difference_type>(lhs.position()) - static_cast<difference_type>(rhs.position());
+        }
+
+        friend bool operator==(const SegmentedBufferIterator& lhs, const SegmentedBufferIterator& rhs) {
+            return lhs.position() == rhs.position();
+        }
+
+        friend bool operator!=(const SegmentedBufferIterator& lhs, const SegmentedBufferIterator& rhs) {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator<(const SegmentedBufferIterator& lhs, const SegmentedBufferIterator& rhs) {
+            return lhs.position() < rhs.position();
+        }
+
+        friend bool operator>(const SegmentedBufferIterator& lhs, const SegmentedBufferIterator& rhs) {
+            return rhs < lhs;
+        }
+
+        friend bool operator<=(const SegmentedBufferIterator& lhs, const SegmentedBufferIterator& rhs) {
+            return !(rhs < lhs);
+        }
+
+        friend bool operator>=(const SegmentedBufferIterator& lhs, const SegmentedBufferIterator& rhs) {
+            return !(lhs < rhs);
+        }
+
+    private:
+        friend class InputSegmentedBufferAdapter;
+
+        size_t position() const {
+            return _seg->offset + static_cast<size_t>(_ptr - _seg->data);
+        }
+
+        //position past the end of input is only used to mark an error, same as buffer adapter does
+        void locate(size_t pos) {
+            auto it = std::upper_bound(_table->begin(), _table->end(), pos,
+                                       [](size_t p, const details::SegmentInfo& s) { return p < s.offset; });
+            _seg = std::addressof(*std::prev(it));
+            _ptr = _seg->data + (pos - _seg->offset);
+        }
+
+        const details::SegmentTable* _table{};
+        const details::SegmentInfo* _seg{};
+        const char* _ptr{};
+    };
+
+    /*
+     * reads from a chain of non-contiguous buffers, without copying them to single buffer.
+     * segments can be any type with `data` and `size` members, e.g. BufferSegment or ChunkedBuffer::Segment.
+     */
+    class InputSegmentedBufferAdapter {
+    public:
+        using TValue = char;
+        using TIterator = SegmentedBufferIterator;
+
+        template <typename Segments>
+        explicit InputSegmentedBufferAdapter(const Segments& segments)
+                : InputSegmentedBufferAdapter(std::begin(segments), std::end(segments))
+        {
+        }
+
+        template <typename It>
+        InputSegmentedBufferAdapter(It first, It last)
+                : _table{createTable(first, last)},
+                  posIt{_table.get(), 0},
+                  endIt{_table.get(), _table->back().offset}
+        {
+        }
+
+        void read(TValue* data, size_t size) {
+            //fast path when reading inside single segment
+            auto ptr = posIt._ptr;
+            auto limit = posIt._seg == endIt._seg ? endIt._ptr : posIt._seg->end;
+            if (posIt._seg <= endIt._seg && limit - ptr >= static_cast<std::ptrdiff_t>(size)) {
+                std::memcpy(data, ptr, size);
+                posIt._ptr = ptr + size;
+            } else {
+                readSlow(data, size);
+            }
+        }
+
+        //returns pointer to `size` bytes at current position and moves position past them,
+        //or nullptr if there is not enough data or it is split between segments,
+        //in this case position is not changed and error is not set.
+        const TValue* readBlock(size_t size) {
+            if (posIt._ptr == posIt._seg->end && posIt._seg < endIt._seg) {
+                ++posIt._seg;
+                posIt._ptr = posIt._seg->data;
+            }
+            auto ptr = posIt._ptr;
+            auto limit = posIt._seg == endIt._seg ? endIt._ptr : posIt._seg->end;
+            if (posIt._seg <= endIt._seg && limit - ptr >= static_cast<std::ptrdiff_t>(size)) {
+                posIt._ptr = ptr + size;
+                return ptr;
+            }
+            return nullptr;
+        }
+
+        ReaderError error() const {
+            auto res = std::distance(endIt, posIt);
+            if (res > 0)
+                return static_cast<ReaderError>(res);
+            return ReaderError::NoError;
+        }
+
+        void setError(ReaderError error) {
+            endIt = posIt;
+            //to avoid creating temporary for error state, mark an error by passing posIt after the endIt
+            posIt += static_cast<std::ptrdiff_t>(error);
+        }
+
+        bool isCompletedSuccessfully() const {
+            return posIt == endIt;
+        }
+
+        size_t segmentsCount() const {
+            return _table->size() - 1;
+        }
+
+    private:
+        friend details::SessionAccess;
+
+        template <typename It>
+        static std::unique_ptr<details::SegmentTable> createTable(It first, It last) {
+            std::unique_ptr<details::SegmentTable> res{new details::SegmentTable{}};
+            size_t offset{};
+            const char* end{};
+            for (; first != last; ++first) {
+                const auto& s = *first;
+                if (s.size == 0)
+                    continue;
+                auto data = reinterpret_cast<const char*>(s.data);
+                end = data + s.size;
+                res->push_back(details::SegmentInfo{data, end, offset});
+                offset += s.size;
+            }
+            res->push_back(details::SegmentInfo{end, end, offset});
+            return res;
+        }
+
+        void readSlow(TValue* data, size_t size) {
+            if (std::distance(posIt, endIt) < static_cast<std::ptrdiff_t>(size)) {
+                //set everything to zeros
+                std::memset(data, 0, size);
+                if (error() == ReaderError::NoError)
+                    setError(ReaderError::DataOverflow);
+                return;
+            }
+            while (size > 0) {
+                if (posIt._ptr == posIt._seg->end) {
+                    ++posIt._seg;
+                    posIt._ptr = posIt._seg->data;
+                }
+                auto count = static_cast<size_t>(posIt._seg->end - posIt._ptr);
+                count = count < size ? count : size;
+                std::memcpy(data, posIt._ptr, count);
+                posIt._ptr += count;
+                data += count;
+                size -= count;
+            }
+        }
+
+        std::unique_ptr<details::SegmentTable> _table;
+        TIterator posIt;
+        TIterator endIt;
+    };
+
+}
+
+#endif //BITSERY_ADAPTER_SEGMENTED_BUFFER_H
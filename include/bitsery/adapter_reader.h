@@ -25,7 +25,9 @@
 
 #include "details/sessions.h"
 #include <algorithm>
+#include <cassert>
 #include <cstring>
+#include <limits>
 
 namespace bitsery {
 
@@ -95,22 +97,39 @@ namespace bitsery {
         }
 
         void setError(ReaderError error) {
-            if (this->error() == ReaderError::NoError)
+            if (this->error() == ReaderError::NoError) {
                 _inputAdapter.setError(error);
+                details::ConfigHooks<Config>::onReaderError(error);
+            }
         }
 
         void beginSession() {
             if (error() == ReaderError::NoError) {
                 _session.begin();
+                details::ConfigHooks<Config>::onSessionBegin();
             }
         }
 
         void endSession() {
             if (error() == ReaderError::NoError) {
                 _session.end();
+                details::ConfigHooks<Config>::onSessionEnd();
             }
         }
 
+        //start reading from new input adapter, error state and sessions are cleared
+        void reset(InputAdapter&& adapter) {
+            _inputAdapter = std::move(adapter);
+            _session.reset();
+        }
+
+        //returns pointer to `size` bytes of input adapter memory, or nullptr if there is not enough data.
+        //only available if adapter provides direct access
+        template <typename T = InputAdapter, typename std::enable_if<details::HasReadBlock<T>::value>::type* = nullptr>
+        const void* readBlock(size_t size) {
+            return _inputAdapter.readBlock(size);
+        }
+
     private:
         friend class AdapterReaderBitPackingWrapper<AdapterReader<InputAdapter, Config>>;
 
@@ -123,12 +142,28 @@ namespace bitsery {
         template<typename T>
         void directRead(T *v, size_t count) {
             static_assert(!std::is_const<T>::value, "");
-            _inputAdapter.read(reinterpret_cast<TValue *>(v), sizeof(T) * count);
+            _adapterRead(reinterpret_cast<TValue *>(v), sizeof(T) * count,
+                         std::integral_constant<bool, details::ConfigHooks<Config>::Enabled>{});
             //swap each byte if nessesarry
             _swapDataBits(v, count, std::integral_constant<bool,
                     Config::NetworkEndianness != details::getSystemEndianness()>{});
         }
 
+        //notify hooks, when input adapter gets into error state while reading, e.g. data overflow
+        void _adapterRead(TValue *data, size_t size, std::true_type) {
+            const auto hadError = error() != ReaderError::NoError;
+            _inputAdapter.read(data, size);
+            if (!hadError) {
+                auto err = error();
+                if (err != ReaderError::NoError)
+                    details::ConfigHooks<Config>::onReaderError(err);
+            }
+        }
+
+        void _adapterRead(TValue *data, size_t size, std::false_type) {
+            _inputAdapter.read(data, size);
+        }
+
         template<typename T>
         void _swapDataBits(T *v, size_t count, std::true_type) {
             std::for_each(v, std::next(v, count), [this](T &x) { x = details::swap(x); });
@@ -185,11 +220,7 @@ namespace bitsery {
             if (!m_scratchBits) {
                 _reader.template readBuffer<SIZE,T>(buf, count);
             } else {
-                using UT = typename std::make_unsigned<T>::type;
-                //todo improve implementation
-                const auto end = buf + count;
-                for (auto it = buf; it != end; ++it)
-                    readBits(reinterpret_cast<UT &>(*it), details::BitsSize<T>::value);
+                readBufferUnaligned(buf, count, std::integral_constant<bool, sizeof(T) == sizeof(UnsignedValue)>{});
             }
         }
 
@@ -235,6 +266,28 @@ namespace bitsery {
         ScratchType m_scratch{};
         size_t m_scratchBits{};
 
+        //when buffer value type is the same size as underlying reader type,
+        //read whole buffer at once, and then shift each value through scratch
+        template<typename T>
+        void readBufferUnaligned(T *buf, size_t count, std::true_type) {
+            constexpr size_t valueSize = details::BitsSize<UnsignedValue>::value;
+            _reader.template readBuffer<sizeof(T), T>(buf, count);
+            const auto mask = static_cast<ScratchType>((std::numeric_limits<UnsignedValue>::max)());
+            for (size_t i = 0; i < count; ++i) {
+                m_scratch |= static_cast<ScratchType>(static_cast<UnsignedValue>(buf[i])) << m_scratchBits;
+                buf[i] = static_cast<T>(m_scratch & mask);
+                m_scratch >>= valueSize;
+            }
+        }
+
+        template<typename T>
+        void readBufferUnaligned(T *buf, size_t count, std::false_type) {
+            using UT = typename std::make_unsigned<T>::type;
+            const auto end = buf + count;
+            for (auto it = buf; it != end; ++it)
+                readBits(reinterpret_cast<UT &>(*it), details::BitsSize<T>::value);
+        }
+
         template<typename T>
         void readBitsInternal(T &v, size_t size) {
             auto bitsLeft = size;
@@ -258,6 +311,125 @@ namespace bitsery {
         }
 
     };
+
+    //this class is used as wrapper for real reader, when deserializing fixed size block of N bytes.
+    //whole block is requested once, so underlying adapter performs bounds check only once per block,
+    //and values are read without any checks.
+    //if reader doesn't provide direct memory access or there is not enough data, block is read to local buffer,
+    //and underlying reader handles it as usual (sets error, or returns zeros when session has ended).
+    //temporary buffer is provided by caller and is not a member, same as for AdapterWriterFixedBlockWrapper.
+    template<typename TReader, size_t N>
+    class AdapterReaderFixedBlockWrapper {
+    public:
+        //this is required by deserializer
+        static constexpr bool BitPackingEnabled = false;
+        using TConfig = typename TReader::TConfig;
+        using TValue = uint8_t;
+
+        struct Params {
+            TReader& reader;
+            TValue* buffer;
+        };
+
+        explicit AdapterReaderFixedBlockWrapper(const Params& params)
+                : _reader{params.reader},
+                  _in{static_cast<const TValue*>(getReadBlock(params.reader, details::HasReadBlock<TReader>{}))}
+        {
+            if (_in == nullptr) {
+                _reader.template readBuffer<1, TValue>(params.buffer, N);
+                _in = params.buffer;
+            }
+        }
+
+        AdapterReaderFixedBlockWrapper(const AdapterReaderFixedBlockWrapper&) = delete;
+        AdapterReaderFixedBlockWrapper& operator = (const AdapterReaderFixedBlockWrapper&) = delete;
+
+        AdapterReaderFixedBlockWrapper(AdapterReaderFixedBlockWrapper&& ) = delete;
+        AdapterReaderFixedBlockWrapper& operator = (AdapterReaderFixedBlockWrapper&& ) = delete;
+
+        ~AdapterReaderFixedBlockWrapper() {
+            assert(_pos == N);
+        }
+
+        template<size_t SIZE, typename T>
+        void readBytes(T &v) {
+            static_assert(std::is_integral<T>(), "");
+            static_assert(sizeof(T) == SIZE, "");
+            directRead(&v, 1);
+        }
+
+        template<size_t SIZE, typename T>
+        void readBuffer(T *buf, size_t count) {
+            static_assert(std::is_integral<T>(), "");
+            static_assert(sizeof(T) == SIZE, "");
+            directRead(buf, count);
+        }
+
+        template<typename T>
+        void readBits(T &, size_t ) {
+            static_assert(std::is_void<T>::value,
+                          "Bit-packing is not enabled.\nEnable by call to `enableBitPacking`) or create Deserializer with bit packing enabled.");
+        }
+
+        void align() {
+        }
+
+        bool isCompletedSuccessfully() const {
+            return _reader.isCompletedSuccessfully();
+        }
+
+        ReaderError error() const {
+            return _reader.error();
+        }
+
+        void setError(ReaderError error) {
+            _reader.setError(error);
+        }
+
+        template <typename T=void>
+        void beginSession() {
+            static_assert(!std::is_void<T>::value, "Sessions cannot be used inside fixed size block.");
+        }
+
+        template <typename T=void>
+        void endSession() {
+            static_assert(!std::is_void<T>::value, "Sessions cannot be used inside fixed size block.");
+        }
+
+    private:
+
+        static const void* getReadBlock(TReader& reader, std::true_type) {
+            return reader.readBlock(N);
+        }
+
+        static const void* getReadBlock(TReader& , std::false_type) {
+            return nullptr;
+        }
+
+        template<typename T>
+        void directRead(T *v, size_t count) {
+            static_assert(!std::is_const<T>::value, "");
+            assert(_pos + sizeof(T) * count <= N);
+            std::memcpy(v, _in + _pos, sizeof(T) * count);
+            _pos += sizeof(T) * count;
+            _swapDataBits(v, count, std::integral_constant<bool,
+                    TConfig::NetworkEndianness != details::getSystemEndianness()>{});
+        }
+
+        template<typename T>
+        void _swapDataBits(T *v, size_t count, std::true_type) {
+            std::for_each(v, std::next(v, count), [](T &x) { x = details::swap(x); });
+        }
+
+        template<typename T>
+        void _swapDataBits(T *, size_t , std::false_type) {
+            //empty function because no swap is required
+        }
+
+        TReader& _reader;
+        const TValue* _in;
+        size_t _pos{};
+    };
 }
 
 #endif //BITSERY_ADAPTER_READER_H
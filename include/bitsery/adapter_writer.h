@@ -26,6 +26,8 @@
 #include "details/sessions.h"
 
 #include <cassert>
+#include <cstring>
+#include <limits>
 #include <utility>
 
 namespace bitsery {
@@ -89,6 +91,10 @@ namespace bitsery {
             return _bitsCount / 8;
         }
 
+        size_t writtenBitsCount() const {
+            return _bitsCount;
+        }
+
     private:
         size_t _bitsCount{};
         size_t _sessionsBytesCount{};
@@ -124,7 +130,7 @@ namespace bitsery {
         AdapterWriter &operator=(AdapterWriter &&) = default;
 
         ~AdapterWriter() {
-            flush();
+            flushOutput();
         }
 
         template<size_t SIZE, typename T>
@@ -154,8 +160,8 @@ namespace bitsery {
         }
 
         void flush() {
-            _session.flushSessions(*this);
-            _outputAdapter.flush();
+            flushOutput();
+            details::ConfigHooks<Config>::onFlush(*this);
         }
 
         size_t writtenBytesCount() const {
@@ -164,14 +170,34 @@ namespace bitsery {
 
         void beginSession() {
             _session.begin(*this);
+            details::ConfigHooks<Config>::onSessionBegin();
         }
 
         void endSession() {
             _session.end(*this);
+            details::ConfigHooks<Config>::onSessionEnd();
+        }
+
+        //start writing to new output adapter, unflushed sessions data is discarded, so flush before reset.
+        void reset(OutputAdapter&& adapter) {
+            _outputAdapter = std::move(adapter);
+            _session.clear();
+        }
+
+        //returns pointer to `size` bytes of output adapter memory, only available if adapter provides direct access
+        template <typename T = OutputAdapter, typename std::enable_if<details::HasWriteBlock<T>::value>::type* = nullptr>
+        void* writeBlock(size_t size) {
+            return _outputAdapter.writeBlock(size);
         }
 
     private:
         friend class AdapterWriterBitPackingWrapper<AdapterWriter<OutputAdapter, Config>>;
+
+        void flushOutput() {
+            _session.flushSessions(*this);
+            _outputAdapter.flush();
+        }
+
         template<typename T>
         void directWrite(T &&v, size_t count) {
             _directWriteSwapTag(std::forward<T>(v), count, std::integral_constant<bool,
@@ -246,11 +272,7 @@ namespace bitsery {
             if (!_scratchBits) {
                 _writer.template writeBuffer<SIZE,T>(buf, count);
             } else {
-                using UT = typename std::make_unsigned<T>::type;
-                //todo improve implementation
-                const auto end = buf + count;
-                for (auto it = buf; it != end; ++it)
-                    writeBitsInternal(reinterpret_cast<const UT &>(*it), details::BitsSize<T>::value);
+                writeBufferUnaligned(buf, count, std::integral_constant<bool, sizeof(T) == sizeof(UnsignedType)>{});
             }
         }
 
@@ -289,6 +311,33 @@ namespace bitsery {
 
     private:
 
+        //when buffer value type is the same size as underlying writer type,
+        //shift values into scratch in blocks and write each block with a single call
+        template<typename T>
+        void writeBufferUnaligned(const T *buf, size_t count, std::true_type) {
+            constexpr size_t valueSize = details::BitsSize<UnsignedType>::value;
+            UnsignedType tmp[BufferBlockSize];
+            while (count > 0) {
+                const auto n = (std::min)(count, BufferBlockSize);
+                for (size_t i = 0; i < n; ++i) {
+                    _scratch |= static_cast<ScratchType>(static_cast<UnsignedType>(buf[i])) << _scratchBits;
+                    tmp[i] = static_cast<UnsignedType>(_scratch & _MASK);
+                    _scratch >>= valueSize;
+                }
+                _writer.template writeBuffer<sizeof(UnsignedType), UnsignedType>(tmp, n);
+                buf += n;
+                count -= n;
+            }
+        }
+
+        template<typename T>
+        void writeBufferUnaligned(const T *buf, size_t count, std::false_type) {
+            using UT = typename std::make_unsigned<T>::type;
+            const auto end = buf + count;
+            for (auto it = buf; it != end; ++it)
+                writeBitsInternal(reinterpret_cast<const UT &>(*it), details::BitsSize<T>::value);
+        }
+
         template<typename T>
         void writeBitsInternal(const T &v, size_t size) {
             constexpr size_t valueSize = details::BitsSize<UnsignedType>::value;
@@ -324,12 +373,140 @@ namespace bitsery {
             }
         }
 
+        static constexpr size_t BufferBlockSize = 256;
         const UnsignedType _MASK = (std::numeric_limits<UnsignedType>::max)();
         ScratchType _scratch{};
         size_t _scratchBits{};
         TWriter& _writer;
 
     };
+
+    template<typename TWriter>
+    constexpr size_t AdapterWriterBitPackingWrapper<TWriter>::BufferBlockSize;
+
+    //this class is used as wrapper for real writer, when serializing fixed size block of N bytes.
+    //memory for whole block is requested once, so underlying adapter performs bounds check (and buffer resize) only once per block,
+    //and values are written without any checks.
+    //if writer doesn't provide direct memory access, values are written to temporary buffer and whole block is written on destruction.
+    //temporary buffer is provided by caller and is not a member, so that compiler could prove that writes to it doesn't alias with write position.
+    template<typename TWriter, size_t N>
+    class AdapterWriterFixedBlockWrapper {
+    public:
+        //this is required by serializer
+        static constexpr bool BitPackingEnabled = false;
+        using TConfig = typename TWriter::TConfig;
+        using TValue = uint8_t;
+
+        struct Params {
+            TWriter& writer;
+            TValue* buffer;
+        };
+
+        explicit AdapterWriterFixedBlockWrapper(const Params& params)
+                : _writer{params.writer},
+                  _out{getBlock(params, IsDirect{})}
+        {
+        }
+
+        AdapterWriterFixedBlockWrapper(const AdapterWriterFixedBlockWrapper&) = delete;
+        AdapterWriterFixedBlockWrapper& operator = (const AdapterWriterFixedBlockWrapper&) = delete;
+
+        AdapterWriterFixedBlockWrapper(AdapterWriterFixedBlockWrapper&& ) = delete;
+        AdapterWriterFixedBlockWrapper& operator = (AdapterWriterFixedBlockWrapper&& ) = delete;
+
+        ~AdapterWriterFixedBlockWrapper() {
+            assert(_pos == N);
+            commitBlock(IsDirect{});
+        }
+
+        template<size_t SIZE, typename T>
+        void writeBytes(const T &v) {
+            static_assert(std::is_integral<T>(), "");
+            static_assert(sizeof(T) == SIZE, "");
+            directWrite(&v, 1);
+        }
+
+        template<size_t SIZE, typename T>
+        void writeBuffer(const T *buf, size_t count) {
+            static_assert(std::is_integral<T>(), "");
+            static_assert(sizeof(T) == SIZE, "");
+            directWrite(buf, count);
+        }
+
+        template<typename T>
+        void writeBits(const T &, size_t ) {
+            static_assert(std::is_void<T>::value,
+                          "Bit-packing is not enabled.\nEnable by call to `enableBitPacking`) or create Serializer with bit packing enabled.");
+        }
+
+        void align() {
+
+        }
+
+        size_t writtenBytesCount() const {
+            return _writer.writtenBytesCount() + _pos - (IsDirect::value ? N : 0);
+        }
+
+        template <typename T=void>
+        void flush() {
+            static_assert(!std::is_void<T>::value, "Cannot flush inside fixed size block.");
+        }
+
+        template <typename T=void>
+        void beginSession() {
+            static_assert(!std::is_void<T>::value, "Sessions cannot be used inside fixed size block.");
+        }
+
+        template <typename T=void>
+        void endSession() {
+            static_assert(!std::is_void<T>::value, "Sessions cannot be used inside fixed size block.");
+        }
+
+    private:
+
+        using IsDirect = details::HasWriteBlock<TWriter>;
+
+        static TValue* getBlock(const Params& params, std::true_type) {
+            return static_cast<TValue*>(params.writer.writeBlock(N));
+        }
+
+        static TValue* getBlock(const Params& params, std::false_type) {
+            return params.buffer;
+        }
+
+        void commitBlock(std::true_type) {
+        }
+
+        void commitBlock(std::false_type) {
+            _writer.template writeBuffer<1, TValue>(_out, _pos);
+        }
+
+        template<typename T>
+        void directWrite(const T *v, size_t count) {
+            assert(_pos + sizeof(T) * count <= N);
+            _directWriteSwapTag(v, count, std::integral_constant<bool,
+                    TConfig::NetworkEndianness != details::getSystemEndianness()>{});
+            _pos += sizeof(T) * count;
+        }
+
+        template<typename T>
+        void _directWriteSwapTag(const T *v, size_t count, std::true_type) {
+            auto out = _out + _pos;
+            for (auto it = v; it != v + count; ++it, out += sizeof(T)) {
+                const auto res = details::swap(*it);
+                std::memcpy(out, &res, sizeof(T));
+            }
+        }
+
+        template<typename T>
+        void _directWriteSwapTag(const T *v, size_t count, std::false_type) {
+            std::memcpy(_out + _pos, v, sizeof(T) * count);
+        }
+
+        TWriter& _writer;
+        TValue* _out;
+        size_t _pos{};
+    };
 }
 
 #endif //BITSERY_ADAPTER_WRITER_H
@@ -24,7 +24,9 @@
 #ifndef BITSERY_COMMON_H
 #define BITSERY_COMMON_H
 
+#include <cstddef>
 #include <tuple>
+#include <type_traits>
 
 namespace bitsery {
 
@@ -36,6 +38,50 @@ namespace bitsery {
         BigEndian
     };
 
+    enum class ReaderError;
+
+    //default hooks policy, that does nothing.
+    //to collect metrics, create a type with same static functions and set it as Config::Hooks.
+    struct NoHooks {
+        //hooks that require additional checks in hot paths (e.g. error transitions while reading) are called only when enabled
+        static constexpr bool Enabled = false;
+
+        template<typename T, typename TWriter>
+        static void onSerializeObjectBegin(const TWriter &) {
+        }
+
+        template<typename T, typename TWriter>
+        static void onSerializeObjectEnd(const TWriter &) {
+        }
+
+        template<typename T, typename TReader>
+        static void onDeserializeObjectBegin(const TReader &) {
+        }
+
+        template<typename T, typename TReader>
+        static void onDeserializeObjectEnd(const TReader &) {
+        }
+
+        //called with size of each dynamic container, when serializing and deserializing
+        static void onContainerSize(size_t) {
+        }
+
+        //called once when reader gets into error state
+        static void onReaderError(ReaderError) {
+        }
+
+        //called when writer is flushed
+        template<typename TWriter>
+        static void onFlush(const TWriter &) {
+        }
+
+        static void onSessionBegin() {
+        }
+
+        static void onSessionEnd() {
+        }
+    };
+
     //default configuration for buffer writing/reading operations
     struct DefaultConfig {
         //data will be stored in little endian, independant of host.
@@ -47,8 +93,48 @@ namespace bitsery {
         //contexts must be default constructable.
         //internal context has priority, if external context with the same type exists.
         using InternalContext = std::tuple<>;
+        //compile-time hooks policy, that serializer, deserializer and adapters notifies about serialization events.
+        using Hooks = NoHooks;
+        //when enabled, deserializer only validates data structure, see ValidationConfig.
+        static constexpr bool ValidationOnly = false;
     };
 
+    //turns deserializer into structural validator, that performs the same reads and checks (sizes, maxSize, ranges, sessions)
+    //but doesn't fill containers: dynamic containers are not resized, elements are deserialized into single temporary,
+    //and buffers of fundamental types and text are skipped.
+    //if validation succeeds, data can be deserialized using UnsafeInputBufferAdapter with the same Config.
+    template <typename Config>
+    struct ValidationConfig: public Config {
+        static constexpr bool ValidationOnly = true;
+    };
+
+    namespace details {
+
+        //Hooks and ValidationOnly are optional in config, so configs that doesn't inherit from DefaultConfig still works
+        template <typename Config>
+        struct ConfigHooksHelper {
+            template <typename Q>
+            static typename Q::Hooks tester(Q*);
+            static NoHooks tester(...);
+            using type = decltype(tester(static_cast<Config*>(nullptr)));
+        };
+
+        template <typename Config>
+        using ConfigHooks = typename ConfigHooksHelper<Config>::type;
+
+        template <typename Config>
+        struct ConfigValidationOnlyHelper {
+            template <typename Q>
+            static std::integral_constant<bool, Q::ValidationOnly> tester(Q*);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<Config*>(nullptr)));
+        };
+
+        template <typename Config>
+        using ConfigValidationOnly = typename ConfigValidationOnlyHelper<Config>::type;
+
+    }
+
 }
 
 #endif //BITSERY_COMMON_H
@@ -0,0 +1,213 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_COUNTERS_HOOKS_H
+#define BITSERY_COUNTERS_HOOKS_H
+
+#include "common.h"
+#include "details/adapter_utils.h"
+#include "details/type_name.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bitsery {
+
+    /*
+     * sample hooks policy, that collects production metrics.
+     * each thread increments only its own counters with relaxed atomics, so no locks or contention is on hot path,
+     * mutex is only used once per thread, to register its counters, and when taking snapshot.
+     * set it in config: struct MetricsConfig: DefaultConfig { using Hooks = ThreadCountersHooks; };
+     * bytes by message type are calculated from writtenBytesCount, so it cannot be used with stream adapters.
+     */
+    class ThreadCountersHooks {
+    public:
+        static constexpr bool Enabled = true;
+        //max number of different message types, bytes for other types are added to last slot
+        static constexpr size_t MaxMessageTypes = 64;
+        static constexpr size_t ReaderErrorsCount = static_cast<size_t>(ReaderError::InvalidPointer) + 1;
+
+        struct MessageTypeBytes {
+            std::string name{};
+            uint64_t messages{};
+            uint64_t bytes{};
+        };
+
+        //counters summed from all threads
+        struct Snapshot {
+            uint64_t objectsSerialized{};
+            uint64_t objectsDeserialized{};
+            uint64_t containers{};
+            uint64_t containerElements{};
+            uint64_t flushes{};
+            uint64_t sessions{};
+            uint64_t readerErrors[ReaderErrorsCount]{};
+            //serialized bytes by top-level object (message) type
+            std::vector<MessageTypeBytes> messageTypes{};
+        };
+
+        template<typename T, typename TWriter>
+        static void onSerializeObjectBegin(const TWriter &writer) {
+            auto &c = threadCounters();
+            increment(c.objectsSerialized);
+            if (c.serializeDepth++ == 0)
+                c.messageBegin = writer.writtenBytesCount();
+        }
+
+        template<typename T, typename TWriter>
+        static void onSerializeObjectEnd(const TWriter &writer) {
+            auto &c = threadCounters();
+            if (--c.serializeDepth == 0) {
+                auto &slot = c.messageTypes[messageTypeIndex<T>()];
+                increment(slot.messages);
+                increment(slot.bytes, writer.writtenBytesCount() - c.messageBegin);
+            }
+        }
+
+        template<typename T, typename TReader>
+        static void onDeserializeObjectBegin(const TReader &) {
+            increment(threadCounters().objectsDeserialized);
+        }
+
+        template<typename T, typename TReader>
+        static void onDeserializeObjectEnd(const TReader &) {
+        }
+
+        static void onContainerSize(size_t size) {
+            auto &c = threadCounters();
+            increment(c.containers);
+            increment(c.containerElements, size);
+        }
+
+        static void onReaderError(ReaderError error) {
+            increment(threadCounters().readerErrors[static_cast<size_t>(error)]);
+        }
+
+        template<typename TWriter>
+        static void onFlush(const TWriter &) {
+            increment(threadCounters().flushes);
+        }
+
+        static void onSessionBegin() {
+            increment(threadCounters().sessions);
+        }
+
+        static void onSessionEnd() {
+        }
+
+        static Snapshot snapshot() {
+            Snapshot res{};
+            auto &r = registry();
+            std::lock_guard<std::mutex> lock{r.mutex};
+            const auto registeredTypes = r.nextTypeIndex.load();
+            const size_t typesCount = registeredTypes < MaxMessageTypes ? registeredTypes : MaxMessageTypes;
+            res.messageTypes.resize(typesCount);
+            for (size_t i = 0; i < typesCount; ++i)
+                res.messageTypes[i].name = r.typeNames[i];
+            if (registeredTypes > MaxMessageTypes)
+                res.messageTypes.back().name = "other";
+            for (auto &c:r.threads) {
+                res.objectsSerialized += c->objectsSerialized.load(std::memory_order_relaxed);
+                res.objectsDeserialized += c->objectsDeserialized.load(std::memory_order_relaxed);
+                res.containers += c->containers.load(std::memory_order_relaxed);
+                res.containerElements += c->containerElements.load(std::memory_order_relaxed);
+                res.flushes += c->flushes.load(std::memory_order_relaxed);
+                res.sessions += c->sessions.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < ReaderErrorsCount; ++i)
+                    res.readerErrors[i] += c->readerErrors[i].load(std::memory_order_relaxed);
+                for (size_t i = 0; i < typesCount; ++i) {
+                    res.messageTypes[i].messages += c->messageTypes[i].messages.load(std::memory_order_relaxed);
+                    res.messageTypes[i].bytes += c->messageTypes[i].bytes.load(std::memory_order_relaxed);
+                }
+            }
+            return res;
+        }
+
+    private:
+        struct TypeCounters {
+            std::atomic<uint64_t> messages{};
+            std::atomic<uint64_t> bytes{};
+        };
+
+        struct Counters {
+            std::atomic<uint64_t> objectsSerialized{};
+            std::atomic<uint64_t> objectsDeserialized{};
+            std::atomic<uint64_t> containers{};
+            std::atomic<uint64_t> containerElements{};
+            std::atomic<uint64_t> flushes{};
+            std::atomic<uint64_t> sessions{};
+            std::atomic<uint64_t> readerErrors[ReaderErrorsCount]{};
+            TypeCounters messageTypes[MaxMessageTypes]{};
+            //only accessed by owning thread
+            size_t serializeDepth{};
+            size_t messageBegin{};
+        };
+
+        struct Registry {
+            std::mutex mutex{};
+            //counters are kept after thread exits, so that totals never decrease
+            std::vector<std::shared_ptr<Counters>> threads{};
+            std::atomic<size_t> nextTypeIndex{};
+            std::string typeNames[MaxMessageTypes]{};
+        };
+
+        //only owning thread writes to counters, so load and store is enough instead of read-modify-write
+        static void increment(std::atomic<uint64_t> &counter, uint64_t value = 1u) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        static Registry &registry() {
+            static Registry r{};
+            return r;
+        }
+
+        static Counters &threadCounters() {
+            thread_local std::shared_ptr<Counters> counters = [] {
+                auto res = std::make_shared<Counters>();
+                auto &r = registry();
+                std::lock_guard<std::mutex> lock{r.mutex};
+                r.threads.push_back(res);
+                return res;
+            }();
+            return *counters;
+        }
+
+        template<typename T>
+        static size_t messageTypeIndex() {
+            static const size_t index = [] {
+                auto &r = registry();
+                std::lock_guard<std::mutex> lock{r.mutex};
+                auto res = r.nextTypeIndex.load();
+                if (res < MaxMessageTypes)
+                    r.typeNames[res] = details::profileTypeName<T>();
+                r.nextTypeIndex.store(res + 1);
+                return res < MaxMessageTypes ? res : MaxMessageTypes - 1;
+            }();
+            return index;
+        }
+    };
+
+}
+
+#endif //BITSERY_COUNTERS_HOOKS_H
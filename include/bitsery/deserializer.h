@@ -26,6 +26,8 @@
 
 #include "details/serialization_common.h"
 #include "adapter_reader.h"
+#include <algorithm>
+#include <memory>
 #include <utility>
 
 namespace bitsery {
@@ -39,6 +41,9 @@ namespace bitsery {
         //helper type, that always returns bit-packing enabled type, useful inside serialize function when enabling bitpacking
         using BPEnabledType = BasicDeserializer<typename std::conditional<TAdapterReader::BitPackingEnabled,
                 TAdapterReader, AdapterReaderBitPackingWrapper<TAdapterReader>>::type, TContext>;
+        //helper type, useful inside serialize function when deserializing fixed size block
+        template <size_t N>
+        using FixedBlockType = BasicDeserializer<AdapterReaderFixedBlockWrapper<TAdapterReader, N>, TContext>;
 
         static_assert(details::IsSpecializationOf<typename TReader::TConfig::InternalContext, std::tuple>::value,
                       "Config::InternalContext must be std::tuple");
@@ -59,6 +64,16 @@ namespace bitsery {
         BasicDeserializer(BasicDeserializer&& ) = default;
         BasicDeserializer& operator = (BasicDeserializer&& ) = default;
 
+        /*
+         * reuse deserializer with new adapter (e.g. different buffer), without reconstructing reader and internal contexts.
+         * internal contexts that implements `reset()` are reset.
+         */
+        template <typename ReaderParam>
+        void reset(ReaderParam&& r) {
+            _reader.reset(std::forward<ReaderParam>(r));
+            details::resetContexts(_internalContext);
+        }
+
         /*
          * get serialization context.
          * this is optional, but might be required for some specific deserialization flows.
@@ -83,12 +98,16 @@ namespace bitsery {
 
         template<typename T>
         void object(T &&obj) {
+            Hooks::template onDeserializeObjectBegin<typename std::decay<T>::type>(_reader);
             details::SerializeFunction<BasicDeserializer, T>::invoke(*this, std::forward<T>(obj));
+            Hooks::template onDeserializeObjectEnd<typename std::decay<T>::type>(_reader);
         }
 
         template<typename T, typename Fnc>
         void object(T &&obj, Fnc &&fnc) {
+            Hooks::template onDeserializeObjectBegin<typename std::decay<T>::type>(_reader);
             fnc(std::forward<T>(obj));
+            Hooks::template onDeserializeObjectEnd<typename std::decay<T>::type>(_reader);
         }
 
         /*
@@ -120,6 +139,20 @@ namespace bitsery {
             procEnableBitPacking(std::forward<Fnc>(fnc), std::integral_constant<bool, TAdapterReader::BitPackingEnabled>{});
         }
 
+        /*
+         * fixed size block, N is exact number of bytes that will be read inside a block.
+         * underlying reader checks buffer size once for whole block, instead of checking it for each value.
+         * with GCC/Clang block body is always inlined, so values are read with plain loads even at -O2.
+         */
+        template <size_t N, typename Fnc>
+        void fixedBlock(Fnc&& fnc) {
+            static_assert(N > 0, "");
+            using TBlockReader = AdapterReaderFixedBlockWrapper<TAdapterReader, N>;
+            typename TBlockReader::TValue buf[N];
+            FixedBlockType<N> tmp(typename TBlockReader::Params{_reader, buf}, _context);
+            details::invokeFixedBlock(fnc, tmp);
+        }
+
         /*
          * extension functions
          */
@@ -171,8 +204,7 @@ namespace bitsery {
                           "use text(T&) overload without `maxSize` for static containers");
             size_t length;
             details::readSize(_reader, length, maxSize);
-            traits::ContainerTraits<T>::resize(str, length + (traits::TextTraits<T>::addNUL ? 1u : 0u));
-            procText<VSIZE>(str, length);
+            procDynamicText<VSIZE>(str, length, ValidationOnly{});
         }
 
         template<size_t VSIZE, typename T>
@@ -200,8 +232,8 @@ namespace bitsery {
                           "use container(T&) overload without `maxSize` for static containers");
             size_t size{};
             details::readSize(_reader, size, maxSize);
-            traits::ContainerTraits<T>::resize(obj, size);
-            procContainer(std::begin(obj), std::end(obj), std::forward<Fnc>(fnc));
+            Hooks::onContainerSize(size);
+            procDynamicContainer(obj, size, std::forward<Fnc>(fnc), ValidationOnly{});
         }
 
         template<size_t VSIZE, typename T>
@@ -212,8 +244,8 @@ namespace bitsery {
                           "use container(T&) overload without `maxSize` for static containers");
             size_t size{};
             details::readSize(_reader, size, maxSize);
-            traits::ContainerTraits<T>::resize(obj, size);
-            procContainer<VSIZE>(std::begin(obj), std::end(obj), std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>{});
+            Hooks::onContainerSize(size);
+            procDynamicContainer<VSIZE>(obj, size, ValidationOnly{});
         }
 
         template<typename T>
@@ -224,8 +256,8 @@ namespace bitsery {
                           "use container(T&) overload without `maxSize` for static containers");
             size_t size{};
             details::readSize(_reader, size, maxSize);
-            traits::ContainerTraits<T>::resize(obj, size);
-            procContainer(std::begin(obj), std::end(obj));
+            Hooks::onContainerSize(size);
+            procDynamicContainer(obj, size, ValidationOnly{});
         }
         //fixed size containers
 
@@ -245,7 +277,7 @@ namespace bitsery {
             static_assert(!traits::ContainerTraits<T>::isResizable,
                           "use container(T&, size_t) overload with `maxSize` for dynamic containers");
             static_assert(VSIZE > 0, "");
-            procContainer<VSIZE>(std::begin(obj), std::end(obj), std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>{});
+            procValueContainer<VSIZE>(obj, details::IsSegmentedContainer<T>{});
         }
 
         template<typename T>
@@ -257,6 +289,46 @@ namespace bitsery {
             procContainer(std::begin(obj), std::end(obj));
         }
 
+        /*
+         * consume dynamic container without storing it, so memory usage doesn't depend on container size.
+         * binary format is the same as container(T&, size_t), consuming stops when reader is in error state.
+         */
+
+        //each element is deserialized with fnc into the same temporary, and then passed to consumer(TValue&)
+        template<typename TValue, typename Fnc, typename Consumer>
+        void consumeContainer(size_t maxSize, Fnc &&fnc, Consumer &&consumer) {
+            size_t size{};
+            details::readSize(_reader, size, maxSize);
+            Hooks::onContainerSize(size);
+            TValue tmp{};
+            for (; size > 0; --size) {
+                fnc(tmp);
+                if (_reader.error() != ReaderError::NoError)
+                    break;
+                consumer(tmp);
+            }
+        }
+
+        //fundamental types are read in batches to scratch buffer, and passed to consumer(const TValue* data, size_t count)
+        template<size_t VSIZE, typename TValue, typename Consumer>
+        void consumeContainer(size_t maxSize, Consumer &&consumer) {
+            static_assert(details::IsFundamentalType<TValue>::value, "Value must be integral, float or enum type.");
+            static_assert(sizeof(TValue) == VSIZE, "");
+            size_t size{};
+            details::readSize(_reader, size, maxSize);
+            Hooks::onContainerSize(size);
+            constexpr size_t BatchSize = 4096u / VSIZE;
+            TValue scratch[BatchSize];
+            while (size > 0) {
+                auto count = size < BatchSize ? size : BatchSize;
+                procContainer<VSIZE>(scratch, scratch + count, std::true_type{});
+                if (_reader.error() != ReaderError::NoError)
+                    break;
+                consumer(static_cast<const TValue*>(scratch), count);
+                size -= count;
+            }
+        }
+
         void align() {
             _reader.align();
         }
@@ -335,6 +407,148 @@ namespace bitsery {
         TAdapterReader _reader;
         TContext* _context;
         typename TReader::TConfig::InternalContext _internalContext;
+        using Hooks = details::ConfigHooks<typename TAdapterReader::TConfig>;
+        using ValidationOnly = details::ConfigValidationOnly<typename TAdapterReader::TConfig>;
+
+        //resize dynamic container and deserialize elements
+        template<typename T, typename Fnc>
+        void procDynamicContainer(T &obj, size_t size, Fnc &&fnc, std::false_type) {
+            traits::ContainerTraits<T>::resize(obj, size);
+            procContainer(std::begin(obj), std::end(obj), std::forward<Fnc>(fnc));
+        }
+
+        template<size_t VSIZE, typename T>
+        void procDynamicContainer(T &obj, size_t size, std::false_type) {
+            procDynamicValueContainer<VSIZE>(obj, size, std::integral_constant<bool,
+                    traits::ContainerTraits<T>::isContiguous && details::HasResizeAndOverwrite<T>::value>{});
+        }
+
+        template<size_t VSIZE, typename T>
+        void procDynamicValueContainer(T &obj, size_t size, std::true_type) {
+            traits::ContainerTraits<T>::resizeAndOverwrite(obj, size, [this](
+                    typename traits::ContainerTraits<T>::TValue* data, size_t n) {
+                this->template readOverwritten<VSIZE>(data, n, n);
+            });
+        }
+
+        template<size_t VSIZE, typename T>
+        void procDynamicValueContainer(T &obj, size_t size, std::false_type) {
+            using IsContiguous = std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>;
+            using ForOverwrite = std::integral_constant<bool, IsContiguous::value && details::HasResizeForOverwrite<T>::value>;
+            resizeContainer(obj, size, ForOverwrite{});
+            procValueContainer<VSIZE>(obj, details::IsSegmentedContainer<T>{});
+            clearOnError(obj, ForOverwrite{});
+        }
+
+        template<typename T>
+        void procDynamicContainer(T &obj, size_t size, std::false_type) {
+            traits::ContainerTraits<T>::resize(obj, size);
+            procContainer(std::begin(obj), std::end(obj));
+        }
+
+        template<size_t VSIZE, typename T>
+        void procDynamicText(T &str, size_t length, std::false_type) {
+            procDynamicTextOverwrite<VSIZE>(str, length, std::integral_constant<bool,
+                    traits::ContainerTraits<T>::isContiguous && details::HasResizeAndOverwrite<T>::value>{});
+        }
+
+        //characters are read inside resizeAndOverwrite, so they are never zero-filled first
+        template<size_t VSIZE, typename T>
+        void procDynamicTextOverwrite(T &str, size_t length, std::true_type) {
+            const size_t size = length + (traits::TextTraits<T>::addNUL ? 1u : 0u);
+            traits::ContainerTraits<T>::resizeAndOverwrite(str, size, [this, length](
+                    typename traits::ContainerTraits<T>::TValue* data, size_t n) {
+                this->template readOverwritten<VSIZE>(data, length, n);
+            });
+        }
+
+        template<size_t VSIZE, typename T>
+        void procDynamicTextOverwrite(T &str, size_t length, std::false_type) {
+            using ForOverwrite = std::integral_constant<bool,
+                    traits::ContainerTraits<T>::isContiguous && details::HasResizeForOverwrite<T>::value>;
+            resizeContainer(str, length + (traits::TextTraits<T>::addNUL ? 1u : 0u), ForOverwrite{});
+            procText<VSIZE>(str, length);
+            clearOnError(str, ForOverwrite{});
+        }
+
+        //read `length` elements and fill the rest up to `size`, every element must be written on any outcome
+        template<size_t VSIZE, typename TValue>
+        void readOverwritten(TValue* data, size_t length, size_t size) {
+            procContainer<VSIZE>(data, data + length, std::true_type{});
+            if (_reader.error() != ReaderError::NoError)
+                std::fill(data, data + size, TValue{});
+            else
+                std::fill(data + length, data + size, TValue{});
+        }
+
+        //when whole contiguous buffer is read directly, new elements doesn't need to be initialized
+        template<typename T>
+        void resizeContainer(T &obj, size_t size, std::true_type) {
+            traits::ContainerTraits<T>::resizeForOverwrite(obj, size);
+        }
+
+        template<typename T>
+        void resizeContainer(T &obj, size_t size, std::false_type) {
+            traits::ContainerTraits<T>::resize(obj, size);
+        }
+
+        //not all input adapters fill remaining data on error, so don't leave uninitialized elements
+        template<typename T>
+        void clearOnError(T &obj, std::true_type) {
+            using TValue = typename traits::ContainerTraits<T>::TValue;
+            if (_reader.error() != ReaderError::NoError)
+                std::fill(std::begin(obj), std::end(obj), TValue{});
+        }
+
+        template<typename T>
+        void clearOnError(T &, std::false_type) {
+        }
+
+        //validation only, container is not resized, and each element is deserialized into the same temporary.
+        //stop as soon as reader is in error state, because remaining elements would be read as zeros anyway.
+        template<typename T, typename Fnc>
+        void procDynamicContainer(T &, size_t size, Fnc &&fnc, std::true_type) {
+            typename traits::ContainerTraits<T>::TValue tmp{};
+            for (size_t i = 0; i < size && _reader.error() == ReaderError::NoError; ++i)
+                fnc(tmp);
+        }
+
+        template<size_t VSIZE, typename T>
+        void procDynamicContainer(T &, size_t size, std::true_type) {
+            skipBytes(size * VSIZE);
+        }
+
+        template<typename T>
+        void procDynamicContainer(T &, size_t size, std::true_type) {
+            typename traits::ContainerTraits<T>::TValue tmp{};
+            for (size_t i = 0; i < size && _reader.error() == ReaderError::NoError; ++i)
+                object(tmp);
+        }
+
+        template<size_t VSIZE, typename T>
+        void procDynamicText(T &, size_t length, std::true_type) {
+            skipBytes(length * VSIZE);
+        }
+
+        //reader provides direct access to memory, so bounds check is enough
+        void skipBytes(size_t size) {
+            procSkipBytes(size, details::HasReadBlock<TAdapterReader>{});
+        }
+
+        void procSkipBytes(size_t size, std::true_type) {
+            if (size > 0 && _reader.readBlock(size) == nullptr)
+                procSkipBytes(size, std::false_type{});
+        }
+
+        //read bytes in chunks, so that underlying reader sets error, or handles sessions as usual
+        void procSkipBytes(size_t size, std::false_type) {
+            uint8_t tmp[256];
+            while (size > 0 && _reader.error() == ReaderError::NoError) {
+                const auto n = size < sizeof(tmp) ? size : sizeof(tmp);
+                _reader.template readBuffer<1, uint8_t>(tmp, n);
+                size -= n;
+            }
+        }
 
 
         //process value types
@@ -355,6 +569,20 @@ namespace bitsery {
                 _reader.template readBuffer<VSIZE>(reinterpret_cast<TIntegral*>(&(*first)), std::distance(first, last));
         }
 
+        template<size_t VSIZE, typename T>
+        void procValueContainer(T& obj, std::false_type) {
+            procContainer<VSIZE>(std::begin(obj), std::end(obj), std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>{});
+        }
+
+        //read each contiguous segment as whole buffer
+        template<size_t VSIZE, typename T>
+        void procValueContainer(T& obj, std::true_type) {
+            using TValue = typename traits::ContainerTraits<T>::TValue;
+            traits::ContainerTraits<T>::forEachSegment(obj, [this](TValue* data, size_t size) {
+                this->template procContainer<VSIZE>(data, data + size, std::true_type{});
+            });
+        }
+
         //process by calling functions
         template<typename It, typename Fnc>
         void procContainer(It first, It last, Fnc fnc) {
@@ -438,6 +666,37 @@ namespace bitsery {
         return {r.error(), r.isCompletedSuccessfully()};
     }
 
+    //same as quickDeserialization, but reuses per-thread deserializer, so that reader and internal contexts are not reconstructed for each call.
+    //only adapters that provides direct memory access (e.g. InputBufferAdapter) are supported.
+    template <typename Adapter, typename T>
+    std::pair<ReaderError, bool> cachedDeserialization(Adapter adapter, T& value) {
+        static_assert(details::HasReadBlock<Adapter>::value,
+                      "cachedDeserialization only supports adapters with direct memory access, e.g. InputBufferAdapter");
+        static thread_local std::unique_ptr<Deserializer<Adapter>> cache{};
+        if (cache)
+            cache->reset(std::move(adapter));
+        else
+            cache.reset(new Deserializer<Adapter>{std::move(adapter)});
+        auto& des = *cache;
+        des.object(value);
+        auto& r = AdapterAccess::getReader(des);
+        return {r.error(), r.isCompletedSuccessfully()};
+    }
+
+    //helper type, that only validates data structure
+    template <typename Adapter>
+    using Validator = BasicDeserializer<AdapterReader<Adapter, ValidationConfig<DefaultConfig>>>;
+
+    //helper function that validates data, using `value` as scratch object, and returns status.
+    //when data is valid, it can be deserialized using UnsafeInputBufferAdapter.
+    template <typename Adapter, typename T>
+    std::pair<ReaderError, bool> quickValidation(Adapter adapter, T& value) {
+        Validator<Adapter> des{std::move(adapter)};
+        des.object(value);
+        auto& r = AdapterAccess::getReader(des);
+        return {r.error(), r.isCompletedSuccessfully()};
+    }
+
 }
 
 #endif //BITSERY_DESERIALIZER_H
@@ -106,6 +106,32 @@ namespace bitsery {
             using type = uint16_t;
         };
 
+        /*
+         * detects if adapter (or adapter writer/reader) provides direct access to contiguous memory block,
+         * this is used by fixed size blocks, to perform bounds check once per block.
+         */
+        template <typename T>
+        struct HasWriteBlockHelper {
+            template <typename Q, typename = decltype(std::declval<Q&>().writeBlock(std::declval<size_t>()))>
+            static std::true_type tester(Q*);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<T*>(nullptr)));
+        };
+
+        template <typename T>
+        struct HasWriteBlock: HasWriteBlockHelper<T>::type {};
+
+        template <typename T>
+        struct HasReadBlockHelper {
+            template <typename Q, typename = decltype(std::declval<Q&>().readBlock(std::declval<size_t>()))>
+            static std::true_type tester(Q*);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<T*>(nullptr)));
+        };
+
+        template <typename T>
+        struct HasReadBlock: HasReadBlockHelper<T>::type {};
+
         /*
          * class used by session reader, to access underlying iterators of buffer
          */
@@ -29,6 +29,13 @@
 #include "adapter_utils.h"
 #include "../traits/core/traits.h"
 
+//inline everything called from fixed size block body, so that block position can stay in register
+//between values instead of being reloaded after each write, body size is bounded by block size
+#if defined(__GNUC__)
+#define BITSERY_FIXED_BLOCK_FLATTEN __attribute__((flatten))
+#else
+#define BITSERY_FIXED_BLOCK_FLATTEN
+#endif
 
 namespace bitsery {
 
@@ -74,6 +81,11 @@ namespace bitsery {
 
     namespace details {
 
+        template<typename Fnc, typename TBlock>
+        BITSERY_FIXED_BLOCK_FLATTEN void invokeFixedBlock(Fnc &fnc, TBlock &block) {
+            fnc(block);
+        }
+
         //helper types for error handling
         template<typename T>
         struct IsContainerTraitsDefined : public IsDefined<typename traits::ContainerTraits<T>::TValue> {
@@ -87,6 +99,103 @@ namespace bitsery {
         struct IsExtensionTraitsDefined : public IsDefined<typename traits::ExtensionTraits<Ext, T>::TValue> {
         };
 
+        //container traits might optionally define `resizeForOverwrite`, see traits::ContainerTraits
+        template <typename T>
+        struct HasResizeForOverwriteHelper {
+            template <typename Q, typename = decltype(traits::ContainerTraits<Q>::resizeForOverwrite(std::declval<Q&>(), size_t{}))>
+            static std::true_type tester(Q*);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<T*>(nullptr)));
+        };
+
+        template <typename T>
+        struct HasResizeForOverwrite: HasResizeForOverwriteHelper<T>::type {};
+
+        //container traits might optionally define `forEachSegment`, see traits::ContainerTraits
+        struct SegmentFncArchetype {
+            template <typename TValue>
+            void operator()(TValue*, size_t) const {}
+        };
+
+        //container traits might optionally define `resizeAndOverwrite`, see traits::ContainerTraits
+        template <typename T>
+        struct HasResizeAndOverwriteHelper {
+            template <typename Q, typename = decltype(traits::ContainerTraits<Q>::resizeAndOverwrite(
+                    std::declval<Q&>(), size_t{}, std::declval<SegmentFncArchetype>()))>
+            static std::true_type tester(Q*);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<T*>(nullptr)));
+        };
+
+        template <typename T>
+        struct HasResizeAndOverwrite: HasResizeAndOverwriteHelper<T>::type {};
+
+        template <typename T>
+        struct HasForEachSegmentHelper {
+            template <typename Q, typename = decltype(traits::ContainerTraits<Q>::forEachSegment(
+                    std::declval<Q&>(), std::declval<SegmentFncArchetype>()))>
+            static std::true_type tester(Q*);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<T*>(nullptr)));
+        };
+
+        //segments are only used, when container is not contiguous
+        template <typename T>
+        struct IsSegmentedContainer: std::integral_constant<bool,
+                !traits::ContainerTraits<T>::isContiguous && HasForEachSegmentHelper<T>::type::value> {};
+
+        //kind of serializer call, that profiling writer attributes written bits to
+        enum class ProfileScopeKind {
+            Object,
+            Value,
+            Container,
+            Text,
+            Ext
+        };
+
+        //writer receives scope notifications from serializer, only if it defines `static constexpr bool ProfilingEnabled = true`
+        template<typename TWriter>
+        struct IsProfilingWriterHelper {
+            template<typename Q, typename = typename std::enable_if<Q::ProfilingEnabled>::type>
+            static std::true_type tester(Q *);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<TWriter *>(nullptr)));
+        };
+
+        template<typename TWriter>
+        struct IsProfilingWriter : IsProfilingWriterHelper<TWriter>::type {
+        };
+
+        template<ProfileScopeKind Kind, typename T>
+        struct ProfileScopeTag {
+        };
+
+        //empty scope for regular writers, compiler removes it completely
+        template<typename TWriter, bool Enabled = IsProfilingWriter<TWriter>::value>
+        struct ProfileScope {
+            template<ProfileScopeKind Kind, typename T>
+            ProfileScope(TWriter &, ProfileScopeTag<Kind, T>) {
+            }
+        };
+
+        template<typename TWriter>
+        struct ProfileScope<TWriter, true> {
+            template<ProfileScopeKind Kind, typename T>
+            ProfileScope(TWriter &writer, ProfileScopeTag<Kind, T>) : _writer{writer} {
+                _writer.template beginScope<Kind, T>();
+            }
+
+            ProfileScope(const ProfileScope &) = delete;
+            ProfileScope &operator=(const ProfileScope &) = delete;
+
+            ~ProfileScope() {
+                _writer.endScope();
+            }
+
+        private:
+            TWriter &_writer;
+        };
+
 #ifdef _MSC_VER
         //helper types for HasSerializeFunction
         template <typename S, typename T>
@@ -394,6 +503,48 @@ namespace bitsery {
             return chooseInternalOrExternalContextIfExists<TCast>(ctx, internalCtx, HasContext<TCast, TInternalContext>{});
         }
 
+        /*
+         * reset internal contexts, when serializer/deserializer is reused.
+         * only contexts that has per-message state implements `reset()` (it should keep allocated memory),
+         * other contexts (e.g. registered polymorphic classes) are left untouched.
+         */
+
+        template <typename T>
+        struct HasResetMethodHelper {
+            template <typename Q, typename = decltype(std::declval<Q&>().reset())>
+            static std::true_type tester(Q*);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<T*>(nullptr)));
+        };
+
+        template <typename T>
+        struct HasResetMethod: HasResetMethodHelper<T>::type {};
+
+        template <typename T>
+        void resetContext(T& ctx, std::true_type) {
+            ctx.reset();
+        }
+
+        template <typename T>
+        void resetContext(T&, std::false_type) {
+        }
+
+        template <size_t I, typename ... Args>
+        void resetContexts(std::tuple<Args...>&, std::integral_constant<bool, false>) {
+        }
+
+        template <size_t I, typename ... Args>
+        void resetContexts(std::tuple<Args...>& ctx, std::integral_constant<bool, true>) {
+            using TCtx = typename std::tuple_element<I, std::tuple<Args...>>::type;
+            resetContext(std::get<I>(ctx), HasResetMethod<TCtx>{});
+            resetContexts<I + 1>(ctx, std::integral_constant<bool, (I + 1 < sizeof...(Args))>{});
+        }
+
+        template <typename ... Args>
+        void resetContexts(std::tuple<Args...>& ctx) {
+            resetContexts<0>(ctx, std::integral_constant<bool, (0 < sizeof...(Args))>{});
+        }
+
     }
 }
 
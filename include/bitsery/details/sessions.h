@@ -23,9 +23,8 @@
 #ifndef BITSERY_DETAILS_SESSIONS_H
 #define BITSERY_DETAILS_SESSIONS_H
 
-#include <vector>
-#include <stack>
 #include "adapter_common.h"
+#include "small_vector.h"
 
 namespace bitsery {
 
@@ -43,6 +42,9 @@ namespace bitsery {
             }
             void flushSessions(TWriter& ) {
             }
+
+            void clear() {
+            }
         };
 
         template <typename TReader>
@@ -62,11 +64,15 @@ namespace bitsery {
             bool hasActiveSessions() const {
                 return false;
             }
+
+            void reset() {
+            }
         };
 
         /*
          * writer/reader real implementations
-         * sessions reading requires to have random access iterators, so it cannot be used with streams
+         * sessions reading requires to have random access iterators, so it cannot be used with streams.
+         * sessions are stored in small vectors, so that common cases doesn't allocate
          */
         template <typename TWriter>
         class SessionsWriter {
@@ -81,18 +87,18 @@ namespace bitsery {
 
             void begin(TWriter& ) {
                 //write position
-                _sessionIndex.push(_sessions.size());
-                _sessions.emplace_back(0);
+                _sessionIndex.push_back(_sessions.size());
+                _sessions.push_back(0);
             }
 
             void end(TWriter& writer) {
                 assert(!_sessionIndex.empty());
                 //change position to session end
-                auto sessionIt = std::next(std::begin(_sessions), _sessionIndex.top());
-                _sessionIndex.pop();
+                auto &session = _sessions[_sessionIndex.back()];
+                _sessionIndex.pop_back();
                 auto sessionSize = writer.writtenBytesCount();
                 assert(sessionSize > 0);
-                *sessionIt = sessionSize;
+                session = sessionSize;
             }
 
             void flushSessions(TWriter& writer) {
@@ -110,9 +116,15 @@ namespace bitsery {
                     writer.template writeBytes<4>(static_cast<uint32_t>(sessionsOffset));
                 }
             }
+
+            //discard unflushed sessions, allocated memory is kept
+            void clear() {
+                _sessions.clear();
+                _sessionIndex.clear();
+            }
         private:
-            std::vector<size_t> _sessions{};
-            std::stack<size_t> _sessionIndex{};
+            details::SmallVector<size_t, 16> _sessions{};
+            details::SmallVector<size_t, 8> _sessionIndex{};
         };
 
         template <typename TReader>
@@ -141,11 +153,11 @@ namespace bitsery {
                 }
 
                 //save end position for current session
-                _sessionsStack.push(_endItRef);
-                if (_nextSessionIt != std::end(_sessions)) {
+                _sessionsStack.push_back(_endItRef);
+                if (_nextSessionIndex < _sessions.size()) {
                     if (std::distance(_posItRef, _endItRef) > 0) {
                         //set end position for new session
-                        auto newEnd = std::next(_beginIt, *_nextSessionIt);
+                        auto newEnd = std::next(_beginIt, _sessions[_nextSessionIndex]);
                         if (std::distance(newEnd, _endItRef) < 0)
                         {
                             //new session cannot end further than current end
@@ -153,7 +165,7 @@ namespace bitsery {
                             return;
                         }
                         _endItRef = newEnd;
-                        ++_nextSessionIt;
+                        ++_nextSessionIndex;
                     }
                     //if we reached the end, means that there is no more data to read, hence there is no more sessions to advance to
                 } else {
@@ -176,8 +188,8 @@ namespace bitsery {
                     if (dist > 0) {
                         //newer version might have some inner sessions, try to find the one after current ends
                         auto currPos = static_cast<size_t>(std::distance(_beginIt, _endItRef));
-                        for (; _nextSessionIt != std::end(_sessions); ++_nextSessionIt) {
-                            if (*_nextSessionIt > currPos)
+                        for (; _nextSessionIndex < _sessions.size(); ++_nextSessionIndex) {
+                            if (_sessions[_nextSessionIndex] > currPos)
                                 break;
                         }
                     }
@@ -185,9 +197,9 @@ namespace bitsery {
                     if (_reader.error() == ReaderError::NoError || _reader.error() == ReaderError::DataOverflow) {
                         _posItRef = _endItRef;
                         //restore end position
-                        _endItRef = _sessionsStack.top();
+                        _endItRef = _sessionsStack.back();
                     }
-                    _sessionsStack.pop();
+                    _sessionsStack.pop_back();
                 }
             }
 
@@ -195,14 +207,22 @@ namespace bitsery {
                 return _sessionsStack.size() > 0;
             }
 
+            //called when reader is reset with new input adapter, allocated memory is kept
+            void reset() {
+                _beginIt = _posItRef;
+                _sessions.clear();
+                _nextSessionIndex = 0;
+                _sessionsStack.clear();
+            }
+
         private:
             TReader& _reader;
             TIterator _beginIt;
             TIterator& _posItRef;
             TIterator& _endItRef;
-            std::vector<size_t> _sessions{};
-            std::vector<size_t>::iterator _nextSessionIt{};
-            std::stack<TIterator> _sessionsStack{};
+            details::SmallVector<size_t, 16> _sessions{};
+            size_t _nextSessionIndex{};
+            details::SmallVector<TIterator, 8> _sessionsStack{};
 
             bool initializeSessions() {
                 //save current position
@@ -222,20 +242,17 @@ namespace bitsery {
                     _reader.setError(ReaderError::InvalidData);
                     return false;
                 }
-                //we can initialy resizes to this value, and we'll shrink it after reading
                 //read session sizes
-                auto sessionsIt = std::back_inserter(_sessions);
                 _posItRef = std::next(_endItRef, -static_cast<int32_t>(sessionsOffset));
                 while (std::distance(_posItRef, endSessionsSizesIt) > 0) {
                     size_t size;
                     details::readSize(_reader, size, bufferSize);
-                    *sessionsIt++ = size;
+                    _sessions.push_back(size);
                 }
-                _sessions.shrink_to_fit();
                 //set iterators to data
                 _posItRef = currPos;
                 _endItRef = std::next(_endItRef, -static_cast<int32_t>(sessionsOffset));
-                _nextSessionIt = std::begin(_sessions);//set before first session;
+                _nextSessionIndex = 0;//set before first session;
                 return true;
             }
         };
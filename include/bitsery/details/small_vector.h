@@ -0,0 +1,136 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_DETAILS_SMALL_VECTOR_H
+#define BITSERY_DETAILS_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace bitsery {
+
+    namespace details {
+
+        /*
+         * vector that stores first N elements inline, and only allocates when size exceeds N.
+         * heap storage starts with capacity 2*N and doubles, it keeps its capacity after clear,
+         * so it doesn't allocate again after warm-up.
+         * used for internal state of sessions and contexts, so only has operations that they require.
+         * T must be default constructible and copyable.
+         */
+        template<typename T, size_t N>
+        class SmallVector {
+        public:
+            static_assert(N > 0, "");
+
+            void push_back(const T &v) {
+                if (_size < N) {
+                    _inline[_size] = v;
+                } else {
+                    if (_size == N) {
+                        _heap.reserve(2 * N);
+                        _heap.assign(_inline, _inline + N);
+                    } else if (_heap.size() == _heap.capacity()) {
+                        //grow explicitly, so number of allocations doesn't depend on standard library
+                        _heap.reserve(2 * _heap.capacity());
+                    }
+                    _heap.push_back(v);
+                }
+                ++_size;
+            }
+
+            void pop_back() {
+                assert(_size > 0);
+                --_size;
+                if (_size >= N) {
+                    _heap.pop_back();
+                    //move back to inline storage
+                    if (_size == N) {
+                        std::copy(_heap.begin(), _heap.end(), _inline);
+                        _heap.clear();
+                    }
+                }
+            }
+
+            void clear() {
+                _heap.clear();
+                _size = 0;
+            }
+
+            T *data() {
+                return _size > N ? _heap.data() : _inline;
+            }
+
+            const T *data() const {
+                return _size > N ? _heap.data() : _inline;
+            }
+
+            T *begin() {
+                return data();
+            }
+
+            T *end() {
+                return data() + _size;
+            }
+
+            const T *begin() const {
+                return data();
+            }
+
+            const T *end() const {
+                return data() + _size;
+            }
+
+            T &operator[](size_t index) {
+                return data()[index];
+            }
+
+            const T &operator[](size_t index) const {
+                return data()[index];
+            }
+
+            T &back() {
+                assert(_size > 0);
+                return data()[_size - 1];
+            }
+
+            size_t size() const {
+                return _size;
+            }
+
+            bool empty() const {
+                return _size == 0;
+            }
+
+        private:
+            T _inline[N]{};
+            std::vector<T> _heap{};
+            size_t _size{};
+        };
+
+    }
+
+}
+
+#endif //BITSERY_DETAILS_SMALL_VECTOR_H
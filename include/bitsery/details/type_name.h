@@ -0,0 +1,57 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_DETAILS_TYPE_NAME_H
+#define BITSERY_DETAILS_TYPE_NAME_H
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace bitsery {
+
+    namespace details {
+
+        //readable type name for reports, demangled when compiler supports it
+        template<typename T>
+        std::string profileTypeName() {
+            const char *name = typeid(T).name();
+#ifdef __GNUG__
+            int status{};
+            std::unique_ptr<char, void (*)(void *)> demangled{abi::__cxa_demangle(name, nullptr, nullptr, &status),
+                                                              std::free};
+            if (status == 0)
+                return demangled.get();
+#endif
+            return name;
+        }
+
+    }
+
+}
+
+#endif //BITSERY_DETAILS_TYPE_NAME_H
@@ -24,6 +24,9 @@
 #define BITSERY_EXT_ENTROPY_H
 
 #include "value_range.h"
+#include <functional>
+#include <iterator>
+#include <vector>
 
 namespace bitsery {
 
@@ -38,6 +41,101 @@ namespace bitsery {
             }
             return 0u;
         }
+
+        //hash used by entropy index, enums are hashed by underlying type, because std::hash for enums is only since c++14
+        template<typename T, typename Enable = void>
+        struct EntropyHash {
+            size_t operator()(const T &v) const {
+                return std::hash<T>{}(v);
+            }
+        };
+
+        template<typename T>
+        struct EntropyHash<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+            size_t operator()(const T &v) const {
+                using TUnderlying = typename std::underlying_type<T>::type;
+                return std::hash<TUnderlying>{}(static_cast<TUnderlying>(v));
+            }
+        };
+
+        template<typename T>
+        struct HasStdHashHelper {
+            template<typename Q, typename = decltype(std::hash<Q>{}(std::declval<const Q &>()))>
+            static std::true_type tester(Q *);
+            static std::false_type tester(...);
+            using type = decltype(tester(static_cast<T *>(nullptr)));
+        };
+
+        template<typename T>
+        struct HasEntropyHash : std::integral_constant<bool,
+                std::is_enum<T>::value || HasStdHashHelper<T>::type::value> {
+        };
+
+        /*
+         * open addressing hash table, that maps value to entropy index.
+         * it owns a copy of values, so it doesn't depend on lifetime of original container.
+         */
+        template<typename T>
+        class EntropyHashIndex {
+        public:
+            EntropyHashIndex() = default;
+
+            template<typename TContainer>
+            explicit EntropyHashIndex(const TContainer &values) {
+                build(values);
+            }
+
+            template<typename TContainer>
+            void build(const TContainer &values) {
+                _values.assign(std::begin(values), std::end(values));
+                _shift = 64;
+                size_t capacity{1};
+                //keep load factor below 0.5
+                for (; capacity < _values.size() * 2; capacity <<= 1)
+                    --_shift;
+                _slots.assign(capacity, 0u);
+                for (size_t index = 1; index <= _values.size(); ++index) {
+                    const auto &v = _values[index - 1];
+                    auto pos = slotPos(v);
+                    for (; _slots[pos]; pos = (pos + 1) & (capacity - 1)) {
+                        //same value already exists, keep first occurrence, same as linear search
+                        if (_values[_slots[pos] - 1] == v)
+                            break;
+                    }
+                    if (!_slots[pos])
+                        _slots[pos] = index;
+                }
+            }
+
+            bool empty() const {
+                return _slots.empty();
+            }
+
+            const std::vector<T> &values() const {
+                return _values;
+            }
+
+            size_t find(const T &v) const {
+                const auto mask = _slots.size() - 1;
+                for (auto pos = slotPos(v); _slots[pos]; pos = (pos + 1) & mask) {
+                    if (_values[_slots[pos] - 1] == v)
+                        return _slots[pos];
+                }
+                return 0u;
+            }
+
+        private:
+            size_t slotPos(const T &v) const {
+                //fibonacci hashing, to distribute poor hashes e.g. std::hash for integers is identity function
+                const auto h = static_cast<uint64_t>(EntropyHash<T>{}(v)) * 0x9E3779B97F4A7C15ull;
+                return _shift < 64 ? static_cast<size_t>(h >> _shift) : 0u;
+            }
+
+            std::vector<T> _values{};
+            //entropy index of value, 0 means empty slot
+            std::vector<size_t> _slots{};
+            size_t _shift{64};
+        };
     }
 
     namespace ext {
@@ -58,9 +156,9 @@ namespace bitsery {
 
             template<typename Ser, typename Writer, typename T, typename Fnc>
             void serialize(Ser &s, Writer &, const T &obj, Fnc &&fnc) const {
-                assert(traits::ContainerTraits<TContainer>::size(_values) > 0);
+                assert(traits::ContainerTraits<TContainerType>::size(_values) > 0);
                 auto index = details::findEntropyIndex(obj, _values);
-                s.ext(index, ext::ValueRange<size_t>{0u, traits::ContainerTraits<TContainer>::size(_values)});
+                s.ext(index, ext::ValueRange<size_t>{0u, traits::ContainerTraits<TContainerType>::size(_values)});
                 if (_alignBeforeData)
                     s.align();
                 if (!index)
@@ -69,9 +167,9 @@ namespace bitsery {
 
             template<typename Des, typename Reader, typename T, typename Fnc>
             void deserialize(Des &d, Reader &, T &obj, Fnc &&fnc) const {
-                assert(traits::ContainerTraits<TContainer>::size(_values) > 0);
+                assert(traits::ContainerTraits<TContainerType>::size(_values) > 0);
                 size_t index{};
-                d.ext(index, ext::ValueRange<size_t>{0u, traits::ContainerTraits<TContainer>::size(_values)});
+                d.ext(index, ext::ValueRange<size_t>{0u, traits::ContainerTraits<TContainerType>::size(_values)});
                 if (_alignBeforeData)
                     d.align();
                 if (index)
@@ -81,9 +179,80 @@ namespace bitsery {
             }
 
         private:
+            using TContainerType = typename std::remove_const<TContainer>::type;
+
             TContainer& _values;
             bool _alignBeforeData;
         };
+
+        /*
+         * same encoding as Entropy, but looks up values through hash index instead of linear search.
+         * values are copied and indexed once in constructor, so create it once for large tables and reuse it,
+         * it is immutable, so same instance can be used from multiple threads.
+         */
+        template<typename TValue>
+        class EntropyIndexed {
+        public:
+            static_assert(details::HasEntropyHash<TValue>::value,
+                          "EntropyIndexed requires std::hash for value type, use Entropy instead");
+
+            /**
+             * @param values list of most common values
+             * @param alignBeforeData only makes sense when bit-packing enabled, by default aligns after writing bits for index
+             */
+            template<typename TContainer>
+            explicit EntropyIndexed(const TContainer& values, bool alignBeforeData=true)
+                    : _index{values},
+                      _alignBeforeData{alignBeforeData} {
+            }
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &s, Writer &, const T &obj, Fnc &&fnc) const {
+                assert(!_index.values().empty());
+                auto index = findIndex(obj, std::is_same<T, TValue>{});
+                s.ext(index, ext::ValueRange<size_t>{0u, _index.values().size()});
+                if (_alignBeforeData)
+                    s.align();
+                if (!index)
+                    fnc(const_cast<T &>(obj));
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &d, Reader &, T &obj, Fnc &&fnc) const {
+                assert(!_index.values().empty());
+                size_t index{};
+                d.ext(index, ext::ValueRange<size_t>{0u, _index.values().size()});
+                if (_alignBeforeData)
+                    d.align();
+                if (index)
+                    obj = _index.values()[index-1];
+                else
+                    fnc(obj);
+            }
+
+        private:
+            template<typename T>
+            size_t findIndex(const T &v, std::true_type) const {
+                return _index.find(v);
+            }
+
+            //type is different from table type, fallback to linear search
+            template<typename T>
+            size_t findIndex(const T &v, std::false_type) const {
+                return details::findEntropyIndex(v, _index.values());
+            }
+
+            details::EntropyHashIndex<TValue> _index;
+            bool _alignBeforeData;
+        };
+
+        //helper function to deduce value type from container
+        template<typename TContainer>
+        EntropyIndexed<typename std::remove_const<typename traits::ContainerTraits<TContainer>::TValue>::type>
+        makeEntropyIndexed(const TContainer& values, bool alignBeforeData=true) {
+            return EntropyIndexed<typename std::remove_const<typename traits::ContainerTraits<TContainer>::TValue>::type>(
+                    values, alignBeforeData);
+        }
     }
 
     namespace traits {
@@ -94,6 +263,14 @@ namespace bitsery {
             static constexpr bool SupportObjectOverload = true;
             static constexpr bool SupportLambdaOverload = true;
         };
+
+        template<typename TIndexValue, typename T>
+        struct ExtensionTraits<ext::EntropyIndexed<TIndexValue>, T> {
+            using TValue = T;
+            static constexpr bool SupportValueOverload = true;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = true;
+        };
     }
 
 }
@@ -0,0 +1,111 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_FLAT_MAP_H
+#define BITSERY_EXT_FLAT_MAP_H
+
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include "../traits/core/traits.h"
+#include "../details/adapter_utils.h"
+
+namespace bitsery {
+    namespace ext {
+
+        /*
+         * flat map is resizable container (e.g. std::vector<std::pair<K, V>>) sorted by unique keys.
+         * it has the same binary format as StdMap, but deserializes elements in place, without allocating node for each entry.
+         * instead of sorting or inserting each element, keys order is verified in one linear pass,
+         * if keys are not strictly increasing (using Compare) then ReaderError::InvalidData is set.
+         */
+        template <typename Compare = void>
+        class BasicFlatMap {
+        public:
+
+            constexpr explicit BasicFlatMap(size_t maxSize):_maxSize{maxSize} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&fnc) const {
+                using TElem = typename traits::ContainerTraits<T>::TValue;
+                using TKey = typename TElem::first_type;
+                using TValue = typename TElem::second_type;
+                auto size = traits::ContainerTraits<T>::size(obj);
+                assert(size <= _maxSize);
+                assert(isSorted(obj));
+                details::writeSize(writer, size);
+
+                for (auto &v:obj)
+                    fnc(const_cast<TKey &>(v.first), const_cast<TValue &>(v.second));
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&fnc) const {
+                static_assert(traits::ContainerTraits<T>::isResizable, "flat map must be resizable container");
+                size_t size{};
+                details::readSize(reader, size, _maxSize);
+                //existing elements are reused
+                traits::ContainerTraits<T>::resize(obj, size);
+
+                for (auto &v:obj)
+                    fnc(v.first, v.second);
+                if (reader.error() == ReaderError::NoError && !isSorted(obj))
+                    reader.setError(ReaderError::InvalidData);
+            }
+        private:
+
+            template <typename T>
+            bool isSorted(const T& obj) const {
+                using TKey = typename traits::ContainerTraits<T>::TValue::first_type;
+                using TCompare = typename std::conditional<std::is_void<Compare>::value, std::less<TKey>, Compare>::type;
+                TCompare cmp{};
+                auto first = std::begin(obj);
+                auto last = std::end(obj);
+                if (first == last)
+                    return true;
+                for (auto next = std::next(first); next != last; ++first, ++next) {
+                    if (!cmp(first->first, next->first))
+                        return false;
+                }
+                return true;
+            }
+
+            size_t _maxSize;
+        };
+
+        using FlatMap = BasicFlatMap<>;
+    }
+
+    namespace traits {
+        template<typename Compare, typename T>
+        struct ExtensionTraits<ext::BasicFlatMap<Compare>, T> {
+            using TValue = void;
+            static constexpr bool SupportValueOverload = false;
+            static constexpr bool SupportObjectOverload = false;
+            static constexpr bool SupportLambdaOverload = true;
+        };
+    }
+
+}
+
+
+#endif //BITSERY_EXT_FLAT_MAP_H
@@ -0,0 +1,108 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_FLAT_SET_H
+#define BITSERY_EXT_FLAT_SET_H
+
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include "../traits/core/traits.h"
+#include "../details/adapter_utils.h"
+
+namespace bitsery {
+    namespace ext {
+
+        /*
+         * flat set is resizable container (e.g. std::vector<K>) sorted by unique keys.
+         * it has the same binary format as StdSet, but deserializes elements in place,
+         * and verifies order in one linear pass, if keys are not strictly increasing (using Compare)
+         * then ReaderError::InvalidData is set.
+         */
+        template <typename Compare = void>
+        class BasicFlatSet {
+        public:
+
+            constexpr explicit BasicFlatSet(size_t maxSize):_maxSize{maxSize} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&fnc) const {
+                using TKey = typename traits::ContainerTraits<T>::TValue;
+                auto size = traits::ContainerTraits<T>::size(obj);
+                assert(size <= _maxSize);
+                assert(isSorted(obj));
+                details::writeSize(writer, size);
+
+                for (auto &v:obj)
+                    fnc(const_cast<TKey &>(v));
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&fnc) const {
+                static_assert(traits::ContainerTraits<T>::isResizable, "flat set must be resizable container");
+                size_t size{};
+                details::readSize(reader, size, _maxSize);
+                traits::ContainerTraits<T>::resize(obj, size);
+
+                for (auto &v:obj)
+                    fnc(v);
+                if (reader.error() == ReaderError::NoError && !isSorted(obj))
+                    reader.setError(ReaderError::InvalidData);
+            }
+        private:
+
+            template <typename T>
+            bool isSorted(const T& obj) const {
+                using TKey = typename traits::ContainerTraits<T>::TValue;
+                using TCompare = typename std::conditional<std::is_void<Compare>::value, std::less<TKey>, Compare>::type;
+                TCompare cmp{};
+                auto first = std::begin(obj);
+                auto last = std::end(obj);
+                if (first == last)
+                    return true;
+                for (auto next = std::next(first); next != last; ++first, ++next) {
+                    if (!cmp(*first, *next))
+                        return false;
+                }
+                return true;
+            }
+
+            size_t _maxSize;
+        };
+
+        using FlatSet = BasicFlatSet<>;
+    }
+
+    namespace traits {
+        template<typename Compare, typename T>
+        struct ExtensionTraits<ext::BasicFlatSet<Compare>, T> {
+            using TValue = typename ContainerTraits<T>::TValue;
+            static constexpr bool SupportValueOverload = true;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = true;
+        };
+    }
+
+}
+
+
+#endif //BITSERY_EXT_FLAT_SET_H
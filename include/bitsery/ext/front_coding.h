@@ -0,0 +1,372 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_FRONT_CODING_H
+#define BITSERY_EXT_FRONT_CODING_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../details/serialization_common.h"
+#include "../details/adapter_utils.h"
+
+namespace bitsery {
+
+    namespace details {
+
+        //length of common prefix, compares 8 bytes at a time
+        template<typename CharT>
+        size_t frontCodingPrefix(const CharT *lhs, size_t lhsSize, const CharT *rhs, size_t rhsSize) {
+            const auto bytes = (std::min)(lhsSize, rhsSize) * sizeof(CharT);
+            const auto *l = reinterpret_cast<const unsigned char *>(lhs);
+            const auto *r = reinterpret_cast<const unsigned char *>(rhs);
+            size_t i{};
+            for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+                uint64_t lw, rw;
+                std::memcpy(&lw, l + i, sizeof(lw));
+                std::memcpy(&rw, r + i, sizeof(rw));
+                if (lw != rw)
+                    break;
+            }
+            while (i < bytes && l[i] == r[i])
+                ++i;
+            return i / sizeof(CharT);
+        }
+
+        //containers with key_type are filled with emplace_hint, others are resized and assigned
+        template<typename T>
+        struct IsFrontCodingSet {
+            template<typename U>
+            static std::true_type test(typename U::key_type *);
+
+            template<typename U>
+            static std::false_type test(...);
+
+            static constexpr bool value = decltype(test<T>(nullptr))::value;
+        };
+    }
+
+    namespace ext {
+
+        class FrontCoded;
+
+        /*
+         * read-only sorted collection of strings, that keeps front coded representation in memory.
+         * deserializing into it requires only few allocations, and strings are decoded on demand,
+         * starting from nearest restart point. lowerBound uses binary search over restart points,
+         * so it requires that strings were sorted when serialized.
+         */
+        class FrontCodedStrings {
+        public:
+
+            size_t size() const {
+                return _entries.size();
+            }
+
+            bool empty() const {
+                return _entries.empty();
+            }
+
+            size_t restartInterval() const {
+                return _restartInterval;
+            }
+
+            //decodes string at index into out, reusing its capacity
+            void get(size_t index, std::string &out) const {
+                assert(index < size());
+                const auto first = index - index % _restartInterval;
+                out.clear();
+                for (auto i = first; i <= index; ++i)
+                    append(_entries[i], out);
+            }
+
+            std::string operator[](size_t index) const {
+                std::string res{};
+                get(index, res);
+                return res;
+            }
+
+            //index of first string not less than key, or size() if there is no such string
+            size_t lowerBound(const std::string &key) const {
+                std::string scratch{};
+                return lowerBound(key, scratch);
+            }
+
+            bool contains(const std::string &key) const {
+                std::string scratch{};
+                return lowerBound(key, scratch) < size() && scratch == key;
+            }
+
+            //invokes fnc(const std::string&) for each string in order
+            template<typename Fnc>
+            void forEach(Fnc &&fnc) const {
+                std::string scratch{};
+                for (auto &e: _entries) {
+                    append(e, scratch);
+                    fnc(static_cast<const std::string &>(scratch));
+                }
+            }
+
+            void clear() {
+                _entries.clear();
+                _data.clear();
+            }
+
+        private:
+            friend class FrontCoded;
+
+            struct Entry {
+                size_t shared;
+                size_t offset;
+                size_t length;
+            };
+
+            //same as public lowerBound, but also leaves found string in scratch
+            size_t lowerBound(const std::string &key, std::string &scratch) const {
+                //find first restart point that is not less than key
+                size_t first{};
+                size_t count = (size() + _restartInterval - 1) / _restartInterval;
+                while (count > 0) {
+                    const auto step = count / 2;
+                    const auto &e = _entries[(first + step) * _restartInterval];
+                    if (key.compare(0, std::string::npos, _data.data() + e.offset, e.length) > 0) {
+                        first += step + 1;
+                        count -= step + 1;
+                    } else {
+                        count = step;
+                    }
+                }
+                if (first == 0) {
+                    if (!empty())
+                        append(_entries[0], scratch);
+                    return 0;
+                }
+                //scan previous block
+                const auto end = (std::min)(first * _restartInterval, size());
+                for (auto i = (first - 1) * _restartInterval; i < end; ++i) {
+                    append(_entries[i], scratch);
+                    if (scratch.compare(key) >= 0)
+                        return i;
+                }
+                //next restart point is not less than key
+                if (end < size())
+                    append(_entries[end], scratch);
+                return end;
+            }
+
+            void append(const Entry &e, std::string &out) const {
+                out.resize(e.shared);
+                out.append(_data.data() + e.offset, e.length);
+            }
+
+            std::vector<Entry> _entries{};
+            //concatenated suffixes
+            std::vector<char> _data{};
+            size_t _restartInterval{1};
+        };
+
+        /*
+         * writes collection of strings with front coding: each string is written as length of prefix shared
+         * with previous string, and remaining suffix. every restartInterval string is written in full,
+         * so that reader can start decoding from restart points.
+         * works best when strings are sorted, e.g. std::set<std::string>.
+         * deserializes into sequence containers or sets of strings, or FrontCodedStrings.
+         */
+        class FrontCoded {
+        public:
+
+            /**
+             * @param maxSize max number of strings
+             * @param maxLength max length of each string
+             * @param restartInterval number of strings between strings that are written in full
+             */
+            explicit constexpr FrontCoded(size_t maxSize, size_t maxLength, size_t restartInterval = 16)
+                    :_maxSize{maxSize},
+                     _maxLength{maxLength},
+                     _restartInterval{restartInterval} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&) const {
+                using TString = typename std::decay<decltype(*std::begin(obj))>::type;
+                using CharT = typename TString::value_type;
+                assert(_restartInterval > 0);
+                const auto size = static_cast<size_t>(std::distance(std::begin(obj), std::end(obj)));
+                assert(size <= _maxSize);
+                details::writeSize(writer, size);
+                details::writeSize(writer, restartIntervalFor(_restartInterval, size));
+                auto prev = std::begin(obj);
+                size_t i{};
+                for (auto it = std::begin(obj); it != std::end(obj); ++it, ++i) {
+                    const auto &str = *it;
+                    assert(str.size() <= _maxLength);
+                    size_t shared{};
+                    if (i % _restartInterval) {
+                        shared = details::frontCodingPrefix(prev->data(), prev->size(), str.data(), str.size());
+                        details::writeSize(writer, shared);
+                    }
+                    details::writeSize(writer, str.size() - shared);
+                    writer.template writeBuffer<sizeof(CharT), CharT>(str.data() + shared, str.size() - shared);
+                    prev = it;
+                }
+            }
+
+            template<typename Ser, typename Writer, typename Fnc>
+            void serialize(Ser &, Writer &writer, const FrontCodedStrings &obj, Fnc &&) const {
+                assert(obj.size() <= _maxSize);
+                details::writeSize(writer, obj.size());
+                details::writeSize(writer, restartIntervalFor(obj._restartInterval, obj.size()));
+                for (size_t i = 0; i < obj.size(); ++i) {
+                    const auto &e = obj._entries[i];
+                    if (i % obj._restartInterval)
+                        details::writeSize(writer, e.shared);
+                    details::writeSize(writer, e.length);
+                    //data is empty when all strings are empty
+                    if (e.length)
+                        writer.template writeBuffer<1, char>(obj._data.data() + e.offset, e.length);
+                }
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&) const {
+                using TString = typename std::decay<decltype(*std::begin(obj))>::type;
+                using CharT = typename TString::value_type;
+                size_t size{};
+                size_t restartInterval{};
+                readHeader(reader, size, restartInterval);
+                auto out = prepare(obj, size, std::integral_constant<bool, details::IsFrontCodingSet<T>::value>{});
+                //single scratch buffer is reused for all strings, it grows up to longest string
+                TString scratch{};
+                for (size_t i = 0; i < size; ++i) {
+                    size_t shared{};
+                    size_t length{};
+                    if (!readEntry(reader, i % restartInterval != 0, scratch.size(), shared, length))
+                        return;
+                    scratch.resize(shared + length);
+                    reader.template readBuffer<sizeof(CharT), CharT>(&scratch[shared], length);
+                    store(obj, out, scratch, std::integral_constant<bool, details::IsFrontCodingSet<T>::value>{});
+                }
+            }
+
+            template<typename Des, typename Reader, typename Fnc>
+            void deserialize(Des &, Reader &reader, FrontCodedStrings &obj, Fnc &&) const {
+                obj.clear();
+                size_t size{};
+                size_t restartInterval{};
+                readHeader(reader, size, restartInterval);
+                obj._restartInterval = restartInterval;
+                obj._entries.reserve(size);
+                size_t prevSize{};
+                for (size_t i = 0; i < size; ++i) {
+                    FrontCodedStrings::Entry e{};
+                    if (!readEntry(reader, i % restartInterval != 0, prevSize, e.shared, e.length)) {
+                        obj.clear();
+                        return;
+                    }
+                    e.offset = obj._data.size();
+                    //data is empty when all strings are empty
+                    if (e.length) {
+                        obj._data.resize(e.offset + e.length);
+                        reader.template readBuffer<1, char>(obj._data.data() + e.offset, e.length);
+                    }
+                    obj._entries.push_back(e);
+                    prevSize = e.shared + e.length;
+                }
+            }
+
+        private:
+
+            //interval longer than size means the same (only first string is written in full),
+            //so it is limited by size, and reader can reject larger values
+            static size_t restartIntervalFor(size_t restartInterval, size_t size) {
+                return (std::min)(restartInterval, (std::max)(size, size_t{1}));
+            }
+
+            template<typename Reader>
+            void readHeader(Reader &reader, size_t &size, size_t &restartInterval) const {
+                details::readSize(reader, size, _maxSize);
+                details::readSize(reader, restartInterval, (std::max)(size, size_t{1}));
+                if (restartInterval == 0) {
+                    //size is also zero when reader is in error state
+                    if (size)
+                        reader.setError(ReaderError::InvalidData);
+                    size = 0;
+                    restartInterval = 1;
+                }
+            }
+
+            template<typename Reader>
+            bool readEntry(Reader &reader, bool hasShared, size_t prevSize, size_t &shared, size_t &length) const {
+                shared = 0;
+                if (hasShared)
+                    details::readSize(reader, shared, prevSize);
+                details::readSize(reader, length, _maxLength - shared);
+                return reader.error() == ReaderError::NoError;
+            }
+
+            //sequence containers
+            template<typename T>
+            typename T::iterator prepare(T &obj, size_t size, std::false_type) const {
+                traits::ContainerTraits<T>::resize(obj, size);
+                return std::begin(obj);
+            }
+
+            template<typename T, typename TString>
+            void store(T &, typename T::iterator &it, const TString &str, std::false_type) const {
+                //assign reuses capacity of existing string
+                *it = str;
+                ++it;
+            }
+
+            //set containers, values are inserted at the end, which is amortized constant time for sorted values
+            template<typename T>
+            typename T::iterator prepare(T &obj, size_t, std::true_type) const {
+                obj.clear();
+                return obj.end();
+            }
+
+            template<typename T, typename TString>
+            void store(T &obj, typename T::iterator &hint, const TString &str, std::true_type) const {
+                hint = obj.emplace_hint(hint, str);
+                ++hint;
+            }
+
+            size_t _maxSize;
+            size_t _maxLength;
+            size_t _restartInterval;
+        };
+    }
+
+    namespace traits {
+        template<typename T>
+        struct ExtensionTraits<ext::FrontCoded, T> {
+            using TValue = void;
+            static constexpr bool SupportValueOverload = false;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = false;
+        };
+    }
+
+}
+
+#endif //BITSERY_EXT_FRONT_CODING_H
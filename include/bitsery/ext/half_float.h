@@ -0,0 +1,322 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_HALF_FLOAT_H
+#define BITSERY_EXT_HALF_FLOAT_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include "../details/serialization_common.h"
+#include "../details/adapter_utils.h"
+
+#if defined(__F16C__)
+#define BITSERY_F16C_ENABLED 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+//F16C is not enabled for whole translation unit, so select it at runtime
+#define BITSERY_F16C_DISPATCH 1
+#include <cpuid.h>
+#endif
+
+#if defined(BITSERY_F16C_ENABLED) || defined(BITSERY_F16C_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace bitsery {
+
+    namespace details {
+
+        inline uint32_t floatBits(float v) {
+            uint32_t res;
+            std::memcpy(&res, &v, sizeof(res));
+            return res;
+        }
+
+        inline float floatFromBits(uint32_t v) {
+            float res;
+            std::memcpy(&res, &v, sizeof(res));
+            return res;
+        }
+
+        //IEEE 754 binary16, rounds to nearest even, NaN payload is truncated and NaN is quieted, same as F16C
+        inline uint16_t floatToHalf(float v) {
+            const auto x = floatBits(v);
+            const auto sign = (x >> 16) & 0x8000u;
+            const auto absx = x & 0x7FFFFFFFu;
+            if (absx >= 0x7F800000u)
+                return static_cast<uint16_t>(sign | (absx > 0x7F800000u ? 0x7E00u | ((absx >> 13) & 0x3FFu) : 0x7C00u));
+            //halfway between max half and 2^16 rounds to infinity
+            if (absx >= 0x477FF000u)
+                return static_cast<uint16_t>(sign | 0x7C00u);
+            if (absx < 0x38800000u) {
+                //half of smallest subnormal rounds to zero
+                if (absx <= 0x33000000u)
+                    return static_cast<uint16_t>(sign);
+                const auto shift = 126u - (absx >> 23);
+                const auto mant = (absx & 0x7FFFFFu) | 0x800000u;
+                auto h = mant >> shift;
+                const auto rem = mant & ((1u << shift) - 1u);
+                const auto half = 1u << (shift - 1u);
+                if (rem > half || (rem == half && (h & 1u)))
+                    ++h;
+                return static_cast<uint16_t>(sign | h);
+            }
+            //rebias exponent, rounding carry might propagate to exponent, which is correct
+            auto h = (absx - 0x38000000u) >> 13;
+            const auto rem = absx & 0x1FFFu;
+            if (rem > 0x1000u || (rem == 0x1000u && (h & 1u)))
+                ++h;
+            return static_cast<uint16_t>(sign | h);
+        }
+
+        inline float halfToFloat(uint16_t h) {
+            const auto sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+            const auto exp = (h >> 10) & 0x1Fu;
+            const auto mant = static_cast<uint32_t>(h & 0x3FFu);
+            //NaN is quieted, same as F16C
+            if (exp == 0x1Fu)
+                return floatFromBits(sign | 0x7F800000u | (mant << 13) | (mant ? 0x400000u : 0u));
+            if (exp == 0) {
+                //subnormal, value is mant * 2^-24, which is exact in float
+                const auto abs = static_cast<float>(mant) * 5.9604644775390625e-8f;
+                return floatFromBits(sign | floatBits(abs));
+            }
+            return floatFromBits(sign | ((exp + 112u) << 23) | (mant << 13));
+        }
+
+        //bfloat16 is upper half of float, rounds to nearest even, NaN is quieted.
+        //branch free, so that compiler could vectorize loops
+        inline uint16_t floatToBFloat16(float v) {
+            const auto x = floatBits(v);
+            const auto rounded = (x + 0x7FFFu + ((x >> 16) & 1u)) >> 16;
+            const auto nan = (x >> 16) | 0x40u;
+            return static_cast<uint16_t>((x & 0x7FFFFFFFu) > 0x7F800000u ? nan : rounded);
+        }
+
+        inline float bfloat16ToFloat(uint16_t v) {
+            return floatFromBits(static_cast<uint32_t>(v) << 16);
+        }
+
+        inline void floatsToHalvesScalar(const float* in, uint16_t* out, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = floatToHalf(in[i]);
+        }
+
+        inline void halvesToFloatsScalar(const uint16_t* in, float* out, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = halfToFloat(in[i]);
+        }
+
+#if defined(BITSERY_F16C_ENABLED) || defined(BITSERY_F16C_DISPATCH)
+
+#if defined(BITSERY_F16C_DISPATCH)
+#define BITSERY_F16C_TARGET __attribute__((target("avx,f16c")))
+#else
+#define BITSERY_F16C_TARGET
+#endif
+
+        BITSERY_F16C_TARGET
+        inline void floatsToHalvesF16C(const float* in, uint16_t* out, size_t count) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const auto h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+            }
+            floatsToHalvesScalar(in + i, out + i, count - i);
+        }
+
+        BITSERY_F16C_TARGET
+        inline void halvesToFloatsF16C(const uint16_t* in, float* out, size_t count) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                const auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+            }
+            halvesToFloatsScalar(in + i, out + i, count - i);
+        }
+
+#undef BITSERY_F16C_TARGET
+
+#endif
+
+        inline bool hasF16C() {
+#if defined(BITSERY_F16C_ENABLED)
+            return true;
+#elif defined(BITSERY_F16C_DISPATCH)
+            static const bool res = [] {
+                unsigned a{}, b{}, c{}, d{};
+                if (!__get_cpuid(1, &a, &b, &c, &d))
+                    return false;
+                //F16C, AVX and OSXSAVE bits
+                if ((c & (1u << 29)) == 0 || (c & (1u << 28)) == 0 || (c & (1u << 27)) == 0)
+                    return false;
+                //check that OS saves YMM registers
+                unsigned lo{}, hi{};
+                __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+                return (lo & 6u) == 6u;
+            }();
+            return res;
+#else
+            return false;
+#endif
+        }
+
+        inline void floatsToHalves(const float* in, uint16_t* out, size_t count) {
+#if defined(BITSERY_F16C_ENABLED) || defined(BITSERY_F16C_DISPATCH)
+            if (hasF16C())
+                return floatsToHalvesF16C(in, out, count);
+#endif
+            floatsToHalvesScalar(in, out, count);
+        }
+
+        inline void halvesToFloats(const uint16_t* in, float* out, size_t count) {
+#if defined(BITSERY_F16C_ENABLED) || defined(BITSERY_F16C_DISPATCH)
+            if (hasF16C())
+                return halvesToFloatsF16C(in, out, count);
+#endif
+            halvesToFloatsScalar(in, out, count);
+        }
+
+        inline void floatsToBFloats16(const float* in, uint16_t* out, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = floatToBFloat16(in[i]);
+        }
+
+        inline void bfloats16ToFloats(const uint16_t* in, float* out, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                out[i] = bfloat16ToFloat(in[i]);
+        }
+    }
+
+    namespace ext {
+
+        enum class HalfFloatFormat {
+            Float16,//IEEE 754 binary16: 5 bits exponent, 10 bits mantissa, max value 65504
+            BFloat16//8 bits exponent, 7 bits mantissa, same range as float
+        };
+
+        /*
+         * writes container of floats as 2 byte values, values are rounded to nearest even.
+         * float16 values larger than 65504 becomes infinity.
+         * conversion is done in blocks, and each block is written with single writeBuffer call,
+         * on x86 float16 conversion uses F16C instructions when CPU supports them.
+         */
+        class HalfFloatContainer {
+        public:
+
+            /**
+             * @param maxSize max container size, only used for resizable containers
+             * @param format float16 or bfloat16
+             */
+            explicit constexpr HalfFloatContainer(size_t maxSize, HalfFloatFormat format = HalfFloatFormat::Float16)
+                    :_maxSize{maxSize},
+                     _format{format} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&) const {
+                static_assert(std::is_same<typename traits::ContainerTraits<T>::TValue, float>::value,
+                              "HalfFloatContainer only works with containers of float");
+                const auto size = traits::ContainerTraits<T>::size(obj);
+                assert(size <= _maxSize);
+                writeSize(writer, size, std::integral_constant<bool, traits::ContainerTraits<T>::isResizable>{});
+
+                float values[BlockSize];
+                uint16_t codes[BlockSize];
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size; i += BlockSize) {
+                    const auto n = (std::min)(size_t{BlockSize}, size - i);
+                    for (size_t j = 0; j < n; ++j, ++it)
+                        values[j] = *it;
+                    if (_format == HalfFloatFormat::Float16)
+                        details::floatsToHalves(values, codes, n);
+                    else
+                        details::floatsToBFloats16(values, codes, n);
+                    writer.template writeBuffer<2, uint16_t>(codes, n);
+                }
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&) const {
+                static_assert(std::is_same<typename traits::ContainerTraits<T>::TValue, float>::value,
+                              "HalfFloatContainer only works with containers of float");
+                const auto size = readSize(reader, obj, std::integral_constant<bool, traits::ContainerTraits<T>::isResizable>{});
+
+                float values[BlockSize];
+                uint16_t codes[BlockSize];
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size; i += BlockSize) {
+                    const auto n = (std::min)(size_t{BlockSize}, size - i);
+                    reader.template readBuffer<2, uint16_t>(codes, n);
+                    if (_format == HalfFloatFormat::Float16)
+                        details::halvesToFloats(codes, values, n);
+                    else
+                        details::bfloats16ToFloats(codes, values, n);
+                    for (size_t j = 0; j < n; ++j, ++it)
+                        *it = values[j];
+                }
+            }
+
+        private:
+            static constexpr size_t BlockSize = 256;
+
+            template<typename Writer>
+            void writeSize(Writer &w, size_t size, std::true_type) const {
+                details::writeSize(w, size);
+            }
+
+            template<typename Writer>
+            void writeSize(Writer &, size_t, std::false_type) const {
+            }
+
+            template<typename Reader, typename T>
+            size_t readSize(Reader &r, T &obj, std::true_type) const {
+                size_t size{};
+                details::readSize(r, size, _maxSize);
+                traits::ContainerTraits<T>::resize(obj, size);
+                return size;
+            }
+
+            template<typename Reader, typename T>
+            size_t readSize(Reader &, T &obj, std::false_type) const {
+                return traits::ContainerTraits<T>::size(obj);
+            }
+
+            size_t _maxSize;
+            HalfFloatFormat _format;
+        };
+
+    }
+
+    namespace traits {
+        template<typename T>
+        struct ExtensionTraits<ext::HalfFloatContainer, T> {
+            using TValue = void;
+            static constexpr bool SupportValueOverload = false;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = false;
+        };
+    }
+
+}
+
+#endif //BITSERY_EXT_HALF_FLOAT_H
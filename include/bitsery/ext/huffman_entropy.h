@@ -0,0 +1,397 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_HUFFMAN_ENTROPY_H
+#define BITSERY_EXT_HUFFMAN_ENTROPY_H
+
+#include "entropy.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace bitsery {
+
+    namespace details {
+
+        /*
+         * calculates huffman code length for each symbol frequency.
+         * if longest code exceeds maxLength, then frequencies are halved and tree is rebuilt,
+         * this slightly reduces compression, but is much simpler than package-merge algorithm.
+         */
+        inline std::vector<uint8_t> huffmanCodeLengths(std::vector<uint64_t> frequencies, size_t maxLength) {
+            const auto count = frequencies.size();
+            std::vector<uint8_t> lengths(count, 1u);
+            if (count < 2)
+                return lengths;
+            assert(count <= (static_cast<size_t>(1u) << maxLength));
+            using Node = std::pair<uint64_t, size_t>;
+            std::vector<size_t> parent(count * 2 - 1);
+            std::vector<size_t> depth(count * 2 - 1);
+            for (;;) {
+                std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue{};
+                for (size_t i = 0; i < count; ++i)
+                    queue.emplace(frequencies[i], i);
+                for (auto next = count; queue.size() > 1; ++next) {
+                    auto a = queue.top();
+                    queue.pop();
+                    auto b = queue.top();
+                    queue.pop();
+                    parent[a.second] = next;
+                    parent[b.second] = next;
+                    queue.emplace(a.first + b.first, next);
+                }
+                //parent index is always greater than child index, so we can calculate depth from root
+                const auto root = count * 2 - 2;
+                depth[root] = 0;
+                size_t maxDepth{};
+                for (auto i = root; i > 0; --i) {
+                    depth[i - 1] = depth[parent[i - 1]] + 1;
+                    maxDepth = (std::max)(maxDepth, depth[i - 1]);
+                }
+                if (maxDepth <= maxLength) {
+                    for (size_t i = 0; i < count; ++i)
+                        lengths[i] = static_cast<uint8_t>(depth[i]);
+                    return lengths;
+                }
+                for (auto &f:frequencies)
+                    f = (f >> 1) | 1u;
+            }
+        }
+
+        inline uint32_t reverseBits(uint32_t v, size_t bitsCount) {
+            uint32_t res{};
+            for (size_t i = 0; i < bitsCount; ++i, v >>= 1)
+                res = (res << 1) | (v & 1u);
+            return res;
+        }
+
+    }
+
+    namespace ext {
+
+        /*
+         * static canonical huffman code table for most common values.
+         * symbol 0 is reserved for escape, it is written when value is not in the table.
+         * table stores values, codes and decoding tables.
+         * values of hashable types are stored only in lookup index, otherwise in plain list.
+         */
+        template<typename TValue>
+        class HuffmanTable {
+        public:
+            //longest code, that is written/read with single writeBits/readBits call
+            static constexpr size_t MaxCodeLength = 24;
+
+            /**
+             * Builds code table from values and their frequencies.
+             * @param values list of most common values
+             * @param frequencies how often each value occurs, must be same size as values
+             * @param escapeFrequency how often values that are not in the list occurs
+             */
+            template<typename TValues, typename TFrequencies>
+            HuffmanTable(const TValues &values, const TFrequencies &frequencies, uint64_t escapeFrequency = 1u)
+                    : _frequencies(std::begin(frequencies), std::end(frequencies)),
+                      _escapeFrequency{escapeFrequency} {
+                storeValues(values, details::HasEntropyHash<TValue>{});
+                assert(this->values().size() == _frequencies.size());
+                buildCodes();
+            }
+
+            const std::vector<TValue> &values() const {
+                return values(details::HasEntropyHash<TValue>{});
+            }
+
+            const std::vector<uint64_t> &frequencies() const {
+                return _frequencies;
+            }
+
+            uint64_t escapeFrequency() const {
+                return _escapeFrequency;
+            }
+
+            //returns symbol for value, or 0 (escape) if value is not in the table
+            template<typename T>
+            size_t findSymbol(const T &v) const {
+                return findSymbol(v, std::integral_constant<bool,
+                        std::is_same<T, TValue>::value && details::HasEntropyHash<TValue>::value>{});
+            }
+
+            size_t codeLength(size_t symbol) const {
+                return _lengths[symbol];
+            }
+
+            const TValue &value(size_t symbol) const {
+                return values()[symbol - 1];
+            }
+
+            template<typename Writer>
+            void writeSymbol(Writer &writer, size_t symbol) const {
+                writer.writeBits(_codes[symbol], _lengths[symbol]);
+            }
+
+            //reads all bits that are shared by shortest code at once, and then continues bit by bit
+            //returns false and sets error if code is invalid
+            template<typename Reader>
+            bool readSymbol(Reader &reader, size_t &symbol) const {
+                uint32_t bits{};
+                reader.readBits(bits, _minLength);
+                auto code = details::reverseBits(bits, _minLength);
+                for (auto len = _minLength;; ++len) {
+                    const auto offset = code - _firstCode[len];
+                    if (offset < _lengthCount[len]) {
+                        symbol = _sortedSymbols[_firstIndex[len] + offset];
+                        return true;
+                    }
+                    if (len == _maxLength)
+                        break;
+                    uint8_t bit{};
+                    reader.readBits(bit, 1);
+                    code = (code << 1) | static_cast<uint32_t>(bit);
+                }
+                reader.setError(ReaderError::InvalidData);
+                return false;
+            }
+
+        private:
+
+            void buildCodes() {
+                std::vector<uint64_t> frequencies{};
+                frequencies.reserve(_frequencies.size() + 1);
+                frequencies.push_back(_escapeFrequency);
+                frequencies.insert(frequencies.end(), _frequencies.begin(), _frequencies.end());
+                //every symbol must have a code
+                for (auto &f:frequencies)
+                    f = (std::max)(f, static_cast<uint64_t>(1u));
+                _lengths = details::huffmanCodeLengths(std::move(frequencies), MaxCodeLength);
+
+                //canonical codes: sorted by length, then by symbol
+                const auto count = _lengths.size();
+                _sortedSymbols.resize(count);
+                for (size_t i = 0; i < count; ++i)
+                    _sortedSymbols[i] = i;
+                std::stable_sort(_sortedSymbols.begin(), _sortedSymbols.end(), [this](size_t a, size_t b) {
+                    return _lengths[a] < _lengths[b];
+                });
+                _minLength = _lengths[_sortedSymbols.front()];
+                _maxLength = _lengths[_sortedSymbols.back()];
+                _codes.resize(count);
+                uint32_t code{};
+                size_t prevLength = _minLength;
+                for (size_t i = 0; i < count; ++i) {
+                    const auto symbol = _sortedSymbols[i];
+                    const auto len = _lengths[symbol];
+                    code <<= (len - prevLength);
+                    if (_lengthCount[len] == 0) {
+                        _firstCode[len] = code;
+                        _firstIndex[len] = i;
+                    }
+                    ++_lengthCount[len];
+                    //bits are written starting from least significant bit, so reverse them to keep prefix property
+                    _codes[symbol] = details::reverseBits(code, len);
+                    ++code;
+                    prevLength = len;
+                }
+            }
+
+            template<typename TValues>
+            void storeValues(const TValues &values, std::true_type) {
+                _hashIndex.build(values);
+            }
+
+            template<typename TValues>
+            void storeValues(const TValues &values, std::false_type) {
+                _values.assign(std::begin(values), std::end(values));
+            }
+
+            const std::vector<TValue> &values(std::true_type) const {
+                return _hashIndex.values();
+            }
+
+            const std::vector<TValue> &values(std::false_type) const {
+                return _values;
+            }
+
+            template<typename T>
+            size_t findSymbol(const T &v, std::true_type) const {
+                return _hashIndex.find(v);
+            }
+
+            template<typename T>
+            size_t findSymbol(const T &v, std::false_type) const {
+                return details::findEntropyIndex(v, _values);
+            }
+
+            std::vector<TValue> _values{};
+            std::vector<uint64_t> _frequencies;
+            uint64_t _escapeFrequency;
+            details::EntropyHashIndex<TValue> _hashIndex{};
+            //encoding tables
+            std::vector<uint32_t> _codes{};
+            std::vector<uint8_t> _lengths{};
+            //decoding tables
+            std::vector<size_t> _sortedSymbols{};
+            uint32_t _firstCode[MaxCodeLength + 1]{};
+            size_t _firstIndex[MaxCodeLength + 1]{};
+            size_t _lengthCount[MaxCodeLength + 1]{};
+            size_t _minLength{};
+            size_t _maxLength{};
+        };
+
+        template<typename TValue>
+        constexpr size_t HuffmanTable<TValue>::MaxCodeLength;
+
+        /*
+         * collects value frequencies, when it is set as serialization context,
+         * so that table could be trained using same serialization flow as real data.
+         * e.g. serialize sample objects with BasicSerializer<MeasureSize, HuffmanTableTrainer<T>>.
+         * while training, HuffmanEntropy only counts values and serializes them as escaped values.
+         */
+        template<typename TValue>
+        class HuffmanTableTrainer {
+        public:
+            static_assert(details::HasEntropyHash<TValue>::value, "HuffmanTableTrainer requires std::hash<TValue>");
+
+            void add(const TValue &v, uint64_t count = 1u) {
+                _frequencies[v] += count;
+            }
+
+            void clear() {
+                _frequencies.clear();
+            }
+
+            /**
+             * Builds table from most common values, all other values are escaped.
+             * Order of values with equal frequencies is unspecified, so build table once and
+             * store its values and frequencies, to create same table for serialization and deserialization.
+             * @param maxValuesCount max number of values in the table
+             */
+            HuffmanTable<TValue> build(size_t maxValuesCount) const {
+                std::vector<std::pair<TValue, uint64_t>> sorted(_frequencies.begin(), _frequencies.end());
+                std::stable_sort(sorted.begin(), sorted.end(),
+                                 [](const std::pair<TValue, uint64_t> &a, const std::pair<TValue, uint64_t> &b) {
+                                     return a.second > b.second;
+                                 });
+                const auto count = (std::min)(maxValuesCount, sorted.size());
+                std::vector<TValue> values{};
+                std::vector<uint64_t> frequencies{};
+                values.reserve(count);
+                frequencies.reserve(count);
+                uint64_t escapeFrequency{};
+                for (size_t i = 0; i < sorted.size(); ++i) {
+                    if (i < count) {
+                        values.push_back(sorted[i].first);
+                        frequencies.push_back(sorted[i].second);
+                    } else {
+                        escapeFrequency += sorted[i].second;
+                    }
+                }
+                return HuffmanTable<TValue>{values, frequencies, escapeFrequency};
+            }
+
+        private:
+            std::unordered_map<TValue, uint64_t, details::EntropyHash<TValue>> _frequencies{};
+        };
+
+        template<typename TValue>
+        class HuffmanEntropy {
+        public:
+
+            /**
+             * Writes huffman code for values from the table, and escape code followed by value or object for other values.
+             * Requires bit-packing.
+             * Default constructed extension gets HuffmanTable<TValue> from serialization context.
+             */
+            HuffmanEntropy() = default;
+
+            explicit HuffmanEntropy(const HuffmanTable<TValue> &table) : _table{&table} {
+            }
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &s, Writer &writer, const T &obj, Fnc &&fnc) const {
+                if (train(s, obj, details::HasEntropyHash<TValue>{})) {
+                    fnc(const_cast<T &>(obj));
+                    return;
+                }
+                auto &table = getTable(s);
+                auto symbol = table.findSymbol(obj);
+                table.writeSymbol(writer, symbol);
+                if (!symbol)
+                    fnc(const_cast<T &>(obj));
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &d, Reader &reader, T &obj, Fnc &&fnc) const {
+                auto &table = getTable(d);
+                size_t symbol{};
+                if (!table.readSymbol(reader, symbol))
+                    return;
+                if (symbol)
+                    obj = table.value(symbol);
+                else
+                    fnc(obj);
+            }
+
+        private:
+
+            template<typename Ser, typename T>
+            bool train(Ser &s, const T &obj, std::true_type) const {
+                if (auto trainer = s.template contextOrNull<HuffmanTableTrainer<TValue>>()) {
+                    trainer->add(obj);
+                    return true;
+                }
+                return false;
+            }
+
+            //trainer requires hash, so it cannot exist for this type
+            template<typename Ser, typename T>
+            bool train(Ser &, const T &, std::false_type) const {
+                return false;
+            }
+
+            template<typename S>
+            const HuffmanTable<TValue> &getTable(S &s) const {
+                if (_table)
+                    return *_table;
+                auto table = s.template contextOrNull<HuffmanTable<TValue>>();
+                assert(table != nullptr);
+                return *table;
+            }
+
+            const HuffmanTable<TValue> *_table{};
+        };
+    }
+
+    namespace traits {
+        template<typename TTableValue, typename T>
+        struct ExtensionTraits<ext::HuffmanEntropy<TTableValue>, T> {
+            using TValue = T;
+            static constexpr bool SupportValueOverload = true;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = true;
+        };
+    }
+
+}
+
+#endif //BITSERY_EXT_HUFFMAN_ENTROPY_H
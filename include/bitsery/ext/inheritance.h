@@ -23,8 +23,10 @@
 #ifndef BITSERY_EXT_INHERITANCE_H
 #define BITSERY_EXT_INHERITANCE_H
 
-#include <unordered_set>
+#include <algorithm>
+#include <memory>
 #include "../traits/core/traits.h"
+#include "../details/small_vector.h"
 
 namespace bitsery {
 
@@ -54,19 +56,30 @@ namespace bitsery {
             template <typename TDerived, typename TBase>
             bool beginVirtualBase(const TDerived &derived, const TBase &base) {
                 beginBase(derived, base);
-                return _virtualBases.emplace(std::addressof(base)).second;
+                const void* ptr = std::addressof(base);
+                if (std::find(_virtualBases.begin(), _virtualBases.end(), ptr) != _virtualBases.end())
+                    return false;
+                _virtualBases.push_back(ptr);
+                return true;
             }
 
             void end() {
                 --_depth;
             }
 
+            void reset() {
+                _depth = 0;
+                _parentPtr = nullptr;
+                _virtualBases.clear();
+            }
+
         private:
             //these members are required to know when we can clear _virtualBases
             size_t _depth{};
             const void* _parentPtr{};
-            //add virtual bases to the list, as long as we're on the same parent
-            std::unordered_set<const void*> _virtualBases{};
+            //add virtual bases to the list, as long as we're on the same parent.
+            //usually there are only few virtual bases, so linear search in small vector is faster than hashing and doesn't allocate
+            details::SmallVector<const void*, 8> _virtualBases{};
         };
 
         template <typename TBase>
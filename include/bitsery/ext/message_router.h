@@ -0,0 +1,176 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_MESSAGE_ROUTER_H
+#define BITSERY_EXT_MESSAGE_ROUTER_H
+
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../details/adapter_utils.h"
+#include "../details/serialization_common.h"
+
+namespace bitsery {
+
+    namespace details {
+        //index of T in Ts...
+        template <typename T, typename ... Ts>
+        struct MessageIndex {
+            static_assert(std::is_void<T>::value && !std::is_void<T>::value, "message type is not registered in MessageRouter");
+        };
+
+        template <typename T, typename ... Ts>
+        struct MessageIndex<T, T, Ts...>: std::integral_constant<size_t, 0> {
+        };
+
+        template <typename T, typename U, typename ... Ts>
+        struct MessageIndex<T, U, Ts...>: std::integral_constant<size_t, 1 + MessageIndex<T, Ts...>::value> {
+        };
+
+        template <typename Handler, typename T>
+        struct HasMessageHandlerHelper {
+            template <typename Q, typename = decltype(std::declval<Q&>()(std::declval<T&>()))>
+            static std::true_type tester(Q*);
+            template <typename Q>
+            static std::false_type tester(...);
+            using type = decltype(tester<Handler>(nullptr));
+        };
+
+        template <typename Handler, typename T>
+        struct HasMessageHandler: HasMessageHandlerHelper<Handler, T>::type {};
+    }
+
+    namespace ext {
+
+        //free list of message objects, objects are reused, so their members keep allocated memory between messages.
+        template <typename T>
+        class MessagePool {
+        public:
+            std::unique_ptr<T> acquire() {
+                if (_free.empty())
+                    return std::unique_ptr<T>(new T{});
+                auto res = std::move(_free.back());
+                _free.pop_back();
+                return res;
+            }
+
+            void release(std::unique_ptr<T> obj) {
+                _free.push_back(std::move(obj));
+            }
+
+            size_t freeCount() const {
+                return _free.size();
+            }
+
+        private:
+            std::vector<std::unique_ptr<T>> _free{};
+        };
+
+        /*
+         * routes many message types over one channel.
+         * each message type gets dense id by its position in Ts..., message is written as compact id (same as container size)
+         * followed by message object.
+         * reader dispatches by id through jump table to handler(T&) overload, message object is taken from per type pool
+         * and returned after handler is called, so there are no heap allocations per message after warm up.
+         * messages that handler has no overload for are deserialized and skipped.
+         * message objects are reused without reset, so serialize function must write all fields.
+         * if handler needs to keep message, it should move from it.
+         */
+        template <typename ... Ts>
+        class MessageRouter {
+        public:
+            static_assert(sizeof...(Ts) > 0, "MessageRouter requires at least one message type");
+
+            static constexpr size_t MessagesCount = sizeof...(Ts);
+
+            template <typename T>
+            static constexpr size_t id() {
+                return details::MessageIndex<T, Ts...>::value;
+            }
+
+            template <typename Ser, typename T>
+            static void write(Ser& ser, const T& msg) {
+                details::writeSize(AdapterAccess::getWriter(ser), id<T>());
+                ser.object(msg);
+            }
+
+            //reads single message and calls handler with it, returns false on error, e.g. unknown message id
+            template <typename Des, typename Handler>
+            bool read(Des& des, Handler&& handler) {
+                using THandler = typename std::remove_reference<Handler>::type;
+                using TDispatch = bool (*)(MessageRouter&, Des&, THandler&);
+                static constexpr TDispatch jumpTable[] = {&MessageRouter::template dispatch<Ts, Des, THandler>...};
+                auto& reader = AdapterAccess::getReader(des);
+                size_t msgId{};
+                details::readSize(reader, msgId, MessagesCount - 1);
+                if (reader.error() != ReaderError::NoError)
+                    return false;
+                return jumpTable[msgId](*this, des, handler);
+            }
+
+            //reads messages until the end of input or error, returns number of handled messages
+            template <typename Des, typename Handler>
+            size_t readAll(Des& des, Handler&& handler) {
+                auto& reader = AdapterAccess::getReader(des);
+                size_t count{};
+                while (!reader.isCompletedSuccessfully() && read(des, handler))
+                    ++count;
+                return count;
+            }
+
+            template <typename T>
+            MessagePool<T>& pool() {
+                return std::get<id<T>()>(_pools);
+            }
+
+        private:
+
+            template <typename T, typename Des, typename Handler>
+            static bool dispatch(MessageRouter& router, Des& des, Handler& handler) {
+                auto& pool = router.pool<T>();
+                auto obj = pool.acquire();
+                des.object(*obj);
+                auto ok = AdapterAccess::getReader(des).error() == ReaderError::NoError;
+                if (ok)
+                    handle(handler, *obj, details::HasMessageHandler<Handler, T>{});
+                pool.release(std::move(obj));
+                return ok;
+            }
+
+            template <typename Handler, typename T>
+            static void handle(Handler& handler, T& obj, std::true_type) {
+                handler(obj);
+            }
+
+            template <typename Handler, typename T>
+            static void handle(Handler& , T& , std::false_type) {
+            }
+
+            std::tuple<MessagePool<Ts>...> _pools{};
+        };
+
+    }
+}
+
+#endif //BITSERY_EXT_MESSAGE_ROUTER_H
@@ -0,0 +1,351 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_PERSISTENT_POINTER_H
+#define BITSERY_EXT_PERSISTENT_POINTER_H
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "../details/serialization_common.h"
+#include "../details/adapter_utils.h"
+
+namespace bitsery {
+
+    namespace details {
+
+        //objects that expose integral `version()` are re-sent automatically when it changes
+        template<typename T>
+        struct HasPersistentVersion {
+            template<typename U>
+            static auto test(const U *u) -> typename std::is_integral<decltype(u->version())>::type;
+
+            template<typename U>
+            static std::false_type test(...);
+
+            static constexpr bool value = decltype(test<T>(nullptr))::value;
+        };
+
+        template<typename T>
+        uint64_t persistentVersion(const T &obj, std::true_type) {
+            return static_cast<uint64_t>(obj.version());
+        }
+
+        template<typename T>
+        uint64_t persistentVersion(const T &, std::false_type) {
+            return 0;
+        }
+
+        //unique address for each type, so that received objects can be checked for type without RTTI
+        template<typename T>
+        struct PersistentTypeTag {
+            static const char value;
+        };
+
+        template<typename T>
+        const char PersistentTypeTag<T>::value{};
+
+    }
+
+    namespace ext {
+
+        /*
+         * linking context that outlives a single message, so objects of incrementally streamed graph
+         * keep their identity across messages.
+         * serializer side remembers every sent object with its id and last sent version,
+         * deserializer side keeps id -> object table, so unchanged objects are transfered as id only.
+         * both sides must see every message in the same order, otherwise call reset() on both ends.
+         * ids of evicted objects are reused, so that ids stay small in long running streams.
+         * when all ids are in use, new objects are written as null and isValid() returns false.
+         */
+        class PersistentPointerLinkingContext {
+        public:
+            //id is written with writeSize together with a flag bit, so it must fit in 29 bits
+            static constexpr size_t MaxId = (1u << 29) - 1;
+
+            PersistentPointerLinkingContext()
+                    : PersistentPointerLinkingContext(MaxId) {}
+
+            //maxId limits number of objects that are alive at the same time
+            explicit PersistentPointerLinkingContext(size_t maxId)
+                    : _maxId{maxId < MaxId ? maxId : size_t{MaxId}},
+                      _currId{0},
+                      _idsExhausted{false},
+                      _sent{},
+                      _evicted{},
+                      _freeIds{},
+                      _objects{} {}
+
+            PersistentPointerLinkingContext(const PersistentPointerLinkingContext &) = delete;
+
+            PersistentPointerLinkingContext &operator=(const PersistentPointerLinkingContext &) = delete;
+
+            PersistentPointerLinkingContext(PersistentPointerLinkingContext &&) = default;
+
+            PersistentPointerLinkingContext &operator=(PersistentPointerLinkingContext &&) = default;
+
+            ~PersistentPointerLinkingContext() = default;
+
+            //serializer side
+
+            //force full object to be sent next time, when it doesn't provide `version()`
+            template<typename T>
+            void markChanged(const std::shared_ptr<T> &obj) {
+                auto it = _sent.find(static_cast<const void *>(obj.get()));
+                if (it != _sent.end())
+                    it->second.changed = true;
+            }
+
+            //forget object and schedule its id for eviction on deserializer side
+            template<typename T>
+            void release(const std::shared_ptr<T> &obj) {
+                auto it = _sent.find(static_cast<const void *>(obj.get()));
+                if (it != _sent.end()) {
+                    _evicted.push_back(it->second.id);
+                    _sent.erase(it);
+                }
+            }
+
+            //release all objects that were destroyed on serializer side, returns released objects count
+            size_t collect() {
+                size_t count{};
+                for (auto it = _sent.begin(); it != _sent.end();) {
+                    if (it->second.obj.expired()) {
+                        _evicted.push_back(it->second.id);
+                        it = _sent.erase(it);
+                        ++count;
+                    } else
+                        ++it;
+                }
+                return count;
+            }
+
+            //ids that must be passed to deserializer side evict(...), typically at the start of next message.
+            //taken ids are reused for new objects, so they must be evicted before reading anything serialized afterwards
+            std::vector<uint64_t> takeEvictions() {
+                for (auto id: _evicted)
+                    _freeIds.push_back(static_cast<size_t>(id));
+                std::vector<uint64_t> res{};
+                res.swap(_evicted);
+                return res;
+            }
+
+            size_t sentObjectsCount() const {
+                return _sent.size();
+            }
+
+            //received object with tag of the type it was created as
+            struct ReceivedObject {
+                ReceivedObject(std::shared_ptr<void> obj_, const void *typeTag_)
+                        : obj{std::move(obj_)},
+                          typeTag{typeTag_} {}
+
+                //need to override these explicitly because we have pointer member
+                ReceivedObject(const ReceivedObject &) = default;
+                ReceivedObject(ReceivedObject &&) = default;
+                ReceivedObject &operator=(const ReceivedObject &) = default;
+                ReceivedObject &operator=(ReceivedObject &&) = default;
+
+                std::shared_ptr<void> obj;
+                const void *typeTag;
+            };
+
+            //false, when some object was written as null, because all ids were in use
+            bool isValid() const {
+                return !_idsExhausted;
+            }
+
+            //deserializer side
+
+            void evict(uint64_t id) {
+                _objects.erase(static_cast<size_t>(id));
+            }
+
+            template<typename It>
+            void evict(It first, It last) {
+                for (; first != last; ++first)
+                    evict(static_cast<uint64_t>(*first));
+            }
+
+            size_t receivedObjectsCount() const {
+                return _objects.size();
+            }
+
+            //forget everything on both sides, allocated memory is kept
+            void reset() {
+                _currId = 0;
+                _idsExhausted = false;
+                _sent.clear();
+                _evicted.clear();
+                _freeIds.clear();
+                _objects.clear();
+            }
+
+            //returns id and sets needsObject if object is new or changed since it was last sent,
+            //returns 0 if object is new and all ids are in use
+            template<typename T>
+            size_t getIdByPtr(const std::shared_ptr<T> &obj, uint64_t version, bool &needsObject) {
+                const void *key = static_cast<const void *>(obj.get());
+                auto it = _sent.find(key);
+                //address can be reused by new object after previous one was destroyed
+                if (it != _sent.end() && it->second.obj.expired()) {
+                    _evicted.push_back(it->second.id);
+                    _sent.erase(it);
+                    it = _sent.end();
+                }
+                if (it == _sent.end()) {
+                    size_t id{};
+                    if (_freeIds.empty()) {
+                        if (_currId == _maxId) {
+                            _idsExhausted = true;
+                            needsObject = false;
+                            return 0;
+                        }
+                        id = ++_currId;
+                    } else {
+                        id = _freeIds.back();
+                        _freeIds.pop_back();
+                    }
+                    _sent.emplace(key, SentInfo{id, version, obj, false});
+                    needsObject = true;
+                    return id;
+                }
+                auto &info = it->second;
+                needsObject = info.changed || info.version != version;
+                info.version = version;
+                info.changed = false;
+                return info.id;
+            }
+
+            ReceivedObject *getObjectById(size_t id) {
+                auto it = _objects.find(id);
+                return it != _objects.end() ? &it->second : nullptr;
+            }
+
+            ReceivedObject &addObject(size_t id, std::shared_ptr<void> obj, const void *typeTag) {
+                auto it = _objects.find(id);
+                if (it != _objects.end()) {
+                    it->second = ReceivedObject{std::move(obj), typeTag};
+                    return it->second;
+                }
+                return _objects.emplace(id, ReceivedObject{std::move(obj), typeTag}).first->second;
+            }
+
+        private:
+            struct SentInfo {
+                size_t id;
+                uint64_t version;
+                std::weak_ptr<const void> obj;
+                bool changed;
+            };
+
+            size_t _maxId;
+            size_t _currId;
+            bool _idsExhausted;
+            std::unordered_map<const void *, SentInfo> _sent;
+            std::vector<uint64_t> _evicted;
+            std::vector<size_t> _freeIds;
+            std::unordered_map<size_t, ReceivedObject> _objects;
+        };
+
+        /*
+         * std::shared_ptr that is linked through PersistentPointerLinkingContext.
+         * object is written only first time, or when it has changed, otherwise only its id is written.
+         * when object is received again, existing instance is updated in place.
+         * polymorphic types are not supported, same id must always be read as the same type,
+         * otherwise (e.g. eviction was missed) ReaderError::InvalidPointer is set.
+         */
+        class PersistentSharedPtr {
+        public:
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &ser, Writer &w, const T &obj, Fnc &&fnc) const {
+                if (obj) {
+                    auto ctx = ser.template context<PersistentPointerLinkingContext>();
+                    assert(ctx != nullptr);
+                    using TElement = typename T::element_type;
+                    const auto version = details::persistentVersion(*obj,
+                            std::integral_constant<bool, details::HasPersistentVersion<TElement>::value>{});
+                    bool needsObject{};
+                    auto id = ctx->getIdByPtr(obj, version, needsObject);
+                    details::writeSize(w, (id << 1) | (needsObject ? 1u : 0u));
+                    if (needsObject)
+                        fnc(*obj);
+                } else {
+                    details::writeSize(w, 0);
+                }
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &des, Reader &r, T &obj, Fnc &&fnc) const {
+                size_t value{};
+                details::readSize(r, value, std::numeric_limits<size_t>::max());
+                const auto id = value >> 1;
+                if (!id) {
+                    obj.reset();
+                    if (value)
+                        r.setError(ReaderError::InvalidPointer);
+                    return;
+                }
+                auto ctx = des.template context<PersistentPointerLinkingContext>();
+                assert(ctx != nullptr);
+                using TElement = typename T::element_type;
+                const void *typeTag = &details::PersistentTypeTag<TElement>::value;
+                auto stored = ctx->getObjectById(id);
+                if (stored && stored->typeTag != typeTag) {
+                    obj.reset();
+                    r.setError(ReaderError::InvalidPointer);
+                } else if (value & 1u) {
+                    //register before reading, so that cycles can reference this object
+                    if (!stored)
+                        stored = &ctx->addObject(id, std::make_shared<TElement>(), typeTag);
+                    obj = std::static_pointer_cast<TElement>(stored->obj);
+                    fnc(*obj);
+                } else if (stored) {
+                    obj = std::static_pointer_cast<TElement>(stored->obj);
+                } else {
+                    obj.reset();
+                    r.setError(ReaderError::InvalidPointer);
+                }
+            }
+        };
+
+    }
+
+    namespace traits {
+
+        template<typename T>
+        struct ExtensionTraits<ext::PersistentSharedPtr, T> {
+            using TValue = typename T::element_type;
+            static constexpr bool SupportValueOverload = true;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = true;
+        };
+
+    }
+
+}
+
+#endif //BITSERY_EXT_PERSISTENT_POINTER_H
@@ -0,0 +1,498 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_ROARING_SET_H
+#define BITSERY_EXT_ROARING_SET_H
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <vector>
+//we need this, so we could reserve for non ordered set
+#include <unordered_set>
+#include "../details/serialization_common.h"
+#include "../details/adapter_utils.h"
+
+namespace bitsery {
+
+    namespace details {
+
+        enum class RoaringChunkType : uint8_t {
+            Array,
+            Bitmap,
+            Runs
+        };
+
+        //each chunk contains values with the same upper 16 bits
+        static constexpr size_t RoaringChunkBits = 16;
+        static constexpr size_t RoaringChunkSize = 1u << RoaringChunkBits;
+        static constexpr size_t RoaringBitmapWords = RoaringChunkSize / 64;
+
+        inline size_t roaringPopcount(uint64_t v) {
+#ifdef __GNUC__
+            return static_cast<size_t>(__builtin_popcountll(v));
+#else
+            v = v - ((v >> 1) & 0x5555555555555555u);
+            v = (v & 0x3333333333333333u) + ((v >> 2) & 0x3333333333333333u);
+            v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Fu;
+            return static_cast<size_t>((v * 0x0101010101010101u) >> 56);
+#endif
+        }
+
+        inline size_t roaringLowestBit(uint64_t v) {
+#ifdef __GNUC__
+            return static_cast<size_t>(__builtin_ctzll(v));
+#else
+            size_t res{};
+            for (; !(v & 1u); v >>= 1)
+                ++res;
+            return res;
+#endif
+        }
+
+        //sets ordered by std::less iterate in ascending order, so they don't need sorting
+        template<typename T, typename = void>
+        struct IsRoaringAscending : std::false_type {
+        };
+
+        template<typename T>
+        struct IsRoaringAscending<T, typename std::enable_if<
+                std::is_same<typename T::key_compare, std::less<typename T::key_type>>::value>::type>
+                : std::true_type {
+        };
+
+        //bytes used by writeSize
+        inline size_t roaringSizeBytes(size_t size) {
+            return size < 0x80u ? 1u : size < 0x4000u ? 2u : 4u;
+        }
+
+        //decoded chunk, reused between chunks to avoid allocations
+        struct RoaringChunk {
+            RoaringChunkType type{};
+            uint16_t key{};
+            size_t cardinality{};
+            //array values, or runs as (start, length - 1) pairs
+            std::vector<uint16_t> values{};
+            //bitmap words, allocated only for bitmap chunks
+            std::vector<uint64_t> words{};
+
+            template<typename Fnc>
+            void forEach(Fnc &&fnc) const {
+                const auto base = static_cast<uint32_t>(key) << RoaringChunkBits;
+                if (type == RoaringChunkType::Array) {
+                    for (auto v: values)
+                        fnc(base | v);
+                } else if (type == RoaringChunkType::Bitmap) {
+                    for (size_t i = 0; i < RoaringBitmapWords; ++i) {
+                        for (auto w = words[i]; w; w &= w - 1)
+                            fnc(base | static_cast<uint32_t>(i * 64 + roaringLowestBit(w)));
+                    }
+                } else {
+                    for (size_t i = 0; i < values.size(); i += 2) {
+                        const uint32_t last = static_cast<uint32_t>(values[i]) + values[i + 1];
+                        for (uint32_t v = values[i]; v <= last; ++v)
+                            fnc(base | v);
+                    }
+                }
+            }
+        };
+
+        //writes chunk from sorted unique lower 16 bits of values, choosing smallest representation
+        template<typename Writer>
+        void roaringWriteChunk(Writer &writer, uint16_t key, const uint16_t *lows, size_t count, RoaringChunk &scratch) {
+            size_t runs = 1;
+            for (size_t i = 1; i < count; ++i)
+                runs += lows[i] != lows[i - 1] + 1;
+            const auto arrayBytes = roaringSizeBytes(count) + count * 2;
+            const auto bitmapBytes = RoaringBitmapWords * 8;
+            const auto runsBytes = roaringSizeBytes(runs) + runs * 4;
+
+            writer.template writeBytes<2>(key);
+            if (arrayBytes <= bitmapBytes && arrayBytes <= runsBytes) {
+                writer.template writeBytes<1>(static_cast<uint8_t>(RoaringChunkType::Array));
+                details::writeSize(writer, count);
+                writer.template writeBuffer<2, uint16_t>(lows, count);
+            } else if (runsBytes < bitmapBytes) {
+                writer.template writeBytes<1>(static_cast<uint8_t>(RoaringChunkType::Runs));
+                details::writeSize(writer, runs);
+                auto &pairs = scratch.values;
+                pairs.clear();
+                size_t start{};
+                for (size_t i = 1; i <= count; ++i) {
+                    if (i == count || lows[i] != lows[i - 1] + 1) {
+                        pairs.push_back(lows[start]);
+                        pairs.push_back(static_cast<uint16_t>(i - 1 - start));
+                        start = i;
+                    }
+                }
+                writer.template writeBuffer<2, uint16_t>(pairs.data(), pairs.size());
+            } else {
+                writer.template writeBytes<1>(static_cast<uint8_t>(RoaringChunkType::Bitmap));
+                auto &words = scratch.words;
+                words.assign(RoaringBitmapWords, uint64_t{});
+                for (size_t i = 0; i < count; ++i)
+                    words[lows[i] / 64] |= uint64_t{1} << (lows[i] % 64);
+                writer.template writeBuffer<8, uint64_t>(words.data(), words.size());
+            }
+        }
+
+        //writes chunk as it is, used when serializing RoaringBitmap
+        template<typename Writer>
+        void roaringWriteChunk(Writer &writer, const RoaringChunk &chunk) {
+            writer.template writeBytes<2>(chunk.key);
+            writer.template writeBytes<1>(static_cast<uint8_t>(chunk.type));
+            if (chunk.type == RoaringChunkType::Bitmap) {
+                writer.template writeBuffer<8, uint64_t>(chunk.words.data(), chunk.words.size());
+            } else {
+                const auto count = chunk.type == RoaringChunkType::Array ? chunk.values.size() : chunk.values.size() / 2;
+                details::writeSize(writer, count);
+                writer.template writeBuffer<2, uint16_t>(chunk.values.data(), chunk.values.size());
+            }
+        }
+
+        //reads and validates chunk, returns false if data is invalid
+        template<typename Reader>
+        bool roaringReadChunk(Reader &reader, RoaringChunk &chunk) {
+            uint8_t type{};
+            reader.template readBytes<2>(chunk.key);
+            reader.template readBytes<1>(type);
+            chunk.type = static_cast<RoaringChunkType>(type);
+            if (chunk.type == RoaringChunkType::Bitmap) {
+                chunk.words.resize(RoaringBitmapWords);
+                reader.template readBuffer<8, uint64_t>(chunk.words.data(), chunk.words.size());
+                chunk.cardinality = 0;
+                for (auto w: chunk.words)
+                    chunk.cardinality += roaringPopcount(w);
+                return chunk.cardinality > 0;
+            }
+            if (chunk.type == RoaringChunkType::Array) {
+                size_t count{};
+                details::readSize(reader, count, RoaringChunkSize);
+                chunk.values.resize(count);
+                reader.template readBuffer<2, uint16_t>(chunk.values.data(), count);
+                chunk.cardinality = count;
+                for (size_t i = 1; i < count; ++i) {
+                    if (chunk.values[i] <= chunk.values[i - 1])
+                        return false;
+                }
+                return count > 0;
+            }
+            if (chunk.type == RoaringChunkType::Runs) {
+                size_t count{};
+                details::readSize(reader, count, RoaringChunkSize / 2);
+                chunk.values.resize(count * 2);
+                reader.template readBuffer<2, uint16_t>(chunk.values.data(), count * 2);
+                chunk.cardinality = 0;
+                //runs must be ascending, not overlapping and not adjacent
+                uint32_t next{};
+                for (size_t i = 0; i < chunk.values.size(); i += 2) {
+                    const uint32_t start = chunk.values[i];
+                    const uint32_t last = start + chunk.values[i + 1];
+                    if ((i > 0 && start <= next) || last >= RoaringChunkSize)
+                        return false;
+                    next = last + 1;
+                    chunk.cardinality += last - start + 1;
+                }
+                return count > 0;
+            }
+            return false;
+        }
+    }
+
+    namespace ext {
+
+        class RoaringSet;
+
+        /*
+         * read-only set of uint32_t values stored as roaring chunks.
+         * deserializing into it doesn't expand chunks into individual values,
+         * so it is much faster than deserializing into std::set when only membership tests are required.
+         */
+        class RoaringBitmap {
+        public:
+
+            size_t size() const {
+                return _size;
+            }
+
+            bool empty() const {
+                return _size == 0;
+            }
+
+            size_t chunksCount() const {
+                return _chunks.size();
+            }
+
+            bool contains(uint32_t value) const {
+                const auto key = static_cast<uint16_t>(value >> details::RoaringChunkBits);
+                const auto low = static_cast<uint16_t>(value);
+                auto it = std::lower_bound(_chunks.begin(), _chunks.end(), key,
+                                           [](const details::RoaringChunk &c, uint16_t k) { return c.key < k; });
+                if (it == _chunks.end() || it->key != key)
+                    return false;
+                const auto &values = it->values;
+                switch (it->type) {
+                    case details::RoaringChunkType::Array:
+                        return std::binary_search(values.begin(), values.end(), low);
+                    case details::RoaringChunkType::Bitmap:
+                        return ((it->words[low / 64] >> (low % 64)) & 1u) != 0;
+                    case details::RoaringChunkType::Runs: {
+                        //find last run that starts before or at value
+                        size_t first{};
+                        size_t count = values.size() / 2;
+                        while (count > 0) {
+                            const auto step = count / 2;
+                            if (values[(first + step) * 2] <= low) {
+                                first += step + 1;
+                                count -= step + 1;
+                            } else {
+                                count = step;
+                            }
+                        }
+                        return first > 0 && low - values[(first - 1) * 2] <= values[(first - 1) * 2 + 1];
+                    }
+                }
+                return false;
+            }
+
+            //invokes fnc(uint32_t) for each value in ascending order
+            template<typename Fnc>
+            void forEach(Fnc &&fnc) const {
+                for (auto &c: _chunks)
+                    c.forEach(fnc);
+            }
+
+            void clear() {
+                _chunks.clear();
+                _size = 0;
+            }
+
+        private:
+            friend class RoaringSet;
+
+            std::vector<details::RoaringChunk> _chunks{};
+            size_t _size{};
+        };
+
+        /*
+         * writes set of unsigned integers (up to 32 bits) in roaring bitmap format:
+         * values are split into chunks by upper 16 bits, and each chunk is written as
+         * sorted array of lower 16 bits, 8KB bitmap, or runs of consecutive values, whichever is smaller.
+         * deserializes into std::set/std::unordered_set (or any set with insert(first, last)), or RoaringBitmap.
+         */
+        class RoaringSet {
+        public:
+
+            /**
+             * @param maxSize max number of values in set
+             */
+            explicit constexpr RoaringSet(size_t maxSize) : _maxSize{maxSize} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&) const {
+                using TKey = typename T::key_type;
+                static_assert(std::is_unsigned<TKey>::value && (sizeof(TKey) == 2 || sizeof(TKey) == 4),
+                              "RoaringSet only works with 16 or 32 bit unsigned integers");
+                writeSet(writer, obj, details::IsRoaringAscending<T>{});
+            }
+
+            template<typename Ser, typename Writer, typename Fnc>
+            void serialize(Ser &, Writer &writer, const RoaringBitmap &obj, Fnc &&) const {
+                assert(obj.size() <= _maxSize);
+                details::writeSize(writer, obj.size());
+                details::writeSize(writer, obj.chunksCount());
+                for (auto &c: obj._chunks)
+                    details::roaringWriteChunk(writer, c);
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&) const {
+                using TKey = typename T::key_type;
+                static_assert(std::is_unsigned<TKey>::value && (sizeof(TKey) == 2 || sizeof(TKey) == 4),
+                              "RoaringSet only works with 16 or 32 bit unsigned integers");
+                obj.clear();
+                details::RoaringChunk chunk{};
+                std::vector<TKey> values{};
+                size_t size{};
+                size_t chunks{};
+                if (!readHeader(reader, size, chunks))
+                    return;
+                reserve(obj, size);
+                size_t total{};
+                int32_t prevKey = -1;
+                for (size_t i = 0; i < chunks; ++i) {
+                    if (!readChunk(reader, chunk, prevKey, total, size))
+                        return;
+                    if (!isKeyValid(chunk.key, std::integral_constant<bool, sizeof(TKey) == 2>{})) {
+                        reader.setError(ReaderError::InvalidData);
+                        return;
+                    }
+                    values.clear();
+                    chunk.forEach([&values](uint32_t v) { values.push_back(static_cast<TKey>(v)); });
+                    //values are sorted, so ordered sets insert them in amortized constant time
+                    obj.insert(values.begin(), values.end());
+                }
+                if (total != size)
+                    reader.setError(ReaderError::InvalidData);
+            }
+
+            template<typename Des, typename Reader, typename Fnc>
+            void deserialize(Des &, Reader &reader, RoaringBitmap &obj, Fnc &&) const {
+                obj.clear();
+                size_t size{};
+                size_t chunks{};
+                if (!readHeader(reader, size, chunks))
+                    return;
+                obj._chunks.resize(chunks);
+                size_t total{};
+                int32_t prevKey = -1;
+                for (auto &c: obj._chunks) {
+                    if (!readChunk(reader, c, prevKey, total, size)) {
+                        obj.clear();
+                        return;
+                    }
+                }
+                if (total != size) {
+                    reader.setError(ReaderError::InvalidData);
+                    obj.clear();
+                    return;
+                }
+                obj._size = size;
+            }
+
+        private:
+
+            //ordered sets are written while iterating
+            template<typename Writer, typename T>
+            void writeSet(Writer &writer, const T &obj, std::true_type) const {
+                writeSorted(writer, obj.begin(), obj.end());
+            }
+
+            //other sets are copied and sorted first
+            template<typename Writer, typename T>
+            void writeSet(Writer &writer, const T &obj, std::false_type) const {
+                std::vector<typename T::key_type> values(obj.begin(), obj.end());
+                std::sort(values.begin(), values.end());
+                writeSorted(writer, values.begin(), values.end());
+            }
+
+            //writes ascending values, duplicates (e.g. from multiset) are skipped
+            template<typename Writer, typename It>
+            void writeSorted(Writer &writer, It first, It last) const {
+                //size and chunks count are written before chunks, so they are counted in first pass
+                size_t size{};
+                size_t chunks{};
+                uint32_t prev{};
+                for (auto it = first; it != last; ++it) {
+                    const auto v = static_cast<uint32_t>(*it);
+                    if (size > 0 && v == prev)
+                        continue;
+                    chunks += size == 0 || (v >> details::RoaringChunkBits) != (prev >> details::RoaringChunkBits);
+                    ++size;
+                    prev = v;
+                }
+                assert(size <= _maxSize);
+                details::writeSize(writer, size);
+                details::writeSize(writer, chunks);
+
+                details::RoaringChunk scratch{};
+                std::vector<uint16_t> lows{};
+                lows.reserve((std::min)(size, details::RoaringChunkSize));
+                uint32_t key{};
+                for (auto it = first; it != last; ++it) {
+                    const auto v = static_cast<uint32_t>(*it);
+                    const auto low = static_cast<uint16_t>(v);
+                    if (!lows.empty() && (v >> details::RoaringChunkBits) != key) {
+                        details::roaringWriteChunk(writer, static_cast<uint16_t>(key), lows.data(), lows.size(), scratch);
+                        lows.clear();
+                    }
+                    if (lows.empty())
+                        key = v >> details::RoaringChunkBits;
+                    else if (low == lows.back())
+                        continue;
+                    lows.push_back(low);
+                }
+                if (!lows.empty())
+                    details::roaringWriteChunk(writer, static_cast<uint16_t>(key), lows.data(), lows.size(), scratch);
+            }
+
+            //16bit values can only have one chunk
+            static bool isKeyValid(uint16_t key, std::true_type) {
+                return key == 0;
+            }
+
+            static bool isKeyValid(uint16_t, std::false_type) {
+                return true;
+            }
+
+            template<typename Reader>
+            bool readHeader(Reader &reader, size_t &size, size_t &chunks) const {
+                details::readSize(reader, size, _maxSize);
+                details::readSize(reader, chunks, details::RoaringChunkSize);
+                //each chunk has at least one value, check before chunks are allocated
+                if (chunks > size || (size > 0 && chunks == 0))
+                    reader.setError(ReaderError::InvalidData);
+                return reader.error() == ReaderError::NoError;
+            }
+
+            //reads chunk and checks that keys are ascending and total size is not exceeded
+            template<typename Reader>
+            bool readChunk(Reader &reader, details::RoaringChunk &chunk, int32_t &prevKey, size_t &total, size_t size) const {
+                const auto valid = details::roaringReadChunk(reader, chunk);
+                if (reader.error() != ReaderError::NoError)
+                    return false;
+                total += chunk.cardinality;
+                if (!valid || static_cast<int32_t>(chunk.key) <= prevKey || total > size) {
+                    reader.setError(ReaderError::InvalidData);
+                    return false;
+                }
+                prevKey = chunk.key;
+                return true;
+            }
+
+            template<typename T>
+            void reserve(std::unordered_set<T> &obj, size_t size) const {
+                obj.reserve(size);
+            }
+
+            template<typename T>
+            void reserve(T &, size_t) const {
+                //for ordered container do nothing
+            }
+
+            size_t _maxSize;
+        };
+    }
+
+    namespace traits {
+        template<typename T>
+        struct ExtensionTraits<ext::RoaringSet, T> {
+            using TValue = void;
+            static constexpr bool SupportValueOverload = false;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = false;
+        };
+    }
+
+}
+
+#endif //BITSERY_EXT_ROARING_SET_H
@@ -0,0 +1,354 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_RUN_LENGTH_H
+#define BITSERY_EXT_RUN_LENGTH_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include "../details/serialization_common.h"
+#include "../details/adapter_utils.h"
+
+namespace bitsery {
+
+    namespace details {
+
+        enum class RunLengthMode : uint8_t {
+            Dense,
+            Runs
+        };
+
+        //bytes used by writeSize
+        inline size_t runLengthSizeBytes(size_t size) {
+            return size < 0x80u ? 1u : size < 0x4000u ? 2u : 4u;
+        }
+
+        struct RunLengthEqual {
+            template<typename T>
+            bool operator()(const T &lhs, const T &rhs) const {
+                return lhs == rhs;
+            }
+        };
+
+        //fundamental types (except bool) are compared bitwise and written directly
+        template<typename T>
+        struct IsRunLengthBitwise : std::integral_constant<bool,
+                IsFundamentalType<T>::value && !std::is_same<T, bool>::value> {
+        };
+
+        template<typename It, typename TUnsigned>
+        TUnsigned runLengthLoad(It it) {
+            using TValue = typename std::iterator_traits<It>::value_type;
+            const TValue v = *it;
+            TUnsigned res;
+            std::memcpy(&res, &v, sizeof(TUnsigned));
+            return res;
+        }
+
+        //length of run, that starts at first element, for contiguous containers.
+        //compares 32 bytes at a time against value repeated over 64bit words, before checking element by element
+        template<typename It, typename TUnsigned>
+        size_t runLengthFind(It it, size_t count, TUnsigned value, std::true_type) {
+            constexpr size_t PerWord = sizeof(uint64_t) / sizeof(TUnsigned);
+            const auto *p = reinterpret_cast<const unsigned char *>(&(*it));
+            size_t res = 1;
+            //short runs are checked element by element, so that data without runs is scanned quickly
+            for (const auto head = (std::min)(count, PerWord); res < head; ++res) {
+                TUnsigned v;
+                std::memcpy(&v, p + res * sizeof(TUnsigned), sizeof(TUnsigned));
+                if (v != value)
+                    return res;
+            }
+            uint64_t pattern{};
+            for (size_t i = 0; i < PerWord; ++i)
+                pattern |= static_cast<uint64_t>(value) << (i * 8 * sizeof(TUnsigned) % 64);
+            for (; res + 4 * PerWord <= count; res += 4 * PerWord) {
+                uint64_t w[4];
+                std::memcpy(w, p + res * sizeof(TUnsigned), sizeof(w));
+                if (((w[0] ^ pattern) | (w[1] ^ pattern) | (w[2] ^ pattern) | (w[3] ^ pattern)) != 0)
+                    break;
+            }
+            for (; res < count; ++res) {
+                TUnsigned v;
+                std::memcpy(&v, p + res * sizeof(TUnsigned), sizeof(TUnsigned));
+                if (v != value)
+                    break;
+            }
+            return res;
+        }
+
+        template<typename It, typename TUnsigned>
+        size_t runLengthFind(It it, size_t count, TUnsigned value, std::false_type) {
+            size_t res = 1;
+            for (++it; res < count && runLengthLoad<It, TUnsigned>(it) == value; ++it)
+                ++res;
+            return res;
+        }
+
+        //copy values as unsigned integers, so that dense mode could write and read them in blocks
+        template<typename It, typename TUnsigned>
+        void runLengthLoadBlock(It it, size_t count, TUnsigned *values, std::true_type) {
+            std::memcpy(values, &(*it), count * sizeof(TUnsigned));
+        }
+
+        template<typename It, typename TUnsigned>
+        void runLengthLoadBlock(It it, size_t count, TUnsigned *values, std::false_type) {
+            for (size_t i = 0; i < count; ++i, ++it)
+                values[i] = runLengthLoad<It, TUnsigned>(it);
+        }
+
+        template<typename It, typename TUnsigned>
+        void runLengthStoreBlock(It it, size_t count, const TUnsigned *values, std::true_type) {
+            std::memcpy(&(*it), values, count * sizeof(TUnsigned));
+        }
+
+        template<typename It, typename TUnsigned>
+        void runLengthStoreBlock(It it, size_t count, const TUnsigned *values, std::false_type) {
+            using TValue = typename std::iterator_traits<It>::value_type;
+            for (size_t i = 0; i < count; ++i, ++it) {
+                TValue v;
+                std::memcpy(&v, values + i, sizeof(TUnsigned));
+                *it = v;
+            }
+        }
+    }
+
+    namespace ext {
+
+        /*
+         * writes container as runs of equal values: run length followed by value.
+         * fundamental types are compared bitwise (so -0.0 and 0.0 are different values) and written directly,
+         * use it with value overload, e.g. ext4b(obj, RunLength{maxSize}).
+         * other types are compared with TEqual, only first value of run is serialized,
+         * and deserialized value is copied to rest of the run.
+         * one byte header marks the encoding, when runs are not shorter than values alone,
+         * container is written densely (same as container) instead.
+         */
+        template<typename TEqual>
+        class BasicRunLength {
+        public:
+
+            /**
+             * @param maxSize max container size, only used for resizable containers
+             * @param equal comparator for non fundamental types
+             */
+            explicit constexpr BasicRunLength(size_t maxSize, TEqual equal = TEqual{})
+                    :_maxSize{maxSize},
+                     _equal{equal} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&fnc) const {
+                using TValue = typename traits::ContainerTraits<T>::TValue;
+                const auto size = traits::ContainerTraits<T>::size(obj);
+                assert(size <= _maxSize);
+                writeSize(writer, size, std::integral_constant<bool, traits::ContainerTraits<T>::isResizable>{});
+                serializeRuns(writer, obj, size, fnc, details::IsRunLengthBitwise<TValue>{});
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&fnc) const {
+                using TValue = typename traits::ContainerTraits<T>::TValue;
+                const auto size = readSize(reader, obj, std::integral_constant<bool, traits::ContainerTraits<T>::isResizable>{});
+                uint8_t modeByte{};
+                reader.template readBytes<1>(modeByte);
+                const auto mode = static_cast<details::RunLengthMode>(modeByte);
+                if (mode == details::RunLengthMode::Dense) {
+                    deserializeDense(reader, obj, size, fnc, details::IsRunLengthBitwise<TValue>{});
+                    return;
+                }
+                if (mode != details::RunLengthMode::Runs) {
+                    reader.setError(ReaderError::InvalidData);
+                    return;
+                }
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size;) {
+                    size_t len{};
+                    details::readSize(reader, len, size - i);
+                    if (len == 0) {
+                        //zero length is only possible when data is corrupted or reader is already in error state
+                        if (reader.error() == ReaderError::NoError)
+                            reader.setError(ReaderError::InvalidData);
+                        return;
+                    }
+                    deserializeRun(reader, it, len, fnc, details::IsRunLengthBitwise<TValue>{});
+                    i += len;
+                }
+            }
+
+        private:
+            static constexpr size_t BlockSize = 256;
+
+            template<typename Writer, typename T, typename Fnc>
+            void serializeRuns(Writer &writer, const T &obj, size_t size, Fnc &, std::true_type) const {
+                using TUnsigned = details::SameSizeUnsigned<typename traits::ContainerTraits<T>::TValue>;
+                using TContiguous = std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>;
+                //first pass stops as soon as runs take as much space as values alone
+                const auto denseBytes = size * sizeof(TUnsigned);
+                size_t runsBytes{};
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size && runsBytes < denseBytes;) {
+                    const auto value = details::runLengthLoad<decltype(it), TUnsigned>(it);
+                    const auto len = details::runLengthFind(it, size - i, value, TContiguous{});
+                    runsBytes += details::runLengthSizeBytes(len) + sizeof(TUnsigned);
+                    std::advance(it, len);
+                    i += len;
+                }
+                if (runsBytes >= denseBytes) {
+                    writer.template writeBytes<1>(static_cast<uint8_t>(details::RunLengthMode::Dense));
+                    TUnsigned values[BlockSize];
+                    it = std::begin(obj);
+                    for (size_t i = 0; i < size; i += BlockSize) {
+                        const auto n = (std::min)(size_t{BlockSize}, size - i);
+                        details::runLengthLoadBlock(it, n, values, TContiguous{});
+                        writer.template writeBuffer<sizeof(TUnsigned), TUnsigned>(values, n);
+                        std::advance(it, n);
+                    }
+                    return;
+                }
+                writer.template writeBytes<1>(static_cast<uint8_t>(details::RunLengthMode::Runs));
+                it = std::begin(obj);
+                for (size_t i = 0; i < size;) {
+                    const auto value = details::runLengthLoad<decltype(it), TUnsigned>(it);
+                    const auto len = details::runLengthFind(it, size - i, value, TContiguous{});
+                    details::writeSize(writer, len);
+                    writer.template writeBytes<sizeof(TUnsigned)>(value);
+                    std::advance(it, len);
+                    i += len;
+                }
+            }
+
+            template<typename Writer, typename T, typename Fnc>
+            void serializeRuns(Writer &writer, const T &obj, size_t size, Fnc &fnc, std::false_type) const {
+                using TValue = typename traits::ContainerTraits<T>::TValue;
+                //serialized value size is unknown, but it takes at least one byte,
+                //so runs are never larger than values alone when there are at most half as many runs as values
+                size_t runs{};
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size && runs * 2 <= size;) {
+                    auto first = it;
+                    size_t len = 1;
+                    for (++it; i + len < size && _equal(*first, *it); ++it)
+                        ++len;
+                    ++runs;
+                    i += len;
+                }
+                if (runs * 2 > size) {
+                    writer.template writeBytes<1>(static_cast<uint8_t>(details::RunLengthMode::Dense));
+                    for (auto &v: obj)
+                        fnc(const_cast<TValue &>(v));
+                    return;
+                }
+                writer.template writeBytes<1>(static_cast<uint8_t>(details::RunLengthMode::Runs));
+                it = std::begin(obj);
+                for (size_t i = 0; i < size;) {
+                    auto first = it;
+                    size_t len = 1;
+                    for (++it; i + len < size && _equal(*first, *it); ++it)
+                        ++len;
+                    details::writeSize(writer, len);
+                    fnc(const_cast<TValue &>(*first));
+                    i += len;
+                }
+            }
+
+            template<typename Reader, typename T, typename Fnc>
+            void deserializeDense(Reader &reader, T &obj, size_t size, Fnc &, std::true_type) const {
+                using TUnsigned = details::SameSizeUnsigned<typename traits::ContainerTraits<T>::TValue>;
+                using TContiguous = std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>;
+                TUnsigned values[BlockSize];
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size; i += BlockSize) {
+                    const auto n = (std::min)(size_t{BlockSize}, size - i);
+                    reader.template readBuffer<sizeof(TUnsigned), TUnsigned>(values, n);
+                    details::runLengthStoreBlock(it, n, values, TContiguous{});
+                    std::advance(it, n);
+                }
+            }
+
+            template<typename Reader, typename T, typename Fnc>
+            void deserializeDense(Reader &, T &obj, size_t, Fnc &fnc, std::false_type) const {
+                for (auto &v: obj)
+                    fnc(v);
+            }
+
+            template<typename Reader, typename It, typename Fnc>
+            void deserializeRun(Reader &reader, It &it, size_t len, Fnc &, std::true_type) const {
+                using TValue = typename std::iterator_traits<It>::value_type;
+                details::SameSizeUnsigned<TValue> bits{};
+                reader.template readBytes<sizeof(bits)>(bits);
+                TValue value;
+                std::memcpy(&value, &bits, sizeof(bits));
+                it = std::fill_n(it, len, value);
+            }
+
+            template<typename Reader, typename It, typename Fnc>
+            void deserializeRun(Reader &, It &it, size_t len, Fnc &fnc, std::false_type) const {
+                auto first = it;
+                fnc(*first);
+                it = std::fill_n(++it, len - 1, *first);
+            }
+
+            template<typename Writer>
+            void writeSize(Writer &w, size_t size, std::true_type) const {
+                details::writeSize(w, size);
+            }
+
+            template<typename Writer>
+            void writeSize(Writer &, size_t, std::false_type) const {
+            }
+
+            template<typename Reader, typename T>
+            size_t readSize(Reader &r, T &obj, std::true_type) const {
+                size_t size{};
+                details::readSize(r, size, _maxSize);
+                traits::ContainerTraits<T>::resize(obj, size);
+                return size;
+            }
+
+            template<typename Reader, typename T>
+            size_t readSize(Reader &, T &obj, std::false_type) const {
+                return traits::ContainerTraits<T>::size(obj);
+            }
+
+            size_t _maxSize;
+            TEqual _equal;
+        };
+
+        using RunLength = BasicRunLength<details::RunLengthEqual>;
+
+    }
+
+    namespace traits {
+        template<typename TEqual, typename T>
+        struct ExtensionTraits<ext::BasicRunLength<TEqual>, T> {
+            using TValue = typename ContainerTraits<T>::TValue;
+            static constexpr bool SupportValueOverload = true;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = true;
+        };
+    }
+
+}
+
+#endif //BITSERY_EXT_RUN_LENGTH_H
@@ -0,0 +1,398 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_SPARSE_H
+#define BITSERY_EXT_SPARSE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iterator>
+#include "../details/serialization_common.h"
+#include "../details/adapter_utils.h"
+
+namespace bitsery {
+
+    namespace details {
+
+        enum class SparseMode : uint8_t {
+            Dense,
+            Bitmap,
+            Indices
+        };
+
+        //bytes used by writeSize
+        inline size_t sparseSizeBytes(size_t size) {
+            return size < 0x80u ? 1u : size < 0x4000u ? 2u : 4u;
+        }
+
+        //copy values as unsigned integers, so that default values could be found by testing bits
+        template<typename It, typename TUnsigned>
+        void sparseLoad(It it, size_t count, TUnsigned *values, std::true_type) {
+            std::memcpy(values, &(*it), count * sizeof(TUnsigned));
+        }
+
+        template<typename It, typename TUnsigned>
+        void sparseLoad(It it, size_t count, TUnsigned *values, std::false_type) {
+            using TValue = typename std::iterator_traits<It>::value_type;
+            for (size_t i = 0; i < count; ++i, ++it) {
+                const TValue v = *it;
+                std::memcpy(values + i, &v, sizeof(TUnsigned));
+            }
+        }
+
+        template<typename It, typename TUnsigned>
+        void sparseStore(It it, size_t count, const TUnsigned *values, std::true_type) {
+            std::memcpy(&(*it), values, count * sizeof(TUnsigned));
+        }
+
+        template<typename It, typename TUnsigned>
+        void sparseStore(It it, size_t count, const TUnsigned *values, std::false_type) {
+            using TValue = typename std::iterator_traits<It>::value_type;
+            for (size_t i = 0; i < count; ++i, ++it) {
+                TValue v;
+                std::memcpy(&v, values + i, sizeof(TUnsigned));
+                *it = v;
+            }
+        }
+
+        //stores single value at index, contiguous containers are written directly without advancing iterator
+        template<typename It, typename TUnsigned>
+        void sparseStoreAt(It begin, It &, size_t &, size_t idx, const TUnsigned *value, std::true_type) {
+            std::memcpy(&(*begin) + idx, value, sizeof(TUnsigned));
+        }
+
+        template<typename It, typename TUnsigned>
+        void sparseStoreAt(It, It &it, size_t &pos, size_t idx, const TUnsigned *value, std::false_type) {
+            std::advance(it, idx - pos);
+            pos = idx;
+            sparseStore(it, 1, value, std::false_type{});
+        }
+
+        //count is compile time constant, so that compiler could vectorize the loop
+        template<size_t Count, typename TUnsigned>
+        size_t sparseCountNonDefault(const TUnsigned *values) {
+            size_t res{};
+            for (size_t i = 0; i < Count; ++i)
+                res += values[i] != 0;
+            return res;
+        }
+
+        //writes positions of non-default values (not all bits zero) and returns their count.
+        //values are tested by 8 bytes at a time, so long runs of defaults are skipped quickly
+        template<size_t Count, typename TUnsigned>
+        size_t sparseFindNonDefault(const TUnsigned *values, uint16_t *positions) {
+            constexpr size_t PerWord = sizeof(uint64_t) / sizeof(TUnsigned);
+            static_assert(Count % PerWord == 0, "");
+            size_t res{};
+            for (size_t i = 0; i < Count; i += PerWord) {
+                uint64_t word;
+                std::memcpy(&word, values + i, sizeof(word));
+                if (word) {
+                    for (size_t j = i; j < i + PerWord; ++j) {
+                        positions[res] = static_cast<uint16_t>(j);
+                        res += values[j] != 0;
+                    }
+                }
+            }
+            return res;
+        }
+    }
+
+    namespace ext {
+
+        /*
+         * writes container of fundamental types, where most values are default (all bits zero).
+         * for each container chooses cheapest of three encodings, marked by one byte header:
+         * * dense - same as container, used when there is not enough defaults;
+         * * bitmap - presence bit for each element, followed by non-default values;
+         * * indices - count of non-default values and delta-coded index/value pairs.
+         * values are compared bitwise, so -0.0 is not considered default and is preserved.
+         */
+        class Sparse {
+        public:
+
+            /**
+             * @param maxSize max container size, only used for resizable containers
+             */
+            explicit constexpr Sparse(size_t maxSize) : _maxSize{maxSize} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&) const {
+                using TUnsigned = CheckedUnsigned<typename traits::ContainerTraits<T>::TValue>;
+                using TContiguous = std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>;
+                const auto size = traits::ContainerTraits<T>::size(obj);
+                assert(size <= _maxSize);
+                writeSize(writer, size, std::integral_constant<bool, traits::ContainerTraits<T>::isResizable>{});
+
+                TUnsigned values[BlockSize];
+                uint16_t positions[BlockSize];
+                //first pass counts non-default values
+                size_t nonDefault{};
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size; i += BlockSize) {
+                    const auto n = (std::min)(size_t{BlockSize}, size - i);
+                    loadBlock(it, n, values, TContiguous{});
+                    nonDefault += details::sparseCountNonDefault<BlockSize>(values);
+                    std::advance(it, n);
+                }
+
+                const auto valuesBytes = nonDefault * sizeof(TUnsigned);
+                const auto denseBytes = size * sizeof(TUnsigned);
+                const auto bitmapBytes = (size + 7) / 8 + valuesBytes;
+                //each delta takes at least one byte, so exact size is only calculated when indices might be cheaper
+                auto indicesBytes = details::sparseSizeBytes(nonDefault) + nonDefault + valuesBytes;
+                size_t next{};
+                if (indicesBytes < bitmapBytes) {
+                    indicesBytes -= nonDefault;
+                    it = std::begin(obj);
+                    for (size_t i = 0; i < size; i += BlockSize) {
+                        const auto n = (std::min)(size_t{BlockSize}, size - i);
+                        loadBlock(it, n, values, TContiguous{});
+                        const auto k = details::sparseFindNonDefault<BlockSize>(values, positions);
+                        for (size_t j = 0; j < k; ++j) {
+                            indicesBytes += details::sparseSizeBytes(i + positions[j] - next);
+                            next = i + positions[j] + 1;
+                        }
+                        std::advance(it, n);
+                    }
+                }
+                auto mode = details::SparseMode::Dense;
+                if (bitmapBytes < denseBytes && bitmapBytes <= indicesBytes)
+                    mode = details::SparseMode::Bitmap;
+                else if (indicesBytes < denseBytes)
+                    mode = details::SparseMode::Indices;
+                writer.template writeBytes<1>(static_cast<uint8_t>(mode));
+                if (mode == details::SparseMode::Indices)
+                    details::writeSize(writer, nonDefault);
+
+                uint8_t bitmap[BlockSize / 8];
+                size_t deltas[BlockSize];
+                TUnsigned packed[BlockSize];
+                size_t packedCount{};
+                next = 0;
+                it = std::begin(obj);
+                for (size_t i = 0; i < size; i += BlockSize) {
+                    const auto n = (std::min)(size_t{BlockSize}, size - i);
+                    loadBlock(it, n, values, TContiguous{});
+                    std::advance(it, n);
+                    if (mode == details::SparseMode::Dense) {
+                        writer.template writeBuffer<sizeof(TUnsigned), TUnsigned>(values, n);
+                        continue;
+                    }
+                    if (mode == details::SparseMode::Bitmap) {
+                        for (size_t j = 0; j < BlockSize / 8; ++j) {
+                            uint8_t byte{};
+                            for (size_t b = 0; b < 8; ++b)
+                                byte = static_cast<uint8_t>(byte | (values[j * 8 + b] != 0) << b);
+                            bitmap[j] = byte;
+                        }
+                        size_t k{};
+                        for (size_t j = 0; j < n; ++j) {
+                            packed[k] = values[j];
+                            k += values[j] != 0;
+                        }
+                        writer.template writeBuffer<1, uint8_t>(bitmap, (n + 7) / 8);
+                        writer.template writeBuffer<sizeof(TUnsigned), TUnsigned>(packed, k);
+                        continue;
+                    }
+                    const auto k = details::sparseFindNonDefault<BlockSize>(values, positions);
+                    //indices are written in groups of BlockSize entries: deltas first, then values
+                    for (size_t j = 0; j < k; ++j) {
+                        deltas[packedCount] = i + positions[j] - next;
+                        next = i + positions[j] + 1;
+                        packed[packedCount++] = values[positions[j]];
+                        if (packedCount == BlockSize) {
+                            writeIndices(writer, deltas, packed, packedCount);
+                            packedCount = 0;
+                        }
+                    }
+                }
+                if (packedCount)
+                    writeIndices(writer, deltas, packed, packedCount);
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&) const {
+                using TValue = typename traits::ContainerTraits<T>::TValue;
+                using TUnsigned = CheckedUnsigned<TValue>;
+                using TContiguous = std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>;
+                const auto size = readSize(reader, obj, std::integral_constant<bool, traits::ContainerTraits<T>::isResizable>{});
+                uint8_t modeByte{};
+                reader.template readBytes<1>(modeByte);
+                const auto mode = static_cast<details::SparseMode>(modeByte);
+
+                TUnsigned values[BlockSize];
+                auto it = std::begin(obj);
+                if (mode == details::SparseMode::Dense) {
+                    for (size_t i = 0; i < size; i += BlockSize) {
+                        const auto n = (std::min)(size_t{BlockSize}, size - i);
+                        reader.template readBuffer<sizeof(TUnsigned), TUnsigned>(values, n);
+                        details::sparseStore(it, n, values, TContiguous{});
+                        std::advance(it, n);
+                    }
+                } else if (mode == details::SparseMode::Bitmap) {
+                    readBitmap(reader, it, std::end(obj), size, values, TContiguous{});
+                } else if (mode == details::SparseMode::Indices) {
+                    //defaults are filled in bulk, and only non-default values are stored afterwards
+                    std::fill(it, std::end(obj), TValue{});
+                    readIndices(reader, it, size, values, TContiguous{});
+                } else {
+                    reader.setError(ReaderError::InvalidData);
+                }
+            }
+
+        private:
+            static constexpr size_t BlockSize = 256;
+
+            template<typename TValue>
+            using CheckedUnsigned = typename std::enable_if<
+                    details::IsFundamentalType<TValue>::value && !std::is_same<TValue, bool>::value,
+                    details::SameSizeUnsigned<TValue>>::type;
+
+            //last block is padded with defaults, so that whole block could be scanned
+            template<typename It, typename TUnsigned, typename TContiguous>
+            void loadBlock(It it, size_t count, TUnsigned *values, TContiguous) const {
+                details::sparseLoad(it, count, values, TContiguous{});
+                std::fill(values + count, values + BlockSize, TUnsigned{});
+            }
+
+            template<typename Writer, typename TUnsigned>
+            void writeIndices(Writer &writer, const size_t *deltas, const TUnsigned *values, size_t count) const {
+                for (size_t i = 0; i < count; ++i)
+                    details::writeSize(writer, deltas[i]);
+                writer.template writeBuffer<sizeof(TUnsigned), TUnsigned>(values, count);
+            }
+
+            //each block is expanded to dense values and stored at once, same as dense mode
+            template<typename Reader, typename It, typename TUnsigned, typename TContiguous>
+            void readBitmap(Reader &reader, It it, It end, size_t size, TUnsigned *values, TContiguous) const {
+                uint8_t bitmap[BlockSize / 8];
+                TUnsigned expanded[BlockSize];
+                for (size_t i = 0; i < size; i += BlockSize) {
+                    const auto n = (std::min)(size_t{BlockSize}, size - i);
+                    const auto bytes = (n + 7) / 8;
+                    reader.template readBuffer<1, uint8_t>(bitmap, bytes);
+                    //unused bits in last byte must be zero
+                    if (n % 8 && (bitmap[bytes - 1] >> (n % 8))) {
+                        //remaining values are deserialized as defaults
+                        reader.setError(ReaderError::InvalidData);
+                        std::fill(it, end, typename std::iterator_traits<It>::value_type{});
+                        return;
+                    }
+                    size_t k{};
+                    for (size_t j = 0; j < bytes; ++j)
+                        k += bitsCount(bitmap[j]);
+                    reader.template readBuffer<sizeof(TUnsigned), TUnsigned>(values, k);
+                    std::fill(expanded, expanded + n, TUnsigned{});
+                    k = 0;
+                    for (size_t j = 0; j < bytes; ++j) {
+                        for (unsigned b = bitmap[j]; b; b &= b - 1)
+                            expanded[j * 8 + lowestBit(b)] = values[k++];
+                    }
+                    details::sparseStore(it, n, expanded, TContiguous{});
+                    std::advance(it, n);
+                }
+            }
+
+            template<typename Reader, typename It, typename TUnsigned, typename TContiguous>
+            void readIndices(Reader &reader, It it, size_t size, TUnsigned *values, TContiguous) const {
+                const auto begin = it;
+                size_t nonDefault{};
+                details::readSize(reader, nonDefault, size);
+                size_t indices[BlockSize];
+                size_t next{};
+                size_t pos{};
+                for (size_t i = 0; i < nonDefault; i += BlockSize) {
+                    const auto k = (std::min)(size_t{BlockSize}, nonDefault - i);
+                    for (size_t j = 0; j < k; ++j) {
+                        size_t delta{};
+                        details::readSize(reader, delta, size);
+                        next += delta + 1;
+                        if (next > size) {
+                            reader.setError(ReaderError::InvalidData);
+                            return;
+                        }
+                        indices[j] = next - 1;
+                    }
+                    reader.template readBuffer<sizeof(TUnsigned), TUnsigned>(values, k);
+                    for (size_t j = 0; j < k; ++j)
+                        details::sparseStoreAt(begin, it, pos, indices[j], values + j, TContiguous{});
+                }
+            }
+
+            static size_t bitsCount(uint8_t v) {
+                unsigned x = v;
+                x = x - ((x >> 1) & 0x55u);
+                x = (x & 0x33u) + ((x >> 2) & 0x33u);
+                return (x + (x >> 4)) & 0x0Fu;
+            }
+
+            static size_t lowestBit(unsigned v) {
+#ifdef __GNUC__
+                return static_cast<size_t>(__builtin_ctz(v));
+#else
+                //index of lowest set bit is count of bits below it
+                return bitsCount(static_cast<uint8_t>((v & (0u - v)) - 1u));
+#endif
+            }
+
+            template<typename Writer>
+            void writeSize(Writer &w, size_t size, std::true_type) const {
+                details::writeSize(w, size);
+            }
+
+            template<typename Writer>
+            void writeSize(Writer &, size_t, std::false_type) const {
+            }
+
+            template<typename Reader, typename T>
+            size_t readSize(Reader &r, T &obj, std::true_type) const {
+                size_t size{};
+                details::readSize(r, size, _maxSize);
+                traits::ContainerTraits<T>::resize(obj, size);
+                return size;
+            }
+
+            template<typename Reader, typename T>
+            size_t readSize(Reader &, T &obj, std::false_type) const {
+                return traits::ContainerTraits<T>::size(obj);
+            }
+
+            size_t _maxSize;
+        };
+
+    }
+
+    namespace traits {
+        template<typename T>
+        struct ExtensionTraits<ext::Sparse, T> {
+            using TValue = void;
+            static constexpr bool SupportValueOverload = false;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = false;
+        };
+    }
+
+}
+
+#endif //BITSERY_EXT_SPARSE_H
@@ -0,0 +1,261 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_STREAMING_RANGE_H
+#define BITSERY_EXT_STREAMING_RANGE_H
+
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "../traits/core/traits.h"
+#include "../details/adapter_utils.h"
+#include "../details/serialization_common.h"
+
+namespace bitsery {
+    namespace ext {
+
+        /*
+         * serialize range of unknown length (e.g. database cursor, generator) without materializing it.
+         * elements are written in chunks, each chunk is prefixed with its size, and zero size chunk marks the end.
+         * serialization accepts anything that has begin/end iterators:
+         *  * forward iterators are iterated twice, first to count chunk size, then to write elements.
+         *  * input iterators are single pass, so up to maxChunkSize elements are copied to temporary buffer.
+         * deserialization replaces content of resizable container (ContainerTraits),
+         * or use StreamingRangeReader to read elements lazily as input range.
+         */
+        class StreamingRange {
+        public:
+
+            constexpr explicit StreamingRange(size_t maxChunkSize, size_t maxSize = std::numeric_limits<size_t>::max())
+                    :_maxChunkSize{maxChunkSize}, _maxSize{maxSize} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&fnc) const {
+                assert(_maxChunkSize > 0);
+                //generator ranges might not be iterable when const
+                auto &range = const_cast<T &>(obj);
+                auto first = std::begin(range);
+                auto last = std::end(range);
+                using TIt = decltype(first);
+                writeChunks(writer, first, last, fnc, typename std::iterator_traits<TIt>::iterator_category{});
+                details::writeSize(writer, 0);
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&fnc) const {
+                static_assert(traits::ContainerTraits<T>::isResizable, "streaming range can only be deserialized to resizable container");
+                size_t total{};
+                traits::ContainerTraits<T>::resize(obj, 0);
+                for (;;) {
+                    size_t size{};
+                    details::readSize(reader, size, _maxChunkSize);
+                    if (size == 0)
+                        break;
+                    if (size > _maxSize - total) {
+                        reader.setError(ReaderError::InvalidData);
+                        break;
+                    }
+                    traits::ContainerTraits<T>::resize(obj, total + size);
+                    auto it = std::next(std::begin(obj), static_cast<typename std::iterator_traits<decltype(std::begin(obj))>::difference_type>(total));
+                    for (auto end = std::end(obj); it != end; ++it)
+                        fnc(*it);
+                    total += size;
+                    if (reader.error() != ReaderError::NoError)
+                        break;
+                }
+            }
+
+            size_t maxChunkSize() const {
+                return _maxChunkSize;
+            }
+
+            size_t maxSize() const {
+                return _maxSize;
+            }
+
+        private:
+
+            template <typename Writer, typename It, typename Fnc>
+            void writeChunks(Writer &writer, It first, It last, Fnc &fnc, std::forward_iterator_tag) const {
+                size_t total{};
+                while (first != last) {
+                    auto chunkBegin = first;
+                    size_t size{};
+                    for (; first != last && size < _maxChunkSize; ++first)
+                        ++size;
+                    total += size;
+                    assert(total <= _maxSize);
+                    details::writeSize(writer, size);
+                    for (; chunkBegin != first; ++chunkBegin)
+                        fnc(const_cast<typename std::iterator_traits<It>::value_type &>(*chunkBegin));
+                }
+            }
+
+            template <typename Writer, typename It, typename Fnc>
+            void writeChunks(Writer &writer, It first, It last, Fnc &fnc, std::input_iterator_tag) const {
+                std::vector<typename std::iterator_traits<It>::value_type> chunk{};
+                chunk.reserve(_maxChunkSize);
+                size_t total{};
+                while (first != last) {
+                    chunk.clear();
+                    for (; first != last && chunk.size() < _maxChunkSize; ++first)
+                        chunk.push_back(*first);
+                    total += chunk.size();
+                    assert(total <= _maxSize);
+                    details::writeSize(writer, chunk.size());
+                    for (auto &v: chunk)
+                        fnc(v);
+                }
+            }
+
+            size_t _maxChunkSize;
+            size_t _maxSize;
+        };
+
+        /*
+         * reads elements written by StreamingRange lazily, as single pass input range.
+         * only one element is stored at a time, fnc is called to deserialize each element.
+         * iteration stops at the end of range, or when deserializer is in error state.
+         */
+        template<typename TValue, typename Des, typename Fnc>
+        class StreamingRangeReader {
+        public:
+
+            class Iterator {
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = TValue;
+                using difference_type = std::ptrdiff_t;
+                using pointer = TValue*;
+                using reference = TValue&;
+
+                explicit Iterator(StreamingRangeReader* reader = nullptr):_reader{reader} {}
+
+                reference operator*() const {
+                    return _reader->_value;
+                }
+
+                pointer operator->() const {
+                    return &_reader->_value;
+                }
+
+                Iterator& operator++() {
+                    if (!_reader->next())
+                        _reader = nullptr;
+                    return *this;
+                }
+
+                Iterator operator++(int) {
+                    auto tmp = *this;
+                    ++*this;
+                    return tmp;
+                }
+
+                bool operator==(const Iterator& other) const {
+                    return _reader == other._reader;
+                }
+
+                bool operator!=(const Iterator& other) const {
+                    return _reader != other._reader;
+                }
+
+            private:
+                StreamingRangeReader* _reader;
+            };
+
+            StreamingRangeReader(Des& des, const StreamingRange& range, Fnc fnc)
+                    :_des{des}, _fnc{std::move(fnc)}, _maxChunkSize{range.maxChunkSize()}, _maxSize{range.maxSize()} {}
+
+            //single pass, should be called only once
+            Iterator begin() {
+                return Iterator{next() ? this : nullptr};
+            }
+
+            Iterator end() {
+                return Iterator{};
+            }
+
+            //number of elements read so far
+            size_t count() const {
+                return _count;
+            }
+
+        private:
+
+            bool next() {
+                auto& reader = AdapterAccess::getReader(_des);
+                if (_remaining == 0) {
+                    if (_done)
+                        return false;
+                    details::readSize(reader, _remaining, _maxChunkSize);
+                    if (_remaining > _maxSize - _count)
+                        reader.setError(ReaderError::InvalidData);
+                    if (_remaining == 0 || reader.error() != ReaderError::NoError) {
+                        _done = true;
+                        return false;
+                    }
+                }
+                --_remaining;
+                ++_count;
+                _value = TValue{};
+                _fnc(_value);
+                if (reader.error() != ReaderError::NoError) {
+                    _remaining = 0;
+                    _done = true;
+                    return false;
+                }
+                return true;
+            }
+
+            Des& _des;
+            Fnc _fnc;
+            size_t _maxChunkSize;
+            size_t _maxSize;
+            size_t _remaining{};
+            size_t _count{};
+            bool _done{};
+            TValue _value{};
+        };
+
+        template<typename TValue, typename Des, typename Fnc>
+        StreamingRangeReader<TValue, Des, typename std::decay<Fnc>::type> readStreamingRange(
+                Des& des, const StreamingRange& range, Fnc&& fnc) {
+            return {des, range, std::forward<Fnc>(fnc)};
+        }
+    }
+
+    namespace traits {
+        template<typename T>
+        struct ExtensionTraits<ext::StreamingRange, T> {
+            using TValue = typename std::iterator_traits<decltype(std::begin(std::declval<T&>()))>::value_type;
+            static constexpr bool SupportValueOverload = true;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = true;
+        };
+    }
+
+}
+
+
+#endif //BITSERY_EXT_STREAMING_RANGE_H
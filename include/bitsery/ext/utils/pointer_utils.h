@@ -23,11 +23,12 @@
 #ifndef BITSERY_POINTER_UTILS_H
 #define BITSERY_POINTER_UTILS_H
 
-#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <limits>
 #include "../../details/adapter_utils.h"
 
 namespace bitsery {
@@ -131,9 +132,10 @@ namespace bitsery {
 
             class PointerLinkingContextSerialization {
             public:
-                explicit PointerLinkingContextSerialization()
+                PointerLinkingContextSerialization()
                         : _currId{0},
-                          _ptrMap{} {}
+                          _size{0},
+                          _slots{} {}
 
                 PointerLinkingContextSerialization(const PointerLinkingContextSerialization &) = delete;
 
@@ -145,37 +147,82 @@ namespace bitsery {
 
                 ~PointerLinkingContextSerialization() = default;
 
+                //returned reference is only valid until next call
                 const PLCInfoSerializer &getInfoByPtr(const void *ptr, PointerOwnershipType ptrType) {
-                    auto res = _ptrMap.emplace(ptr, PLCInfoSerializer{_currId + 1u, ptrType});
-                    auto &ptrInfo = res.first->second;
-                    if (res.second) {
+                    assert(ptr != nullptr);
+                    if ((_size + 1) * 2 > _slots.size())
+                        grow();
+                    auto &slot = findSlot(_slots, ptr);
+                    if (slot.ptr == nullptr) {
                         ++_currId;
-                        return ptrInfo;
-                    }
-                    updatePLCInfo(ptrInfo, ptrType);
-                    return ptrInfo;
+                        ++_size;
+                        slot.ptr = ptr;
+                        slot.info = PLCInfoSerializer{_currId, ptrType};
+                    } else
+                        updatePLCInfo(slot.info, ptrType);
+                    return slot.info;
+                }
+
+                //clear linked pointers, allocated memory is kept
+                void reset() {
+                    _currId = 0;
+                    _size = 0;
+                    for (auto &slot: _slots)
+                        slot.ptr = nullptr;
                 }
 
                 //valid, when all pointers have owners.
                 //we cannot serialize pointers, if we haven't serialized objects themselves
                 bool isPointerSerializationValid() const {
-                    return std::all_of(_ptrMap.begin(), _ptrMap.end(),
-                                       [](const std::pair<const void *, PLCInfoSerializer> &p) {
-                                           return p.second.ownershipType == PointerOwnershipType::SharedOwner ||
-                                                  p.second.ownershipType == PointerOwnershipType::Owner;
+                    return std::all_of(_slots.begin(), _slots.end(),
+                                       [](const Slot &s) {
+                                           return s.ptr == nullptr ||
+                                                  s.info.ownershipType == PointerOwnershipType::SharedOwner ||
+                                                  s.info.ownershipType == PointerOwnershipType::Owner;
                                        });
                 }
 
             private:
+                //open addressing table, unlike node based map it keeps its memory on reset,
+                //so reused context doesn't allocate after warm-up
+                struct Slot {
+                    const void *ptr;
+                    PLCInfoSerializer info;
+                };
+
+                static Slot &findSlot(std::vector<Slot> &slots, const void *ptr) {
+                    const auto mask = slots.size() - 1;
+                    //fibonacci hashing, low bits of pointers are always zero because of alignment
+                    auto pos = static_cast<size_t>((static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr))
+                                                    * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+                    while (slots[pos].ptr != nullptr && slots[pos].ptr != ptr)
+                        pos = (pos + 1) & mask;
+                    return slots[pos];
+                }
+
+                void grow() {
+                    std::vector<Slot> slots((std::max)(_slots.size() * 2, size_t{16}),
+                                            Slot{nullptr, PLCInfoSerializer{0, PointerOwnershipType::Observer}});
+                    for (auto &slot: _slots) {
+                        if (slot.ptr != nullptr)
+                            findSlot(slots, slot.ptr) = slot;
+                    }
+                    _slots.swap(slots);
+                }
+
                 size_t _currId;
-                std::unordered_map<const void *, PLCInfoSerializer> _ptrMap;
+                size_t _size;
+                std::vector<Slot> _slots;
 
             };
 
             class PointerLinkingContextDeserialization {
             public:
-                explicit PointerLinkingContextDeserialization()
-                        : _idMap{} {}
+                PointerLinkingContextDeserialization()
+                        : _size{0},
+                          _usedBlocks{0},
+                          _slots{},
+                          _blocks{} {}
 
                 PointerLinkingContextDeserialization(const PointerLinkingContextDeserialization &) = delete;
 
@@ -187,30 +234,97 @@ namespace bitsery {
 
                 ~PointerLinkingContextDeserialization() = default;
 
+                //returned reference stays valid until reset, while nested pointers are deserialized
                 PLCInfoDeserializer &getInfoById(size_t id, PointerOwnershipType ptrType) {
-                    auto res = _idMap.emplace(id, PLCInfoDeserializer{nullptr, ptrType});
-                    auto &ptrInfo = res.first->second;
-                    if (!res.second)
-                        updatePLCInfo(ptrInfo, ptrType);
-                    return ptrInfo;
+                    assert(id != 0);
+                    if ((_size + 1) * 2 > _slots.size())
+                        grow();
+                    auto &slot = findSlot(_slots, id);
+                    if (slot.id == 0) {
+                        ++_size;
+                        slot.id = id;
+                        slot.info = &createInfo(ptrType);
+                    } else
+                        updatePLCInfo(*slot.info, ptrType);
+                    return *slot.info;
                 }
 
                 void clearSharedState() {
-                    for (auto &item: _idMap)
-                        item.second.sharedState.reset();
+                    for (auto i = 0u; i < _usedBlocks; ++i) {
+                        for (auto &info: _blocks[i])
+                            info.sharedState.reset();
+                    }
+                }
+
+                //clear linked pointers, allocated memory is kept
+                void reset() {
+                    _size = 0;
+                    for (auto &slot: _slots)
+                        slot.id = 0;
+                    for (auto i = 0u; i < _usedBlocks; ++i)
+                        _blocks[i].clear();
+                    _usedBlocks = 0;
                 }
 
                 //valid, when all pointers has owners
                 bool isPointerDeserializationValid() const {
-                    return std::all_of(_idMap.begin(), _idMap.end(),
-                                       [](const std::pair<const size_t, PLCInfoDeserializer> &p) {
-                                           return p.second.ownershipType == PointerOwnershipType::SharedOwner ||
-                                                  p.second.ownershipType == PointerOwnershipType::Owner;
-                                       });
+                    for (auto i = 0u; i < _usedBlocks; ++i) {
+                        auto valid = std::all_of(_blocks[i].begin(), _blocks[i].end(),
+                                                 [](const PLCInfoDeserializer &info) {
+                                                     return info.ownershipType == PointerOwnershipType::SharedOwner ||
+                                                            info.ownershipType == PointerOwnershipType::Owner;
+                                                 });
+                        if (!valid)
+                            return false;
+                    }
+                    return true;
                 }
 
             private:
-                std::unordered_map<size_t, PLCInfoDeserializer> _idMap;
+                //ids are looked up in open addressing table, same as on serialization side,
+                //and infos are stored in blocks that never reallocate, so references to them stay valid,
+                //on reset blocks are cleared but keep their capacity, so reused context doesn't allocate after warm-up
+                struct Slot {
+                    size_t id;
+                    PLCInfoDeserializer* info;
+                };
+
+                static Slot &findSlot(std::vector<Slot> &slots, size_t id) {
+                    const auto mask = slots.size() - 1;
+                    auto pos = static_cast<size_t>((static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+                    while (slots[pos].id != 0 && slots[pos].id != id)
+                        pos = (pos + 1) & mask;
+                    return slots[pos];
+                }
+
+                void grow() {
+                    std::vector<Slot> slots((std::max)(_slots.size() * 2, size_t{16}), Slot{0, nullptr});
+                    for (auto &slot: _slots) {
+                        if (slot.id != 0)
+                            findSlot(slots, slot.id) = slot;
+                    }
+                    _slots.swap(slots);
+                }
+
+                PLCInfoDeserializer &createInfo(PointerOwnershipType ptrType) {
+                    if (_usedBlocks == 0 || _blocks[_usedBlocks - 1].size() == _blocks[_usedBlocks - 1].capacity()) {
+                        if (_usedBlocks == _blocks.size()) {
+                            //each new block is twice as big as previous
+                            std::vector<PLCInfoDeserializer> block{};
+                            block.reserve(_blocks.empty() ? size_t{16} : _blocks.back().capacity() * 2);
+                            _blocks.push_back(std::move(block));
+                        }
+                        ++_usedBlocks;
+                    }
+                    auto &block = _blocks[_usedBlocks - 1];
+                    block.emplace_back(nullptr, ptrType);
+                    return block.back();
+                }
+
+                size_t _size;
+                size_t _usedBlocks;
+                std::vector<Slot> _slots;
+                std::vector<std::vector<PLCInfoDeserializer>> _blocks;
             };
 
             template<template<typename> class TPtrManager,
@@ -377,6 +491,11 @@ namespace bitsery {
             bool isValid() {
                 return isPointerSerializationValid() && isPointerDeserializationValid();
             }
+
+            void reset() {
+                PointerLinkingContextSerialization::reset();
+                PointerLinkingContextDeserialization::reset();
+            }
         };
 
     }
@@ -25,6 +25,7 @@
 
 #include <unordered_map>
 #include <memory>
+#include <limits>
 #include "../../details/adapter_common.h"
 
 namespace bitsery {
@@ -0,0 +1,289 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_EXT_VALUE_RANGE_CONTAINER_H
+#define BITSERY_EXT_VALUE_RANGE_CONTAINER_H
+
+#include "value_range.h"
+#include "../details/adapter_utils.h"
+#include <algorithm>
+#include <iterator>
+
+namespace bitsery {
+
+    namespace details {
+
+        //converts values to range codes and back for a block of values.
+        //all work is done in simple loops without branches and divisions, so that compiler could vectorize them.
+        template<typename T, typename Enable = void>
+        struct BulkRangeQuantizer {
+            using TCode = SameSizeUnsigned<T>;
+            using TIntegral = typename IntegralFromFundamental<T>::TValue;
+
+            explicit BulkRangeQuantizer(const RangeSpec<T> &r)
+                    : _min{static_cast<TCode>(static_cast<TIntegral>(r.min))},
+                      _maxCode{static_cast<TCode>(static_cast<TCode>(static_cast<TIntegral>(r.max)) - _min)} {
+            }
+
+            template<typename It>
+            void toCodes(It first, TCode *codes, size_t count) const {
+                for (size_t i = 0; i < count; ++i, ++first)
+                    codes[i] = static_cast<TCode>(static_cast<TCode>(static_cast<TIntegral>(*first)) - _min);
+            }
+
+            //returns false if at least one code is out of range
+            bool isValid(const TCode *codes, size_t count) const {
+                bool valid = true;
+                for (size_t i = 0; i < count; ++i)
+                    valid &= codes[i] <= _maxCode;
+                return valid;
+            }
+
+            template<typename It>
+            void fromCodes(const TCode *codes, It first, size_t count) const {
+                for (size_t i = 0; i < count; ++i, ++first)
+                    *first = static_cast<T>(static_cast<TIntegral>(static_cast<TCode>(codes[i] + _min)));
+            }
+
+        private:
+            TCode _min;
+            TCode _maxCode;
+        };
+
+        template<typename T>
+        struct BulkRangeQuantizer<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+            using TCode = SameSizeUnsigned<T>;
+
+            //instead of dividing each value by range, precompute scale factors once
+            explicit BulkRangeQuantizer(const RangeSpec<T> &r)
+                    : _min{r.min},
+                      _max{r.max},
+                      _maxCode{(static_cast<TCode>(1) << r.bitsRequired) - 1},
+                      _toCodeScale{static_cast<T>(_maxCode) / (r.max - r.min)},
+                      _fromCodeScale{(r.max - r.min) / static_cast<T>(_maxCode)} {
+            }
+
+            template<typename It>
+            void toCodes(It first, TCode *codes, size_t count) const {
+                for (size_t i = 0; i < count; ++i, ++first) {
+                    //multiplication by reciprocal might round up for max value, so clamp to max code
+                    const auto code = static_cast<TCode>((*first - _min) * _toCodeScale);
+                    codes[i] = code < _maxCode ? code : _maxCode;
+                }
+            }
+
+            //decoded float value is always in range
+            bool isValid(const TCode *, size_t ) const {
+                return true;
+            }
+
+            template<typename It>
+            void fromCodes(const TCode *codes, It first, size_t count) const {
+                for (size_t i = 0; i < count; ++i, ++first) {
+                    const auto v = _min + static_cast<T>(codes[i]) * _fromCodeScale;
+                    *first = v < _max ? v : _max;
+                }
+            }
+
+        private:
+            T _min;
+            T _max;
+            TCode _maxCode;
+            T _toCodeScale;
+            T _fromCodeScale;
+        };
+
+        //codes are packed into bytes and whole block is written with single writeBuffer call.
+        //bit-packing writes least significant bits first, so result is the same as writing each code separately.
+        template<typename Writer, typename TCode>
+        void writeRangeCodes(Writer &w, const TCode *codes, size_t count, size_t bits, uint8_t *bytes) {
+            if (bits == 0)
+                return;
+            if (bits > 56) {
+                for (size_t i = 0; i < count; ++i)
+                    w.template writeBits<TCode>(codes[i], bits);
+                return;
+            }
+            uint64_t scratch{};
+            size_t scratchBits{};
+            size_t bytesCount{};
+            for (size_t i = 0; i < count; ++i) {
+                scratch |= static_cast<uint64_t>(codes[i]) << scratchBits;
+                scratchBits += bits;
+                for (; scratchBits >= 8; scratchBits -= 8, scratch >>= 8)
+                    bytes[bytesCount++] = static_cast<uint8_t>(scratch);
+            }
+            if (bytesCount)
+                w.template writeBuffer<1, uint8_t>(bytes, bytesCount);
+            if (scratchBits)
+                w.template writeBits<uint8_t>(static_cast<uint8_t>(scratch), scratchBits);
+        }
+
+        template<typename Reader, typename TCode>
+        void readRangeCodes(Reader &r, TCode *codes, size_t count, size_t bits, uint8_t *bytes) {
+            if (bits == 0) {
+                std::fill(codes, codes + count, TCode{});
+                return;
+            }
+            if (bits > 56) {
+                for (size_t i = 0; i < count; ++i)
+                    r.template readBits<TCode>(codes[i], bits);
+                return;
+            }
+            const auto bytesCount = count * bits / 8;
+            const auto bitsLeft = count * bits % 8;
+            if (bytesCount)
+                r.template readBuffer<1, uint8_t>(bytes, bytesCount);
+            if (bitsLeft)
+                r.template readBits<uint8_t>(bytes[bytesCount], bitsLeft);
+            const uint64_t mask = (static_cast<uint64_t>(1) << bits) - 1;
+            uint64_t scratch{};
+            size_t scratchBits{};
+            auto it = bytes;
+            for (size_t i = 0; i < count; ++i) {
+                for (; scratchBits < bits; scratchBits += 8)
+                    scratch |= static_cast<uint64_t>(*it++) << scratchBits;
+                codes[i] = static_cast<TCode>(scratch & mask);
+                scratch >>= bits;
+                scratchBits -= bits;
+            }
+        }
+    }
+
+    namespace ext {
+
+        /*
+         * same as applying ValueRange to each element of container, but processes elements in blocks.
+         * produces the same layout as container(obj, maxSize, [](T& v){ s.ext(v, ValueRange<T>{...}); })
+         * for floating point types precomputed scale factor is used instead of division,
+         * so in rare cases value might be quantized to neighbour code, compared to ValueRange.
+         */
+        template<typename TValue>
+        class ValueRangeContainer {
+        public:
+
+            /**
+             * @param maxSize max container size, only used for resizable containers
+             * @param args range specification, same as for ValueRange
+             */
+            template<typename ... Args>
+            explicit constexpr ValueRangeContainer(size_t maxSize, Args &&... args)
+                    :_maxSize{maxSize},
+                     _range{std::forward<Args>(args)...} {}
+
+            template<typename Ser, typename Writer, typename T, typename Fnc>
+            void serialize(Ser &, Writer &writer, const T &obj, Fnc &&) const {
+                static_assert(std::is_same<typename traits::ContainerTraits<T>::TValue, TValue>::value,
+                              "container value type must be the same as range type");
+                const auto size = traits::ContainerTraits<T>::size(obj);
+                assert(size <= _maxSize);
+                writeSize(writer, size, std::integral_constant<bool, traits::ContainerTraits<T>::isResizable>{});
+
+                details::BulkRangeQuantizer<TValue> q{_range};
+                TCode codes[BlockSize];
+                uint8_t bytes[BlockSize * sizeof(TCode) + 1];
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size; i += BlockSize) {
+                    const auto n = (std::min)(BlockSize, size - i);
+                    assert(std::all_of(it, std::next(it, n),
+                                       [this](const TValue &v) { return details::isRangeValid(v, _range); }));
+                    q.toCodes(it, codes, n);
+                    details::writeRangeCodes(writer, codes, n, _range.bitsRequired, bytes);
+                    std::advance(it, n);
+                }
+            }
+
+            template<typename Des, typename Reader, typename T, typename Fnc>
+            void deserialize(Des &, Reader &reader, T &obj, Fnc &&) const {
+                static_assert(std::is_same<typename traits::ContainerTraits<T>::TValue, TValue>::value,
+                              "container value type must be the same as range type");
+                const auto size = readSize(reader, obj, std::integral_constant<bool, traits::ContainerTraits<T>::isResizable>{});
+
+                details::BulkRangeQuantizer<TValue> q{_range};
+                TCode codes[BlockSize];
+                uint8_t bytes[BlockSize * sizeof(TCode) + 1];
+                auto it = std::begin(obj);
+                for (size_t i = 0; i < size; i += BlockSize) {
+                    const auto n = (std::min)(BlockSize, size - i);
+                    details::readRangeCodes(reader, codes, n, _range.bitsRequired, bytes);
+                    if (q.isValid(codes, n)) {
+                        q.fromCodes(codes, it, n);
+                    } else {
+                        reader.setError(ReaderError::InvalidData);
+                        std::fill(it, std::next(it, n), _range.min);
+                    }
+                    std::advance(it, n);
+                }
+            }
+
+            constexpr size_t getRequiredBits() const {
+                return _range.bitsRequired;
+            };
+
+        private:
+            using TCode = typename details::BulkRangeQuantizer<TValue>::TCode;
+            static constexpr size_t BlockSize = 64;
+
+            template<typename Writer>
+            void writeSize(Writer &w, size_t size, std::true_type) const {
+                details::writeSize(w, size);
+            }
+
+            template<typename Writer>
+            void writeSize(Writer &, size_t, std::false_type) const {
+            }
+
+            template<typename Reader, typename T>
+            size_t readSize(Reader &r, T &obj, std::true_type) const {
+                size_t size{};
+                details::readSize(r, size, _maxSize);
+                traits::ContainerTraits<T>::resize(obj, size);
+                return size;
+            }
+
+            template<typename Reader, typename T>
+            size_t readSize(Reader &, T &obj, std::false_type) const {
+                return traits::ContainerTraits<T>::size(obj);
+            }
+
+            size_t _maxSize;
+            details::RangeSpec<TValue> _range;
+        };
+
+        template<typename TValue>
+        constexpr size_t ValueRangeContainer<TValue>::BlockSize;
+    }
+
+    namespace traits {
+        template<typename TRange, typename T>
+        struct ExtensionTraits<ext::ValueRangeContainer<TRange>, T> {
+            using TValue = void;
+            static constexpr bool SupportValueOverload = false;
+            static constexpr bool SupportObjectOverload = true;
+            static constexpr bool SupportLambdaOverload = false;
+        };
+    }
+
+}
+
+
+#endif //BITSERY_EXT_VALUE_RANGE_CONTAINER_H
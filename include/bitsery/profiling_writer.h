@@ -0,0 +1,345 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#ifndef BITSERY_PROFILING_WRITER_H
+#define BITSERY_PROFILING_WRITER_H
+
+#include "adapter_writer.h"
+#include "details/serialization_common.h"
+#include "details/type_name.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BITSERY_PROFILING_TSC_AVAILABLE
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BITSERY_PROFILING_TSC_AVAILABLE
+#endif
+
+namespace bitsery {
+
+    //profiling clocks, that measures time spent in each serialization call
+
+    //doesn't measure time, only written bits are profiled
+    struct ProfilingNoClock {
+        static constexpr bool Enabled = false;
+
+        static uint64_t now() {
+            return 0;
+        }
+    };
+
+    //measures nanoseconds
+    struct ProfilingSteadyClock {
+        static constexpr bool Enabled = true;
+
+        static uint64_t now() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+    };
+
+#ifdef BITSERY_PROFILING_TSC_AVAILABLE
+    //measures cpu cycles, using time stamp counter
+    struct ProfilingTscClock {
+        static constexpr bool Enabled = true;
+
+        static uint64_t now() {
+            return static_cast<uint64_t>(__rdtsc());
+        }
+    };
+#endif
+
+    namespace details {
+
+        //name is created once for each kind and type, so its address is also used as a key
+        template<ProfileScopeKind Kind, typename T>
+        const std::string &profileScopeName() {
+            static const std::string name = [] {
+                const char *prefix = Kind == ProfileScopeKind::Object ? "object<"
+                                   : Kind == ProfileScopeKind::Value ? "value<"
+                                   : Kind == ProfileScopeKind::Container ? "container<"
+                                   : Kind == ProfileScopeKind::Text ? "text<"
+                                   : "ext<";
+                return prefix + profileTypeName<T>() + ">";
+            }();
+            return name;
+        }
+
+        inline void writeJsonString(std::ostream &os, const std::string &str) {
+            os << '"';
+            const char hex[] = "0123456789abcdef";
+            for (auto c:str) {
+                const auto u = static_cast<unsigned char>(c);
+                if (u < 0x20) {
+                    os << "\\u00" << hex[u >> 4] << hex[u & 0xF];
+                    continue;
+                }
+                if (c == '"' || c == '\\')
+                    os << '\\';
+                os << c;
+            }
+            os << '"';
+        }
+
+    }
+
+    //what value is written for each stack in folded stacks report
+    enum class ProfilingMetric {
+        Bits,
+        Time
+    };
+
+    /*
+     * writer that measures size like MeasureSize, and attributes written bits (and optionally time)
+     * to each object, value, container, text and ext call, by call path.
+     * serializer notifies it about each call only because it defines ProfilingEnabled, other writers has no overhead.
+     */
+    template<typename Config, typename TClock = ProfilingNoClock>
+    class BasicProfilingWriter {
+    public:
+        //measure class is bit-packing enabled, no need to create wrapper for it
+        static constexpr bool BitPackingEnabled = true;
+        static constexpr bool ProfilingEnabled = true;
+
+        using TConfig = Config;
+
+        struct Node {
+            const std::string *name;
+            size_t parent;
+            std::vector<size_t> childs;
+            size_t calls;
+            //including childs
+            size_t totalBits;
+            size_t selfBits;
+            uint64_t totalTime;
+            uint64_t selfTime;
+        };
+
+        BasicProfilingWriter() {
+            clear();
+        }
+
+        template<size_t SIZE, typename T>
+        void writeBytes(const T &v) {
+            _measure.template writeBytes<SIZE>(v);
+        }
+
+        template<typename T>
+        void writeBits(const T &v, size_t bitsCount) {
+            _measure.writeBits(v, bitsCount);
+        }
+
+        template<size_t SIZE, typename T>
+        void writeBuffer(const T *buf, size_t count) {
+            _measure.template writeBuffer<SIZE>(buf, count);
+        }
+
+        void align() {
+            _measure.align();
+        }
+
+        void flush() {
+            _measure.flush();
+        }
+
+        void beginSession() {
+            _measure.beginSession();
+        }
+
+        void endSession() {
+            _measure.endSession();
+        }
+
+        size_t writtenBytesCount() const {
+            return _measure.writtenBytesCount();
+        }
+
+        template<details::ProfileScopeKind Kind, typename T>
+        void beginScope() {
+            const auto &name = details::profileScopeName<Kind, T>();
+            auto parent = _stack.back().node;
+            size_t node{};
+            auto &childs = _nodes[parent].childs;
+            auto it = std::find_if(childs.begin(), childs.end(), [this, &name](size_t child) {
+                return _nodes[child].name == &name;
+            });
+            if (it == childs.end()) {
+                node = _nodes.size();
+                _nodes[parent].childs.push_back(node);
+                _nodes.push_back(Node{&name, parent, {}, 0, 0, 0, 0, 0});
+            } else {
+                node = *it;
+            }
+            _stack.push_back(Frame{node, bitsCount(), 0, TClock::now(), 0});
+        }
+
+        void endScope() {
+            auto frame = _stack.back();
+            _stack.pop_back();
+            const auto bits = bitsCount() - frame.startBits;
+            const auto time = TClock::now() - frame.startTime;
+            auto &node = _nodes[frame.node];
+            ++node.calls;
+            node.totalBits += bits;
+            node.selfBits += bits - frame.childBits;
+            node.totalTime += time;
+            node.selfTime += time - frame.childTime;
+            auto &parent = _stack.back();
+            parent.childBits += bits;
+            parent.childTime += time;
+        }
+
+        //first node is root, its self bits are written outside of any serialization call, e.g. sessions data
+        const std::vector<Node> &nodes() const {
+            return _nodes;
+        }
+
+        void clear() {
+            _nodes.clear();
+            _stack.clear();
+            _nodes.push_back(Node{&rootName(), 0, {}, 0, 0, 0, 0, 0});
+            _stack.push_back(Frame{0, bitsCount(), 0, 0, 0});
+        }
+
+        /*
+         * writes flame-graph compatible folded stacks, one line for each call path with its self bits or time,
+         * e.g. "object<Monster>;container<std::vector<Weapon>>;object<Weapon> 1234"
+         */
+        void writeFoldedStacks(std::ostream &os, ProfilingMetric metric = ProfilingMetric::Bits) const {
+            updateRoot();
+            std::vector<const std::string *> path{};
+            writeFoldedStacks(os, metric, 0, path);
+        }
+
+        /*
+         * writes json with call tree, and totals aggregated by type
+         */
+        void writeJson(std::ostream &os) const {
+            updateRoot();
+            os << "{\"clock\":" << (TClock::Enabled ? "true" : "false") << ",\"tree\":";
+            writeJsonNode(os, 0);
+            os << ",\"types\":[";
+            //aggregate self values by type
+            std::vector<Node> types{};
+            for (size_t i = 1; i < _nodes.size(); ++i) {
+                auto &n = _nodes[i];
+                auto it = std::find_if(types.begin(), types.end(), [&n](const Node &t) {
+                    return t.name == n.name;
+                });
+                if (it == types.end()) {
+                    types.push_back(Node{n.name, 0, {}, 0, 0, 0, 0, 0});
+                    it = std::prev(types.end());
+                }
+                it->calls += n.calls;
+                it->selfBits += n.selfBits;
+                it->selfTime += n.selfTime;
+            }
+            for (auto it = types.begin(); it != types.end(); ++it) {
+                if (it != types.begin())
+                    os << ',';
+                os << "{\"name\":";
+                details::writeJsonString(os, *it->name);
+                os << ",\"calls\":" << it->calls << ",\"selfBits\":" << it->selfBits
+                   << ",\"selfTime\":" << it->selfTime << '}';
+            }
+            os << "]}";
+        }
+
+    private:
+        struct Frame {
+            size_t node;
+            size_t startBits;
+            size_t childBits;
+            uint64_t startTime;
+            uint64_t childTime;
+        };
+
+        size_t bitsCount() const {
+            return _measure.writtenBitsCount();
+        }
+
+        static const std::string &rootName() {
+            static const std::string name{"root"};
+            return name;
+        }
+
+        void updateRoot() const {
+            auto &root = _nodes[0];
+            root.totalBits = bitsCount();
+            size_t childBits{};
+            for (auto child:root.childs)
+                childBits += _nodes[child].totalBits;
+            root.selfBits = root.totalBits - childBits;
+        }
+
+        void writeFoldedStacks(std::ostream &os, ProfilingMetric metric, size_t index,
+                               std::vector<const std::string *> &path) const {
+            auto &node = _nodes[index];
+            if (index)
+                path.push_back(node.name);
+            const auto value = metric == ProfilingMetric::Bits ? static_cast<uint64_t>(node.selfBits) : node.selfTime;
+            if (index && value) {
+                for (auto it = path.begin(); it != path.end(); ++it) {
+                    if (it != path.begin())
+                        os << ';';
+                    os << **it;
+                }
+                os << ' ' << value << '\n';
+            }
+            for (auto child:node.childs)
+                writeFoldedStacks(os, metric, child, path);
+            if (index)
+                path.pop_back();
+        }
+
+        void writeJsonNode(std::ostream &os, size_t index) const {
+            auto &n = _nodes[index];
+            os << "{\"name\":";
+            details::writeJsonString(os, *n.name);
+            os << ",\"calls\":" << n.calls << ",\"bits\":" << n.totalBits << ",\"selfBits\":" << n.selfBits
+               << ",\"time\":" << n.totalTime << ",\"selfTime\":" << n.selfTime << ",\"childs\":[";
+            for (auto it = n.childs.begin(); it != n.childs.end(); ++it) {
+                if (it != n.childs.begin())
+                    os << ',';
+                writeJsonNode(os, *it);
+            }
+            os << "]}";
+        }
+
+        BasicMeasureSize<Config> _measure{};
+        mutable std::vector<Node> _nodes{};
+        std::vector<Frame> _stack{};
+    };
+
+    //helper type for default config
+    using ProfilingWriter = BasicProfilingWriter<DefaultConfig>;
+
+}
+
+#endif //BITSERY_PROFILING_WRITER_H
@@ -27,6 +27,7 @@
 #include "details/serialization_common.h"
 #include "adapter_writer.h"
 #include <cassert>
+#include <memory>
 
 namespace bitsery {
 
@@ -38,6 +39,9 @@ namespace bitsery {
         //helper type, that always returns bit-packing enabled type, useful inside serialize function when enabling bitpacking
         using BPEnabledType = BasicSerializer<typename std::conditional<TAdapterWriter::BitPackingEnabled,
                 TAdapterWriter, AdapterWriterBitPackingWrapper<TAdapterWriter>>::type, TContext>;
+        //helper type, useful inside serialize function when serializing fixed size block
+        template <size_t N>
+        using FixedBlockType = BasicSerializer<AdapterWriterFixedBlockWrapper<TAdapterWriter, N>, TContext>;
 
         static_assert(details::IsSpecializationOf<typename TWriter::TConfig::InternalContext, std::tuple>::value,
                       "Config::InternalContext must be std::tuple");
@@ -58,6 +62,16 @@ namespace bitsery {
         BasicSerializer(BasicSerializer&& ) = default;
         BasicSerializer& operator = (BasicSerializer&& ) = default;
 
+        /*
+         * reuse serializer with new adapter (e.g. different buffer), without reconstructing writer and internal contexts.
+         * writer should be flushed before reset, internal contexts that implements `reset()` are reset.
+         */
+        template <typename WriterParam>
+        void reset(WriterParam&& w) {
+            _writer.reset(std::forward<WriterParam>(w));
+            details::resetContexts(_internalContext);
+        }
+
         /*
          * get serialization context.
          * this is optional, but might be required for some specific serialization flows.
@@ -81,12 +95,18 @@ namespace bitsery {
          */
         template<typename T>
         void object(const T &obj) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Object, T>{}};
+            Hooks::template onSerializeObjectBegin<T>(_writer);
             details::SerializeFunction<BasicSerializer, T>::invoke(*this, const_cast<T& >(obj));
+            Hooks::template onSerializeObjectEnd<T>(_writer);
         }
 
         template<typename T, typename Fnc>
         void object(const T &obj, Fnc &&fnc) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Object, T>{}};
+            Hooks::template onSerializeObjectBegin<T>(_writer);
             fnc(const_cast<T& >(obj));
+            Hooks::template onSerializeObjectEnd<T>(_writer);
         }
 
         /*
@@ -106,6 +126,7 @@ namespace bitsery {
 
         template<size_t VSIZE, typename T, typename std::enable_if<details::IsFundamentalType<T>::value>::type * = nullptr>
         void value(const T &v) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Value, T>{}};
             using TValue = typename details::IntegralFromFundamental<T>::TValue;
             _writer.template writeBytes<VSIZE>(reinterpret_cast<const TValue &>(v));
         }
@@ -118,12 +139,27 @@ namespace bitsery {
             procEnableBitPacking(std::forward<Fnc>(fnc), std::integral_constant<bool, TAdapterWriter::BitPackingEnabled>{});
         }
 
+        /*
+         * fixed size block, N is exact number of bytes that will be written inside a block.
+         * underlying writer checks buffer size once for whole block, instead of checking it for each value.
+         * with GCC/Clang block body is always inlined, so values are written with plain stores even at -O2.
+         */
+        template <size_t N, typename Fnc>
+        void fixedBlock(Fnc&& fnc) {
+            static_assert(N > 0, "");
+            using TBlockWriter = AdapterWriterFixedBlockWrapper<TAdapterWriter, N>;
+            typename TBlockWriter::TValue buf[N];
+            FixedBlockType<N> tmp(typename TBlockWriter::Params{_writer, buf}, _context);
+            details::invokeFixedBlock(fnc, tmp);
+        }
+
         /*
          * extension functions
          */
 
         template<typename T, typename Ext, typename Fnc>
         void ext(const T &obj, const Ext &extension, Fnc &&fnc) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Ext, Ext>{}};
             static_assert(details::IsExtensionTraitsDefined<Ext, T>::value, "Please define ExtensionTraits");
             static_assert(traits::ExtensionTraits<Ext,T>::SupportLambdaOverload,
                           "extension doesn't support overload with lambda");
@@ -132,6 +168,7 @@ namespace bitsery {
 
         template<size_t VSIZE, typename T, typename Ext>
         void ext(const T &obj, const Ext &extension) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Ext, Ext>{}};
             static_assert(details::IsExtensionTraitsDefined<Ext, T>::value, "Please define ExtensionTraits");
             static_assert(traits::ExtensionTraits<Ext,T>::SupportValueOverload,
                           "extension doesn't support overload with `value<N>`");
@@ -142,6 +179,7 @@ namespace bitsery {
 
         template<typename T, typename Ext>
         void ext(const T &obj, const Ext &extension) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Ext, Ext>{}};
             static_assert(details::IsExtensionTraitsDefined<Ext, T>::value, "Please define ExtensionTraits");
             static_assert(traits::ExtensionTraits<Ext,T>::SupportObjectOverload,
                           "extension doesn't support overload with `object`");
@@ -155,6 +193,7 @@ namespace bitsery {
          */
 
         void boolValue(bool v) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Value, bool>{}};
             procBoolValue(v, std::integral_constant<bool, TAdapterWriter::BitPackingEnabled>{});
         }
 
@@ -164,6 +203,7 @@ namespace bitsery {
 
         template<size_t VSIZE, typename T>
         void text(const T &str, size_t maxSize) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Text, T>{}};
             static_assert(details::IsTextTraitsDefined<T>::value,
                           "Please define TextTraits or include from <bitsery/traits/...>");
             static_assert(traits::ContainerTraits<T>::isResizable,
@@ -173,6 +213,7 @@ namespace bitsery {
 
         template<size_t VSIZE, typename T>
         void text(const T &str) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Text, T>{}};
             static_assert(details::IsTextTraitsDefined<T>::value,
                           "Please define TextTraits or include from <bitsery/traits/...>");
             static_assert(!traits::ContainerTraits<T>::isResizable,
@@ -188,6 +229,7 @@ namespace bitsery {
 
         template<typename T, typename Fnc>
         void container(const T &obj, size_t maxSize, Fnc &&fnc) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Container, T>{}};
             static_assert(details::IsContainerTraitsDefined<T>::value,
                           "Please define ContainerTraits or include from <bitsery/traits/...>");
             static_assert(traits::ContainerTraits<T>::isResizable,
@@ -195,11 +237,13 @@ namespace bitsery {
             auto size = traits::ContainerTraits<T>::size(obj);
             assert(size <= maxSize);
             details::writeSize(_writer, size);
+            Hooks::onContainerSize(size);
             procContainer(std::begin(obj), std::end(obj), std::forward<Fnc>(fnc));
         }
 
         template<size_t VSIZE, typename T>
         void container(const T &obj, size_t maxSize) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Container, T>{}};
             static_assert(details::IsContainerTraitsDefined<T>::value,
                           "Please define ContainerTraits or include from <bitsery/traits/...>");
             static_assert(traits::ContainerTraits<T>::isResizable,
@@ -208,12 +252,14 @@ namespace bitsery {
             auto size = traits::ContainerTraits<T>::size(obj);
             assert(size <= maxSize);
             details::writeSize(_writer, size);
+            Hooks::onContainerSize(size);
 
-            procContainer<VSIZE>(std::begin(obj), std::end(obj), std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>{});
+            procValueContainer<VSIZE>(obj, details::IsSegmentedContainer<T>{});
         }
 
         template<typename T>
         void container(const T &obj, size_t maxSize) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Container, T>{}};
             static_assert(details::IsContainerTraitsDefined<T>::value,
                           "Please define ContainerTraits or include from <bitsery/traits/...>");
             static_assert(traits::ContainerTraits<T>::isResizable,
@@ -221,6 +267,7 @@ namespace bitsery {
             auto size = traits::ContainerTraits<T>::size(obj);
             assert(size <= maxSize);
             details::writeSize(_writer, size);
+            Hooks::onContainerSize(size);
             procContainer(std::begin(obj), std::end(obj));
         }
 
@@ -228,6 +275,7 @@ namespace bitsery {
 
         template<typename T, typename Fnc, typename std::enable_if<!std::is_integral<Fnc>::value>::type * = nullptr>
         void container(const T &obj, Fnc &&fnc) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Container, T>{}};
             static_assert(details::IsContainerTraitsDefined<T>::value,
                           "Please define ContainerTraits or include from <bitsery/traits/...>");
             static_assert(!traits::ContainerTraits<T>::isResizable,
@@ -237,16 +285,18 @@ namespace bitsery {
 
         template<size_t VSIZE, typename T>
         void container(const T &obj) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Container, T>{}};
             static_assert(details::IsContainerTraitsDefined<T>::value,
                           "Please define ContainerTraits or include from <bitsery/traits/...>");
             static_assert(!traits::ContainerTraits<T>::isResizable,
                           "use container(const T&, size_t) overload with `maxSize` for dynamic containers");
             static_assert(VSIZE > 0, "");
-            procContainer<VSIZE>(std::begin(obj), std::end(obj), std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>{});
+            procValueContainer<VSIZE>(obj, details::IsSegmentedContainer<T>{});
         }
 
         template<typename T>
         void container(const T &obj) {
+            ProfileScope scope{_writer, ProfileTag<details::ProfileScopeKind::Container, T>{}};
             static_assert(details::IsContainerTraitsDefined<T>::value,
                           "Please define ContainerTraits or include from <bitsery/traits/...>");
             static_assert(!traits::ContainerTraits<T>::isResizable,
@@ -333,6 +383,12 @@ namespace bitsery {
         TContext* _context;
         typename TWriter::TConfig::InternalContext _internalContext;
 
+        //notifies profiling writer about each serialization call, does nothing for other writers
+        using ProfileScope = details::ProfileScope<TAdapterWriter>;
+        template <details::ProfileScopeKind Kind, typename T>
+        using ProfileTag = details::ProfileScopeTag<Kind, T>;
+        using Hooks = details::ConfigHooks<typename TAdapterWriter::TConfig>;
+
         //process value types
         //false_type means that we must process all elements individually
         template<size_t VSIZE, typename It>
@@ -352,6 +408,20 @@ namespace bitsery {
                                                     static_cast<size_t>(std::distance(first, last)));
         }
 
+        template<size_t VSIZE, typename T>
+        void procValueContainer(const T& obj, std::false_type) {
+            procContainer<VSIZE>(std::begin(obj), std::end(obj), std::integral_constant<bool, traits::ContainerTraits<T>::isContiguous>{});
+        }
+
+        //write each contiguous segment as whole buffer
+        template<size_t VSIZE, typename T>
+        void procValueContainer(const T& obj, std::true_type) {
+            using TValue = typename traits::ContainerTraits<T>::TValue;
+            traits::ContainerTraits<T>::forEachSegment(obj, [this](const TValue* data, size_t size) {
+                this->template procContainer<VSIZE>(data, data + size, std::true_type{});
+            });
+        }
+
         //process by calling functions
         template<typename It, typename Fnc>
         void procContainer(It first, It last, Fnc fnc) {
@@ -430,6 +500,25 @@ namespace bitsery {
         return w.writtenBytesCount();
     }
 
+    //same as quickSerialization, but reuses per-thread serializer, so that writer and internal contexts are not reconstructed for each call.
+    //only adapters that provides direct memory access (e.g. OutputBufferAdapter) are supported,
+    //because cached serializer outlives adapter and would flush it on thread exit.
+    template <typename Adapter, typename T>
+    size_t cachedSerialization(Adapter adapter, const T& value) {
+        static_assert(details::HasWriteBlock<Adapter>::value,
+                      "cachedSerialization only supports adapters with direct memory access, e.g. OutputBufferAdapter");
+        static thread_local std::unique_ptr<Serializer<Adapter>> cache{};
+        if (cache)
+            cache->reset(std::move(adapter));
+        else
+            cache.reset(new Serializer<Adapter>{std::move(adapter)});
+        auto& ser = *cache;
+        ser.object(value);
+        auto& w = AdapterAccess::getWriter(ser);
+        w.flush();
+        return w.writtenBytesCount();
+    }
+
     template <typename T>
     size_t quickMeasureSize(const T& value) {
         BasicSerializer<MeasureSize> ser {nullptr};
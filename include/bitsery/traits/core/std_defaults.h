@@ -25,6 +25,7 @@
 
 #include "traits.h"
 #include <iostream>
+#include <memory>
 
 namespace bitsery {
     namespace traits {
@@ -57,6 +58,35 @@ namespace bitsery {
             }
         };
 
+        //allocator that default-initializes elements instead of value-initializing them,
+        //so e.g. std::vector<uint8_t, DefaultInitAllocator<uint8_t>>::resize doesn't zero new bytes.
+        //useful for large buffers, that are immediately overwritten by deserializer.
+        template <typename T, typename Alloc = std::allocator<T>>
+        struct DefaultInitAllocator: public Alloc {
+            using TTraits = std::allocator_traits<Alloc>;
+
+            template <typename U>
+            struct rebind {
+                using other = DefaultInitAllocator<U, typename TTraits::template rebind_alloc<U>>;
+            };
+
+            using Alloc::Alloc;
+            DefaultInitAllocator() = default;
+            template <typename U, typename UAlloc>
+            DefaultInitAllocator(const DefaultInitAllocator<U, UAlloc>& other) noexcept
+                :Alloc(static_cast<const UAlloc&>(other)) {}
+
+            template <typename U>
+            void construct(U* ptr) noexcept(std::is_nothrow_default_constructible<U>::value) {
+                ::new(static_cast<void*>(ptr)) U;
+            }
+
+            template <typename U, typename ... Args>
+            void construct(U* ptr, Args&& ... args) {
+                TTraits::construct(static_cast<Alloc&>(*this), ptr, std::forward<Args>(args)...);
+            }
+        };
+
         template <typename T, bool Resizable = ContainerTraits<T>::isResizable>
         struct StdContainerForBufferAdapter {
             using TIterator = typename T::iterator;
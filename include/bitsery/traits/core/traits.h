@@ -66,6 +66,18 @@ namespace bitsery {
                 static_assert(std::is_void<T>::value,
                               "Define ContainerTraits or include from <bitsery/traits/...> to use as container");
             }
+            //optional, resize contiguous container without initializing new elements,
+            //if defined, it is used instead of resize when all elements will be overwritten by reading buffer directly.
+            //static void resizeForOverwrite(T& , size_t ) {}
+            //optional, resize contiguous container and call fnc(TValue* data, size_t size) that writes every element,
+            //if defined, it is preferred over resizeForOverwrite, because elements are never left unwritten.
+            //template <typename Fnc>
+            //static void resizeAndOverwrite(T& , size_t , Fnc&& fnc) {}
+            //optional, for not contiguous containers that consists of contiguous segments (e.g. std::deque, ring buffer),
+            //calls fnc(TValue* data, size_t size) for each segment in iteration order, C is T or const T.
+            //if defined, containers of fundamental types are read/written using one buffer operation per segment.
+            //template <typename C, typename Fnc>
+            //static void forEachSegment(C& container, Fnc&& fnc) {}
             //get container size
             static size_t size(const T& ) {
                 static_assert(std::is_void<T>::value,
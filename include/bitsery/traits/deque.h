@@ -26,6 +26,7 @@
 
 #include "core/std_defaults.h"
 #include <deque>
+#include <memory>
 
 namespace bitsery {
 
@@ -33,7 +34,23 @@ namespace bitsery {
 
         template<typename ... TArgs>
         struct ContainerTraits<std::deque<TArgs...>>
-                : public StdContainer<std::deque<TArgs...>, true, false> {};
+                : public StdContainer<std::deque<TArgs...>, true, false> {
+
+            //deque is a sequence of contiguous blocks, but block size is implementation defined,
+            //so block boundaries are found by comparing element addresses.
+            template <typename C, typename Fnc>
+            static void forEachSegment(C& container, Fnc&& fnc) {
+                auto first = std::begin(container);
+                auto last = std::end(container);
+                while (first != last) {
+                    auto data = std::addressof(*first);
+                    size_t size = 1;
+                    for (++first; first != last && std::addressof(*first) == data + size; ++first)
+                        ++size;
+                    fnc(data, size);
+                }
+            }
+        };
 
     }
 
@@ -35,7 +35,20 @@ namespace bitsery {
 
         template<typename ... TArgs>
         struct ContainerTraits<std::basic_string<TArgs...>>
-            :public StdContainer<std::basic_string<TArgs...>, true, true> {};
+            :public StdContainer<std::basic_string<TArgs...>, true, true> {
+#if defined(__cpp_lib_string_resize_and_overwrite)
+            //new characters are not zero-filled, fnc must write all of them
+            template <typename Fnc>
+            static void resizeAndOverwrite(std::basic_string<TArgs...>& str, size_t size, Fnc&& fnc) {
+                using TChar = typename std::basic_string<TArgs...>::value_type;
+                //some library versions pass capacity instead of requested size, so `size` is used instead
+                str.resize_and_overwrite(size, [&fnc, size](TChar* data, size_t) {
+                    fnc(data, size);
+                    return size;
+                });
+            }
+#endif
+        };
 
         template <typename ... TArgs>
         struct TextTraits<std::basic_string<TArgs...>> {
@@ -0,0 +1,183 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/adapter/chunked_buffer.h>
+#include <bitsery/adapter/buffer.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/vector.h>
+#include <gmock/gmock.h>
+
+using testing::Eq;
+using testing::ContainerEq;
+
+using Buffer = bitsery::ChunkedBuffer;
+using OutputAdapter = bitsery::OutputChunkedBufferAdapter;
+using InputAdapter = bitsery::InputBufferAdapter<std::vector<char>>;
+
+struct ChunkedData {
+    std::vector<uint32_t> values;
+};
+
+template <typename S>
+void serialize(S& s, ChunkedData& o) {
+    s.container4b(o.values, 10000);
+}
+
+std::vector<uint32_t> createChunkedData(size_t count) {
+    std::vector<uint32_t> res(count);
+    for (size_t i = 0; i < count; ++i)
+        res[i] = static_cast<uint32_t>(i * 5 + 3);
+    return res;
+}
+
+TEST(AdapterChunkedBuffer, WriteAndReadFlattenedData) {
+    Buffer buf{64};
+    auto data = createChunkedData(1000);
+    uint8_t last = 7;
+    auto written = [&]() {
+        bitsery::Serializer<OutputAdapter> ser{buf};
+        ser.container4b(data, 10000);
+        ser.value1b(last);
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        w.flush();
+        return w.writtenBytesCount();
+    }();
+    EXPECT_THAT(written, Eq(2u + 4000u + 1u));
+    EXPECT_THAT(buf.size(), Eq(written));
+    EXPECT_THAT(buf.segmentsCount(), Eq((written + 63) / 64));
+
+    auto flat = buf.flatten();
+    std::vector<uint32_t> res{};
+    uint8_t resLast{};
+    bitsery::Deserializer<InputAdapter> des{InputAdapter{flat.begin(), flat.size()}};
+    des.container4b(res, 10000);
+    des.value1b(resLast);
+    EXPECT_TRUE(bitsery::AdapterAccess::getReader(des).isCompletedSuccessfully());
+    EXPECT_THAT(res, ContainerEq(data));
+    EXPECT_THAT(resLast, Eq(last));
+}
+
+TEST(AdapterChunkedBuffer, SegmentsAreFilledUpToChunkSize) {
+    Buffer buf{16};
+    {
+        OutputAdapter w{buf};
+        char data[40]{};
+        for (char i = 0; i < 40; ++i)
+            data[static_cast<size_t>(i)] = i;
+        w.write(data, 3);
+        w.write(data + 3, 37);
+        w.flush();
+    }
+    std::vector<size_t> sizes{};
+    char expected = 0;
+    for (auto s: buf) {
+        sizes.push_back(s.size);
+        for (size_t i = 0; i < s.size; ++i)
+            EXPECT_THAT(s.data[i], Eq(expected++));
+    }
+    EXPECT_THAT(sizes, ContainerEq(std::vector<size_t>{16, 16, 8}));
+}
+
+TEST(AdapterChunkedBuffer, WriteBlockThatDoesntFitStartsNewChunk) {
+    Buffer buf{16};
+    OutputAdapter w{buf};
+    char v = 1;
+    for (size_t i = 0; i < 10; ++i)
+        w.write(&v, 1);
+    std::memset(w.writeBlock(8), 2, 8);
+    //larger than chunk size
+    std::memset(w.writeBlock(20), 3, 20);
+    w.flush();
+    EXPECT_THAT(w.writtenBytesCount(), Eq(38u));
+    EXPECT_THAT(buf.size(), Eq(38u));
+    std::vector<size_t> sizes{};
+    for (auto s: buf)
+        sizes.push_back(s.size);
+    EXPECT_THAT(sizes, ContainerEq(std::vector<size_t>{10, 8, 20}));
+    auto flat = buf.flatten();
+    EXPECT_THAT(flat[9], Eq(1));
+    EXPECT_THAT(flat[10], Eq(2));
+    EXPECT_THAT(flat[18], Eq(3));
+}
+
+TEST(AdapterChunkedBuffer, ChunksAreReturnedToPoolAndReused) {
+    auto pool = std::make_shared<bitsery::ChunkPool>(32);
+    ChunkedData data{createChunkedData(100)};
+    {
+        Buffer buf{pool};
+        bitsery::quickSerialization<OutputAdapter>(buf, data);
+        auto segments = buf.segmentsCount();
+        EXPECT_THAT(pool->freeChunksCount(), Eq(0u));
+        //new serialization clears buffer
+        bitsery::quickSerialization<OutputAdapter>(buf, data);
+        EXPECT_THAT(buf.segmentsCount(), Eq(segments));
+        EXPECT_THAT(pool->freeChunksCount(), Eq(0u));
+    }
+    auto free = pool->freeChunksCount();
+    EXPECT_THAT(free, Eq((1u + 400u + 31u) / 32u));
+    Buffer other{pool};
+    bitsery::quickSerialization<OutputAdapter>(other, data);
+    EXPECT_THAT(pool->freeChunksCount(), Eq(0u));
+    other.clear();
+    EXPECT_THAT(pool->freeChunksCount(), Eq(free));
+    pool->shrink();
+    EXPECT_THAT(pool->freeChunksCount(), Eq(0u));
+}
+
+TEST(AdapterChunkedBuffer, OversizedChunksAreNotPooled) {
+    auto pool = std::make_shared<bitsery::ChunkPool>(16);
+    {
+        Buffer buf{pool};
+        OutputAdapter w{buf};
+        w.writeBlock(100);
+        w.writeBlock(10);
+        w.flush();
+        EXPECT_THAT(buf.segmentsCount(), Eq(2u));
+    }
+    EXPECT_THAT(pool->freeChunksCount(), Eq(1u));
+}
+
+TEST(AdapterChunkedBuffer, EmptyBufferHasNoSegments) {
+    Buffer buf{};
+    {
+        OutputAdapter w{buf};
+        w.flush();
+        EXPECT_THAT(w.writtenBytesCount(), Eq(0u));
+    }
+    EXPECT_TRUE(buf.empty());
+    EXPECT_THAT(buf.segmentsCount(), Eq(0u));
+    EXPECT_TRUE(buf.flatten().empty());
+}
+
+TEST(AdapterChunkedBuffer, MovedBufferKeepsData) {
+    Buffer buf{8};
+    ChunkedData data{createChunkedData(10)};
+    auto size = bitsery::quickSerialization<OutputAdapter>(buf, data);
+    Buffer moved{std::move(buf)};
+    EXPECT_TRUE(buf.empty());
+    EXPECT_THAT(moved.size(), Eq(size));
+    auto flat = moved.flatten();
+    ChunkedData res{};
+    auto state = bitsery::quickDeserialization(InputAdapter{flat.begin(), flat.size()}, res);
+    EXPECT_TRUE(state.second);
+    EXPECT_THAT(res.values, ContainerEq(data.values));
+}
@@ -0,0 +1,194 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/adapter/file_descriptor.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/vector.h>
+#include <bitsery/traits/string.h>
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <thread>
+
+using OutputAdapter = bitsery::OutputFdAdapter;
+using InputAdapter = bitsery::InputFdAdapter;
+using Serializer = bitsery::Serializer<OutputAdapter>;
+using Deserializer = bitsery::Deserializer<InputAdapter>;
+
+using testing::Eq;
+using testing::ContainerEq;
+
+struct FdData {
+    std::vector<uint32_t> values{};
+    std::string text{};
+    uint8_t last{};
+};
+
+template <typename S>
+void serialize(S& s, FdData& o) {
+    s.container4b(o.values, 1000000);
+    s.text1b(o.text, 1000);
+    s.value1b(o.last);
+}
+
+FdData createFdData(size_t count) {
+    FdData data{};
+    for (size_t i = 0; i < count; ++i)
+        data.values.push_back(static_cast<uint32_t>(i * 7));
+    data.text = "some text";
+    data.last = 77;
+    return data;
+}
+
+//writes data using small buffer, so that direct and buffered writes are tested
+size_t writeFdData(int fd, const FdData& data, size_t bufferSize) {
+    Serializer ser{OutputAdapter{fd, bufferSize}};
+    ser.object(data);
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    w.flush();
+    return w.writtenBytesCount();
+}
+
+struct TmpFile {
+    char name[32] = "/tmp/bitsery_fd_testXXXXXX";
+    int fd = mkstemp(name);
+    TmpFile() {
+        unlink(name);
+    }
+    ~TmpFile() {
+        close(fd);
+    }
+};
+
+TEST(AdapterFileDescriptor, WriteAndReadFile) {
+    TmpFile file{};
+    ASSERT_THAT(file.fd, testing::Ge(0));
+    auto data = createFdData(10000);
+    auto size = writeFdData(file.fd, data, 100);
+    EXPECT_THAT(size, Eq(2u + 4u * 10000u + 1u + 9u + 1u));
+
+    lseek(file.fd, 0, SEEK_SET);
+    FdData res{};
+    Deserializer des{InputAdapter{file.fd, 128}};
+    des.object(res);
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+    EXPECT_THAT(res.values, ContainerEq(data.values));
+    EXPECT_THAT(res.text, Eq(data.text));
+    EXPECT_THAT(res.last, Eq(data.last));
+}
+
+TEST(AdapterFileDescriptor, PositionalReadFromOffset) {
+    TmpFile file{};
+    uint32_t prefix = 0xFFFFFFFF;
+    ASSERT_THAT(write(file.fd, &prefix, sizeof(prefix)), Eq(4));
+    auto data = createFdData(100);
+    writeFdData(file.fd, data, 64);
+
+    FdData res{};
+    //file position is at the end, but pread doesn't use it
+    auto state = bitsery::quickDeserialization(InputAdapter{file.fd, 64, 4}, res);
+    EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(state.second);
+    EXPECT_THAT(res.values, ContainerEq(data.values));
+}
+
+TEST(AdapterFileDescriptor, WhenReadingMoreThanAvailableThenDataOverflow) {
+    TmpFile file{};
+    uint16_t v = 5;
+    ASSERT_THAT(write(file.fd, &v, sizeof(v)), Eq(2));
+    lseek(file.fd, 0, SEEK_SET);
+
+    Deserializer des{InputAdapter{file.fd}};
+    uint32_t res = 0xFFFFFFFF;
+    des.value4b(res);
+    EXPECT_THAT(res, Eq(0u));
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::DataOverflow));
+}
+
+TEST(AdapterFileDescriptor, AfterErrorBufferedDataIsNotReturned) {
+    TmpFile file{};
+    uint32_t values[2]{1, 2};
+    ASSERT_THAT(write(file.fd, values, sizeof(values)), Eq(8));
+    lseek(file.fd, 0, SEEK_SET);
+
+    Deserializer des{InputAdapter{file.fd}};
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    uint32_t res{};
+    des.value4b(res);
+    EXPECT_THAT(res, Eq(1u));
+    r.setError(bitsery::ReaderError::InvalidData);
+    res = 0xFFFFFFFF;
+    des.value4b(res);
+    EXPECT_THAT(res, Eq(0u));
+    EXPECT_THAT(r.error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(AdapterFileDescriptor, WhenFdIsInvalidThenErrors) {
+    Deserializer des{InputAdapter{-1}};
+    uint32_t res{};
+    des.value4b(res);
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::ReadingError));
+
+    OutputAdapter w{-1};
+    w.write(reinterpret_cast<const char*>(&res), sizeof(res));
+    EXPECT_TRUE(w.isValidState());
+    w.flush();
+    EXPECT_FALSE(w.isValidState());
+}
+
+TEST(AdapterFileDescriptor, PipeWithConcurrentWriter) {
+    int fds[2];
+    ASSERT_THAT(pipe(fds), Eq(0));
+    //more data than pipe capacity, so that writes are short or blocking
+    auto data = createFdData(200000);
+    std::thread writer([&data, &fds]() {
+        writeFdData(fds[1], data, 4096);
+        close(fds[1]);
+    });
+    FdData res{};
+    Deserializer des{InputAdapter{fds[0], 1000}};
+    des.object(res);
+    writer.join();
+    EXPECT_TRUE(bitsery::AdapterAccess::getReader(des).isCompletedSuccessfully());
+    EXPECT_THAT(res.values, ContainerEq(data.values));
+    close(fds[0]);
+}
+
+TEST(AdapterFileDescriptor, SocketPair) {
+    int fds[2];
+    ASSERT_THAT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), Eq(0));
+    auto data = createFdData(50000);
+    std::thread writer([&data, &fds]() {
+        writeFdData(fds[0], data, OutputAdapter::DefaultBufferSize);
+        shutdown(fds[0], SHUT_WR);
+    });
+    FdData res{};
+    auto state = bitsery::quickDeserialization(InputAdapter{fds[1]}, res);
+    writer.join();
+    EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(state.second);
+    EXPECT_THAT(res.values, ContainerEq(data.values));
+    close(fds[0]);
+    close(fds[1]);
+}
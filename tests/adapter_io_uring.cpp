@@ -0,0 +1,221 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/adapter/io_uring.h>
+#include <bitsery/bitsery.h>
+#include <bitsery/traits/vector.h>
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <sys/stat.h>
+
+using OutputAdapter = bitsery::OutputIoUringAdapter;
+using InputAdapter = bitsery::InputIoUringAdapter;
+
+using testing::Eq;
+using testing::ContainerEq;
+
+static constexpr size_t BufSize = 4096;
+
+struct TmpIoFile {
+    char name[32] = "/tmp/bitsery_uring_testXXXXXX";
+    int fd = mkstemp(name);
+
+    int reopen(int flags) const {
+        return open(name, flags);
+    }
+
+    off_t size() const {
+        struct stat st{};
+        fstat(fd, &st);
+        return st.st_size;
+    }
+
+    ~TmpIoFile() {
+        close(fd);
+        unlink(name);
+    }
+};
+
+std::vector<uint32_t> createIoData(size_t count) {
+    std::vector<uint32_t> res(count);
+    for (size_t i = 0; i < count; ++i)
+        res[i] = static_cast<uint32_t>(i * 3 + 1);
+    return res;
+}
+
+template <typename T>
+class AdapterIoUring: public testing::Test {
+};
+
+using IoModes = ::testing::Types<
+    std::integral_constant<bitsery::IoMode, bitsery::IoMode::Auto>,
+    std::integral_constant<bitsery::IoMode, bitsery::IoMode::Sync>>;
+
+TYPED_TEST_CASE(AdapterIoUring, IoModes);
+
+TYPED_TEST(AdapterIoUring, WriteAndReadManyBuffers) {
+    TmpIoFile file{};
+    auto data = createIoData(20000);
+    {
+        bitsery::Serializer<OutputAdapter> ser{OutputAdapter{file.fd, 0, BufSize, 3, TypeParam::value}};
+        ser.container4b(data, 100000);
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        w.flush();
+        EXPECT_THAT(w.writtenBytesCount(), Eq(4u + 4u * 20000u));
+    }
+    EXPECT_THAT(file.size(), Eq(4 + 4 * 20000));
+
+    std::vector<uint32_t> res{};
+    bitsery::Deserializer<InputAdapter> des{InputAdapter{file.fd, 0, BufSize, 3, TypeParam::value}};
+    des.container4b(res, 100000);
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    EXPECT_THAT(r.error(), Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+    EXPECT_THAT(res, ContainerEq(data));
+}
+
+TYPED_TEST(AdapterIoUring, FlushInTheMiddleAndContinueWriting) {
+    TmpIoFile file{};
+    OutputAdapter w{file.fd, 0, BufSize, 2, TypeParam::value};
+    uint8_t v = 7;
+    w.write(v);
+    w.flush();
+    EXPECT_THAT(file.size(), Eq(1));
+    for (size_t i = 0; i < 10000; ++i)
+        w.write(v);
+    w.flush();
+    EXPECT_TRUE(w.isValidState());
+    EXPECT_THAT(w.writtenBytesCount(), Eq(10001u));
+    EXPECT_THAT(file.size(), Eq(10001));
+}
+
+TYPED_TEST(AdapterIoUring, ReadFromOffset) {
+    TmpIoFile file{};
+    auto data = createIoData(5000);
+    {
+        bitsery::Serializer<OutputAdapter> ser{OutputAdapter{file.fd, 100, BufSize, 2, TypeParam::value}};
+        ser.container4b(data, 100000);
+    }
+    EXPECT_THAT(file.size(), Eq(100 + 2 + 4 * 5000));
+    std::vector<uint32_t> res{};
+    bitsery::Deserializer<InputAdapter> des{InputAdapter{file.fd, 100, BufSize, 2, TypeParam::value}};
+    des.container4b(res, 100000);
+    EXPECT_TRUE(bitsery::AdapterAccess::getReader(des).isCompletedSuccessfully());
+    EXPECT_THAT(res, ContainerEq(data));
+}
+
+TYPED_TEST(AdapterIoUring, WhenDataIsMultipleOfBufferSizeThenCompletedSuccessfully) {
+    TmpIoFile file{};
+    {
+        OutputAdapter w{file.fd, 0, BufSize, 2, TypeParam::value};
+        for (uint32_t i = 0; i < BufSize; ++i)
+            w.write(i);
+        w.flush();
+    }
+    bitsery::Deserializer<InputAdapter> des{InputAdapter{file.fd, 0, BufSize, 2, TypeParam::value}};
+    uint32_t v{};
+    for (uint32_t i = 0; i < BufSize; ++i) {
+        des.value4b(v);
+        EXPECT_THAT(v, Eq(i));
+    }
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+    des.value4b(v);
+    EXPECT_THAT(v, Eq(0u));
+    EXPECT_THAT(r.error(), Eq(bitsery::ReaderError::DataOverflow));
+}
+
+TYPED_TEST(AdapterIoUring, WhenReadingMoreThanAvailableThenDataOverflow) {
+    TmpIoFile file{};
+    uint16_t v = 5;
+    ASSERT_THAT(write(file.fd, &v, sizeof(v)), Eq(2));
+
+    bitsery::Deserializer<InputAdapter> des{InputAdapter{file.fd, 0, BufSize, 2, TypeParam::value}};
+    uint32_t res = 0xFFFFFFFF;
+    des.value4b(res);
+    EXPECT_THAT(res, Eq(0u));
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::DataOverflow));
+}
+
+TYPED_TEST(AdapterIoUring, WhenFdIsInvalidThenErrors) {
+    bitsery::Deserializer<InputAdapter> des{InputAdapter{-1, 0, BufSize, 2, TypeParam::value}};
+    uint32_t res{};
+    des.value4b(res);
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::ReadingError));
+
+    OutputAdapter w{-1, 0, BufSize, 2, TypeParam::value};
+    w.write(res);
+    EXPECT_TRUE(w.isValidState());
+    w.flush();
+    EXPECT_FALSE(w.isValidState());
+}
+
+TYPED_TEST(AdapterIoUring, DirectIoPadsLastBlockAndTruncatesFile) {
+    TmpIoFile file{};
+    auto fd = file.reopen(O_RDWR | O_DIRECT);
+    if (fd < 0)
+        GTEST_SKIP() << "O_DIRECT is not supported by file system";
+    auto data = createIoData(3000);
+    {
+        bitsery::Serializer<OutputAdapter> ser{OutputAdapter{fd, 0, BufSize, 2, TypeParam::value}};
+        uint8_t first = 1;
+        ser.value1b(first);
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        w.flush();
+        EXPECT_THAT(file.size(), Eq(1));
+        ser.container4b(data, 100000);
+        w.flush();
+        EXPECT_THAT(w.writtenBytesCount(), Eq(1u + 2u + 4u * 3000u));
+    }
+    EXPECT_THAT(file.size(), Eq(1 + 2 + 4 * 3000));
+
+    bitsery::Deserializer<InputAdapter> des{InputAdapter{fd, 0, BufSize, 2, TypeParam::value}};
+    uint8_t first{};
+    std::vector<uint32_t> res{};
+    des.value1b(first);
+    des.container4b(res, 100000);
+    EXPECT_THAT(first, Eq(1));
+    EXPECT_THAT(res, ContainerEq(data));
+    EXPECT_TRUE(bitsery::AdapterAccess::getReader(des).isCompletedSuccessfully());
+    close(fd);
+}
+
+TYPED_TEST(AdapterIoUring, MovedFromAdaptersAreNotValid) {
+    TmpIoFile file{};
+    OutputAdapter w{file.fd, 0, BufSize, 2, TypeParam::value};
+    OutputAdapter w2{std::move(w)};
+    EXPECT_FALSE(w.isValidState());
+    EXPECT_FALSE(w.isAsync());
+    w.flush();
+    EXPECT_TRUE(w2.isValidState());
+
+    InputAdapter r{file.fd, 0, BufSize, 2, TypeParam::value};
+    InputAdapter r2{std::move(r)};
+    EXPECT_FALSE(r.isCompletedSuccessfully());
+    EXPECT_FALSE(r.isAsync());
+    EXPECT_TRUE(r2.isCompletedSuccessfully());
+}
+
+TEST(AdapterIoUringMode, SyncModeDoesntUseIoUring) {
+    OutputAdapter w{-1, 0, BufSize, 2, bitsery::IoMode::Sync};
+    EXPECT_FALSE(w.isAsync());
+}
@@ -0,0 +1,217 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/adapter/segmented_buffer.h>
+#include <bitsery/adapter/chunked_buffer.h>
+#include <bitsery/ext/growable.h>
+#include <bitsery/traits/string.h>
+#include <gmock/gmock.h>
+#include <random>
+#include "serialization_test_utils.h"
+
+using testing::Eq;
+using testing::ContainerEq;
+
+using SegmentedAdapter = bitsery::InputSegmentedBufferAdapter;
+
+struct SegmentedData {
+    std::vector<uint32_t> values{};
+    std::string text{};
+    std::vector<MyStruct1> objects{};
+    int64_t last{};
+};
+
+template <typename S>
+void serialize(S& s, SegmentedData& o) {
+    s.container4b(o.values, 10000);
+    s.text1b(o.text, 1000);
+    s.container(o.objects, 100);
+    s.value8b(o.last);
+}
+
+SegmentedData createSegmentedData() {
+    SegmentedData res{};
+    for (uint32_t i = 0; i < 500; ++i)
+        res.values.push_back(i * 7919u);
+    res.text = "segments are not contiguous";
+    for (int i = 0; i < 20; ++i)
+        res.objects.push_back(MyStruct1{i, -i});
+    res.last = -1234567890123;
+    return res;
+}
+
+//copies each segment to separate allocation, some segments are empty
+struct RandomSegments {
+    std::vector<std::vector<char>> storage{};
+    std::vector<bitsery::BufferSegment> segments{};
+
+    RandomSegments(const Buffer& data, size_t size, unsigned seed, size_t maxSegment) {
+        std::mt19937 gen{seed};
+        std::uniform_int_distribution<size_t> dist{0, maxSegment};
+        size_t pos{};
+        while (pos < size) {
+            auto n = std::min(dist(gen), size - pos);
+            storage.emplace_back(data.begin() + static_cast<std::ptrdiff_t>(pos),
+                                 data.begin() + static_cast<std::ptrdiff_t>(pos + n));
+            pos += n;
+        }
+        for (auto& s: storage)
+            segments.push_back(bitsery::BufferSegment{s.data(), s.size()});
+    }
+};
+
+TEST(AdapterSegmentedBuffer, DeserializeRandomlySegmentedPayload) {
+    auto data = createSegmentedData();
+    Buffer buf{};
+    auto size = bitsery::quickSerialization<OutputAdapter>(buf, data);
+    for (size_t maxSegment: {1u, 3u, 16u, 100u, 5000u}) {
+        for (unsigned seed = 0; seed < 20; ++seed) {
+            RandomSegments segments{buf, size, seed, maxSegment};
+            SegmentedData res{};
+            auto state = bitsery::quickDeserialization(SegmentedAdapter{segments.segments}, res);
+            EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+            EXPECT_TRUE(state.second);
+            EXPECT_THAT(res.values, ContainerEq(data.values));
+            EXPECT_THAT(res.text, Eq(data.text));
+            EXPECT_THAT(res.objects, ContainerEq(data.objects));
+            EXPECT_THAT(res.last, Eq(data.last));
+        }
+    }
+}
+
+TEST(AdapterSegmentedBuffer, WhenReadingMoreThanAvailableThenDataOverflow) {
+    char a[]{1, 2};
+    char b[]{3};
+    std::vector<bitsery::BufferSegment> segments{{a, 2}, {b, 1}};
+    bitsery::Deserializer<SegmentedAdapter> des{SegmentedAdapter{segments}};
+    uint16_t v1{};
+    uint16_t v2 = 0xFFFF;
+    des.value2b(v1);
+    des.value2b(v2);
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    EXPECT_THAT(v2, Eq(0u));
+    EXPECT_THAT(r.error(), Eq(bitsery::ReaderError::DataOverflow));
+    EXPECT_FALSE(r.isCompletedSuccessfully());
+}
+
+TEST(AdapterSegmentedBuffer, EmptySegmentsAreSkipped) {
+    char a[]{1, 2};
+    char b[]{3, 4};
+    std::vector<bitsery::BufferSegment> segments{{nullptr, 0}, {a, 2}, {a, 0}, {b, 2}, {b, 0}};
+    SegmentedAdapter adapter{segments};
+    EXPECT_THAT(adapter.segmentsCount(), Eq(2u));
+    char res[4]{};
+    adapter.read(res, 3);
+    adapter.read(res + 3, 1);
+    EXPECT_THAT(std::vector<char>(res, res + 4), ContainerEq(std::vector<char>{1, 2, 3, 4}));
+    EXPECT_TRUE(adapter.isCompletedSuccessfully());
+    EXPECT_TRUE(SegmentedAdapter{std::vector<bitsery::BufferSegment>{}}.isCompletedSuccessfully());
+}
+
+TEST(AdapterSegmentedBuffer, ReadBlockReturnsNullptrWhenDataIsSplitBetweenSegments) {
+    char a[]{1, 2};
+    char b[]{3, 4, 5};
+    std::vector<bitsery::BufferSegment> segments{{a, 2}, {b, 3}};
+    SegmentedAdapter adapter{segments};
+    auto p = adapter.readBlock(1);
+    ASSERT_THAT(p, Eq(a));
+    EXPECT_THAT(adapter.readBlock(2), Eq(nullptr));
+    char v{};
+    adapter.read(&v, 1);
+    EXPECT_THAT(adapter.readBlock(3), Eq(b));
+    EXPECT_THAT(adapter.readBlock(1), Eq(nullptr));
+    EXPECT_THAT(adapter.error(), Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(adapter.isCompletedSuccessfully());
+}
+
+TEST(AdapterSegmentedBuffer, IteratorIsRandomAccessAcrossSegments) {
+    char a[]{0, 1, 2};
+    char b[]{3};
+    char c[]{4, 5};
+    std::vector<bitsery::BufferSegment> segments{{a, 3}, {b, 1}, {c, 2}};
+    bitsery::details::SegmentTable table{{a, a + 3, 0}, {b, b + 1, 3}, {c, c + 2, 4}, {c + 2, c + 2, 6}};
+    bitsery::SegmentedBufferIterator begin{&table, 0};
+    bitsery::SegmentedBufferIterator end{&table, 6};
+    EXPECT_THAT(std::distance(begin, end), Eq(6));
+    std::vector<char> all(begin, end);
+    EXPECT_THAT(all, ContainerEq(std::vector<char>{0, 1, 2, 3, 4, 5}));
+    EXPECT_THAT(begin[4], Eq(4));
+    EXPECT_THAT(*std::next(end, -3), Eq(3));
+    auto it = begin + 3;
+    EXPECT_TRUE(it == std::next(begin, 3));
+    EXPECT_THAT(*it, Eq(3));
+    --it;
+    EXPECT_THAT(*it, Eq(2));
+    it += 3;
+    EXPECT_THAT(*it, Eq(5));
+    EXPECT_TRUE(begin < it && it < end);
+}
+
+struct SessionsData {
+    int32_t v1;
+    std::vector<int32_t> values;
+};
+
+TEST(AdapterSegmentedBuffer, SessionsReadOlderVersionData) {
+    using Writer = bitsery::AdapterWriter<OutputAdapter, SessionsEnabledConfig>;
+    using Reader = bitsery::AdapterReader<SegmentedAdapter, SessionsEnabledConfig>;
+    SessionsData data{5, {1, 2, 3, 4}};
+    Buffer buf{};
+    size_t size{};
+    {
+        bitsery::BasicSerializer<Writer> ser{OutputAdapter{buf}};
+        for (auto i = 0; i < 5; ++i) {
+            ser.ext(data, bitsery::ext::Growable{}, [&ser](SessionsData& o) {
+                ser.value4b(o.v1);
+                ser.container4b(o.values, 10);
+            });
+        }
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        w.flush();
+        size = w.writtenBytesCount();
+    }
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        RandomSegments segments{buf, size, seed, 7};
+        bitsery::BasicDeserializer<Reader> des{SegmentedAdapter{segments.segments}};
+        for (auto i = 0; i < 5; ++i) {
+            int32_t v1{};
+            des.ext(v1, bitsery::ext::Growable{}, [&des](int32_t& v) {
+                des.value4b(v);
+            });
+            EXPECT_THAT(v1, Eq(data.v1));
+        }
+        auto& r = bitsery::AdapterAccess::getReader(des);
+        EXPECT_THAT(r.error(), Eq(bitsery::ReaderError::NoError));
+        EXPECT_TRUE(r.isCompletedSuccessfully());
+    }
+}
+
+TEST(AdapterSegmentedBuffer, ReadChunkedBufferSegments) {
+    auto data = createSegmentedData();
+    bitsery::ChunkedBuffer buf{64};
+    bitsery::quickSerialization<bitsery::OutputChunkedBufferAdapter>(buf, data);
+    SegmentedData res{};
+    auto state = bitsery::quickDeserialization(SegmentedAdapter{buf}, res);
+    EXPECT_TRUE(state.second);
+    EXPECT_THAT(res.values, ContainerEq(data.values));
+    EXPECT_THAT(res.last, Eq(data.last));
+}
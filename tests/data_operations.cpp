@@ -379,6 +379,47 @@ TEST(DataBitsAndBytesOperations, ReadWriteCanWorkOnUnalignedData) {
     EXPECT_THAT(tmp, Eq(12));
 }
 
+TEST(DataBitsAndBytesOperations, UnalignedByteBufferIsSameAsWritingEachByteAsBits) {
+    //setup data, larger than internal block size
+    constexpr size_t DATA_SIZE = 1000;
+    int8_t src[DATA_SIZE]{};
+    for (size_t i = 0; i < DATA_SIZE; ++i)
+        src[i] = static_cast<int8_t>(i * 7);
+    //create and write to buffer
+    Buffer buf1{};
+    Writer bw1{buf1};
+    AdapterBitPackingWriter bpw1{bw1};
+    bpw1.writeBits(5u, 3);
+    bpw1.writeBuffer<1>(src, DATA_SIZE);
+    bpw1.flush();
+
+    Buffer buf2{};
+    Writer bw2{buf2};
+    AdapterBitPackingWriter bpw2{bw2};
+    bpw2.writeBits(5u, 3);
+    for (auto v: src)
+        bpw2.writeBits(static_cast<uint8_t>(v), 8);
+    bpw2.flush();
+
+    auto writtenSize = bpw1.writtenBytesCount();
+    EXPECT_THAT(writtenSize, Eq(DATA_SIZE + 1));
+    EXPECT_THAT(bpw2.writtenBytesCount(), Eq(writtenSize));
+    EXPECT_TRUE(std::equal(buf1.begin(), std::next(buf1.begin(), writtenSize), buf2.begin()));
+
+    //read from buffer
+    Reader br{InputAdapter{buf1.begin(), writtenSize}};
+    AdapterBitPackingReader bpr{br};
+    int8_t dst[DATA_SIZE]{};
+    uint8_t tmp{};
+    bpr.readBits(tmp, 3);
+    EXPECT_THAT(tmp, Eq(5));
+    bpr.readBuffer<1>(dst, DATA_SIZE);
+    bpr.align();
+    EXPECT_THAT(bpr.error(), Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(bpr.isCompletedSuccessfully());
+    EXPECT_THAT(dst, ContainerEq(src));
+}
+
 TEST(DataBitsAndBytesOperations, RegressionTestReadBytesAfterReadBitsWithLotsOfZeroBits) {
     //setup data
     int16_t data[2]{0x0000, 0x7FFF};
@@ -0,0 +1,452 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+#include <bitsery/ext/inheritance.h>
+#include <bitsery/ext/pointer.h>
+#include <bitsery/ext/std_map.h>
+#include <bitsery/ext/std_smart_ptr.h>
+#include <bitsery/ext/value_range.h>
+#include <cstdlib>
+#include <map>
+#include <new>
+
+using namespace testing;
+
+/*
+ * counting global allocator, only counts when enabled, so that gtest allocations are not counted
+ */
+namespace {
+    struct AllocationCounter {
+        static bool enabled;
+        static size_t count;
+    };
+
+    bool AllocationCounter::enabled = false;
+    size_t AllocationCounter::count = 0;
+
+    template<typename Fnc>
+    size_t countAllocations(Fnc &&fnc) {
+        AllocationCounter::count = 0;
+        AllocationCounter::enabled = true;
+        fnc();
+        AllocationCounter::enabled = false;
+        return AllocationCounter::count;
+    }
+
+    //not inlined into operator new/delete, otherwise optimizer sees malloc/free behind new/delete
+    //and reports -Wmismatched-new-delete
+#if defined(__GNUC__)
+    __attribute__((noinline))
+#elif defined(_MSC_VER)
+    __declspec(noinline)
+#endif
+    void* countedAllocate(std::size_t size) {
+        if (AllocationCounter::enabled)
+            ++AllocationCounter::count;
+        return std::malloc(size ? size : 1);
+    }
+
+#if defined(__GNUC__)
+    __attribute__((noinline))
+#elif defined(_MSC_VER)
+    __declspec(noinline)
+#endif
+    void countedDeallocate(void* p) noexcept {
+        std::free(p);
+    }
+}
+
+void *operator new(std::size_t size) {
+    if (auto p = countedAllocate(size))
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept {
+    countedDeallocate(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    countedDeallocate(p);
+}
+
+using Serializer = bitsery::BasicSerializer<Writer>;
+using Deserializer = bitsery::BasicDeserializer<Reader>;
+
+using SessionsWriter = bitsery::AdapterWriter<OutputAdapter, SessionsEnabledConfig>;
+using SessionsReader = bitsery::AdapterReader<InputAdapter, SessionsEnabledConfig>;
+
+struct AllocationsTestData {
+    std::vector<MyStruct1> items{};
+    std::vector<float> values{};
+    uint8_t level{};
+};
+
+template <typename S>
+void serialize(S& s, AllocationsTestData& o) {
+    s.container(o.items, 100);
+    s.container4b(o.values, 100);
+    s.enableBitPacking([&o](typename S::BPEnabledType& sbp) {
+        sbp.ext(o.level, bitsery::ext::ValueRange<uint8_t>{uint8_t{0}, uint8_t{15}});
+    });
+}
+
+AllocationsTestData createAllocationsTestData() {
+    AllocationsTestData data{};
+    for (auto i = 0; i < 50; ++i) {
+        data.items.emplace_back(i, -i);
+        data.values.push_back(static_cast<float>(i) / 3.0f);
+    }
+    data.level = 7;
+    return data;
+}
+
+template <typename T>
+size_t serializeObject(Buffer& buf, const T& obj) {
+    Serializer ser{OutputAdapter{buf}};
+    ser.object(obj);
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    w.flush();
+    return w.writtenBytesCount();
+}
+
+TEST(SerializationAllocations, WhenBufferIsReusedThenSerializationDoesntAllocate) {
+    auto data = createAllocationsTestData();
+    Buffer buf{};
+    //warm-up, buffer grows
+    auto size = serializeObject(buf, data);
+    EXPECT_THAT(countAllocations([&buf, &data]() {
+        serializeObject(buf, data);
+    }), Eq(0u));
+    EXPECT_THAT(countAllocations([&buf, &data]() {
+        bitsery::quickSerialization(OutputAdapter{buf}, data);
+    }), Eq(0u));
+
+    AllocationsTestData res = createAllocationsTestData();
+    EXPECT_THAT(countAllocations([&buf, &res, size]() {
+        Deserializer des{InputAdapter{buf.begin(), size}};
+        des.object(res);
+    }), Eq(0u));
+}
+
+TEST(SerializationAllocations, WhenDeserializingIntoEmptyObjectThenOnlyContainersAllocate) {
+    auto data = createAllocationsTestData();
+    Buffer buf{};
+    auto size = serializeObject(buf, data);
+    AllocationsTestData res{};
+    EXPECT_THAT(countAllocations([&buf, &res, size]() {
+        Deserializer des{InputAdapter{buf.begin(), size}};
+        des.object(res);
+    }), Eq(2u));
+}
+
+TEST(SerializationAllocations, SessionsDoesntAllocate) {
+    Buffer buf{};
+    auto writeSessions = [&buf]() {
+        bitsery::BasicSerializer<SessionsWriter> ser{OutputAdapter{buf}};
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        for (auto i = 0; i < 4; ++i) {
+            w.beginSession();
+            ser.value4b(i);
+            w.beginSession();
+            ser.value4b(i);
+            w.endSession();
+            w.endSession();
+        }
+        w.flush();
+        return w.writtenBytesCount();
+    };
+    auto size = writeSessions();
+    EXPECT_THAT(countAllocations(writeSessions), Eq(0u));
+    EXPECT_THAT(countAllocations([&buf, size]() {
+        bitsery::BasicDeserializer<SessionsReader> des{InputAdapter{buf.begin(), size}};
+        auto& r = bitsery::AdapterAccess::getReader(des);
+        int32_t v{};
+        for (auto i = 0; i < 4; ++i) {
+            r.beginSession();
+            des.value4b(v);
+            r.beginSession();
+            des.value4b(v);
+            r.endSession();
+            r.endSession();
+        }
+    }), Eq(0u));
+}
+
+TEST(SerializationAllocations, SessionsAllocateOnlyWhenInlineStorageIsExceeded) {
+    Buffer buf{};
+    auto writeSessions = [&buf](int count) {
+        bitsery::BasicSerializer<SessionsWriter> ser{OutputAdapter{buf}};
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        for (auto i = 0; i < count; ++i) {
+            w.beginSession();
+            ser.value4b(i);
+            w.endSession();
+        }
+        w.flush();
+    };
+    writeSessions(100);
+    EXPECT_THAT(countAllocations([&writeSessions]() { writeSessions(16); }), Eq(0u));
+    //only sessions list spills to heap, with capacity 32, 64 and 128
+    EXPECT_THAT(countAllocations([&writeSessions]() { writeSessions(100); }), Eq(3u));
+}
+
+struct AllocBase {
+    uint8_t x{};
+    virtual ~AllocBase() = default;
+};
+
+template <typename S>
+void serialize(S& s, AllocBase& o) {
+    s.value1b(o.x);
+}
+
+struct AllocDerived1: virtual AllocBase {
+    uint8_t y1{};
+};
+
+template <typename S>
+void serialize(S& s, AllocDerived1& o) {
+    s.ext(o, bitsery::ext::VirtualBaseClass<AllocBase>{});
+    s.value1b(o.y1);
+}
+
+struct AllocDerived2: virtual AllocBase {
+    uint8_t y2{};
+};
+
+template <typename S>
+void serialize(S& s, AllocDerived2& o) {
+    s.ext(o, bitsery::ext::VirtualBaseClass<AllocBase>{});
+    s.value1b(o.y2);
+}
+
+struct AllocDiamond: AllocDerived1, AllocDerived2 {
+};
+
+template <typename S>
+void serialize(S& s, AllocDiamond& o) {
+    s.ext(o, bitsery::ext::BaseClass<AllocDerived1>{});
+    s.ext(o, bitsery::ext::BaseClass<AllocDerived2>{});
+}
+
+struct ConfigWithInheritanceContext: bitsery::DefaultConfig {
+    using InternalContext = std::tuple<bitsery::ext::InheritanceContext>;
+};
+
+TEST(SerializationAllocations, VirtualInheritanceDoesntAllocate) {
+    using InheritanceWriter = bitsery::AdapterWriter<OutputAdapter, ConfigWithInheritanceContext>;
+    std::vector<AllocDiamond> data(10);
+    Buffer buf{};
+    auto write = [&buf, &data]() {
+        bitsery::BasicSerializer<InheritanceWriter> ser{OutputAdapter{buf}};
+        ser.container(data, 100);
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        w.flush();
+        return w.writtenBytesCount();
+    };
+    write();
+    size_t size{};
+    EXPECT_THAT(countAllocations([&write, &size]() { size = write(); }), Eq(0u));
+    //virtual base is serialized once
+    EXPECT_THAT(size, Eq(1u + 10u * 3u));
+}
+
+TEST(SerializationAllocations, MapSerializationDoesntAllocateAndDeserializationAllocatesNodes) {
+    std::map<int32_t, int32_t> data{};
+    for (auto i = 0; i < 20; ++i)
+        data.emplace(i, i * i);
+    Buffer buf{};
+    auto write = [&buf, &data]() {
+        Serializer ser{OutputAdapter{buf}};
+        ser.ext(data, bitsery::ext::StdMap{100}, [&ser](int32_t& key, int32_t& value) {
+            ser.value4b(key);
+            ser.value4b(value);
+        });
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        w.flush();
+        return w.writtenBytesCount();
+    };
+    auto size = write();
+    EXPECT_THAT(countAllocations(write), Eq(0u));
+
+    std::map<int32_t, int32_t> res{};
+    EXPECT_THAT(countAllocations([&buf, &res, size]() {
+        Deserializer des{InputAdapter{buf.begin(), size}};
+        des.ext(res, bitsery::ext::StdMap{100}, [&des](int32_t& key, int32_t& value) {
+            des.value4b(key);
+            des.value4b(value);
+        });
+    }), Eq(data.size()));
+    EXPECT_THAT(res, ContainerEq(data));
+}
+
+struct AllocPointers {
+    MyStruct1 values[3]{};
+    MyStruct1* observers[3]{};
+};
+
+template <typename S>
+void serialize(S& s, AllocPointers& o) {
+    for (auto& v: o.values)
+        s.ext(v, bitsery::ext::ReferencedByPointer{});
+    for (auto& p: o.observers)
+        s.ext(p, bitsery::ext::PointerObserver{});
+}
+
+using PointersSerializer = bitsery::BasicSerializer<Writer, bitsery::ext::PointerLinkingContext>;
+using PointersDeserializer = bitsery::BasicDeserializer<Reader, bitsery::ext::PointerLinkingContext>;
+
+AllocPointers createAllocPointers() {
+    AllocPointers data{};
+    for (auto i = 0; i < 3; ++i) {
+        data.values[i] = MyStruct1{i, -i};
+        data.observers[i] = &data.values[2 - i];
+    }
+    return data;
+}
+
+TEST(SerializationAllocations, PointerLinkingContextAllocatesOnlyPointersTable) {
+    auto data = createAllocPointers();
+    Buffer buf{};
+    auto write = [&buf, &data]() {
+        bitsery::ext::PointerLinkingContext ctx{};
+        PointersSerializer ser{OutputAdapter{buf}, &ctx};
+        ser.object(data);
+        bitsery::AdapterAccess::getWriter(ser).flush();
+    };
+    write();
+    //single open addressing table for all pointers
+    EXPECT_THAT(countAllocations(write), Eq(1u));
+}
+
+TEST(SerializationAllocations, ReusedPointerLinkingContextDoesntAllocateAfterWarmUp) {
+    auto data = createAllocPointers();
+    Buffer buf{};
+    bitsery::ext::PointerLinkingContext ctx{};
+    auto write = [&buf, &data, &ctx]() {
+        ctx.reset();
+        PointersSerializer ser{OutputAdapter{buf}, &ctx};
+        ser.object(data);
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        w.flush();
+        return w.writtenBytesCount();
+    };
+    auto size = write();
+    EXPECT_THAT(countAllocations(write), Eq(0u));
+    EXPECT_TRUE(ctx.isValid());
+
+    AllocPointers res{};
+    auto read = [&buf, &res, &ctx, size]() {
+        ctx.reset();
+        PointersDeserializer des{InputAdapter{buf.begin(), size}, &ctx};
+        des.object(res);
+    };
+    //ids table, list of blocks and single block of pointers info
+    EXPECT_THAT(countAllocations(read), Eq(3u));
+    EXPECT_THAT(countAllocations(read), Eq(0u));
+    EXPECT_TRUE(ctx.isValid());
+    for (auto i = 0; i < 3; ++i)
+        EXPECT_THAT(res.observers[i], Eq(&res.values[2 - i]));
+}
+
+struct AllocPolyBase {
+    uint8_t x{};
+    virtual ~AllocPolyBase() = default;
+};
+
+template <typename S>
+void serialize(S& s, AllocPolyBase& o) {
+    s.value1b(o.x);
+}
+
+struct AllocPolyDerived: AllocPolyBase {
+    uint8_t y{};
+};
+
+template <typename S>
+void serialize(S& s, AllocPolyDerived& o) {
+    s.ext(o, bitsery::ext::BaseClass<AllocPolyBase>{});
+    s.value1b(o.y);
+}
+
+namespace bitsery {
+    namespace ext {
+        template<>
+        struct PolymorphicBaseClass<AllocPolyBase> : PolymorphicDerivedClasses<AllocPolyDerived> {
+        };
+    }
+}
+
+//PolymorphicContext allocates only when classes are registered, lookups by type doesn't allocate
+TEST(SerializationAllocations, PolymorphicContextDoesntAllocateAfterRegistration) {
+    using TContext = std::tuple<bitsery::ext::PointerLinkingContext,
+            bitsery::ext::PolymorphicContext<bitsery::ext::StandardRTTI>>;
+    using PolySerializer = bitsery::BasicSerializer<Writer, TContext>;
+    using PolyDeserializer = bitsery::BasicDeserializer<Reader, TContext>;
+    using TData = std::vector<std::unique_ptr<AllocPolyBase>>;
+
+    TData data{};
+    data.emplace_back(new AllocPolyDerived{});
+    data.emplace_back(new AllocPolyBase{});
+    data.emplace_back(new AllocPolyDerived{});
+    Buffer buf{};
+    TContext ctx{};
+    auto write = [&buf, &data, &ctx]() {
+        std::get<0>(ctx).reset();
+        PolySerializer ser{OutputAdapter{buf}, &ctx};
+        ser.container(data, 10, [&ser](const std::unique_ptr<AllocPolyBase>& p) {
+            ser.ext(p, bitsery::ext::StdSmartPtr{});
+        });
+        auto& w = bitsery::AdapterAccess::getWriter(ser);
+        w.flush();
+        return w.writtenBytesCount();
+    };
+    {
+        PolySerializer ser{OutputAdapter{buf}, &ctx};
+        std::get<1>(ctx).registerBasesList(ser, bitsery::ext::PolymorphicClassesList<AllocPolyBase>{});
+    }
+    auto size = write();
+    EXPECT_THAT(countAllocations(write), Eq(0u));
+
+    TData res{};
+    auto read = [&buf, &res, &ctx, size]() {
+        std::get<0>(ctx).reset();
+        PolyDeserializer des{InputAdapter{buf.begin(), size}, &ctx};
+        des.container(res, 10, [&des](std::unique_ptr<AllocPolyBase>& p) {
+            des.ext(p, bitsery::ext::StdSmartPtr{});
+        });
+    };
+    std::get<1>(ctx).clear();
+    {
+        PolyDeserializer des{InputAdapter{buf.begin(), size}, &ctx};
+        std::get<1>(ctx).registerBasesList(des, bitsery::ext::PolymorphicClassesList<AllocPolyBase>{});
+    }
+    read();
+    //objects of same types already exist
+    EXPECT_THAT(countAllocations(read), Eq(0u));
+    ASSERT_THAT(res.size(), Eq(3u));
+    EXPECT_THAT(dynamic_cast<AllocPolyDerived*>(res[0].get()), Ne(nullptr));
+    EXPECT_THAT(dynamic_cast<AllocPolyDerived*>(res[1].get()), Eq(nullptr));
+}
@@ -0,0 +1,109 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+#include <bitsery/adapter/stream.h>
+#include <sstream>
+
+using namespace testing;
+
+TEST(SerializeConsumeContainer, ValuesAreConsumedInBatches) {
+    SerializationContext ctx;
+    std::vector<uint32_t> src(10000);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = static_cast<uint32_t>(i * 3);
+    ctx.createSerializer().container4b(src, 100000);
+
+    uint64_t sum{};
+    size_t batches{};
+    size_t count{};
+    ctx.createDeserializer().consumeContainer<4, uint32_t>(100000, [&](const uint32_t* data, size_t size) {
+        ++batches;
+        for (auto it = data; it != data + size; ++it) {
+            if (*it != src[count])
+                break;
+            sum += *it;
+            ++count;
+        }
+    });
+    EXPECT_THAT(count, Eq(src.size()));
+    EXPECT_THAT(sum, Eq(3ull * 9999ull * 10000ull / 2ull));
+    EXPECT_THAT(batches, Eq(10u));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeConsumeContainer, ObjectsAreConsumedOneByOne) {
+    SerializationContext ctx;
+    std::vector<MyStruct1> src{MyStruct1{1, 2}, MyStruct1{3, 4}, MyStruct1{5, 6}};
+    ctx.createSerializer().container(src, 10);
+
+    std::vector<MyStruct1> res{};
+    auto& des = ctx.createDeserializer();
+    des.consumeContainer<MyStruct1>(10, [&des](MyStruct1& v) { des.object(v); }, [&res](MyStruct1& v) {
+        res.push_back(v);
+    });
+    EXPECT_THAT(res, ContainerEq(src));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeConsumeContainer, WhenDataIsTruncatedThenOnlyValidElementsAreConsumed) {
+    SerializationContext ctx;
+    std::vector<uint16_t> src(5000, 7u);
+    ctx.createSerializer().container2b(src, 10000);
+    ctx.bw->flush();
+
+    bitsery::BasicDeserializer<Reader> des{InputAdapter{ctx.buf.begin(), ctx.getBufferSize() - 1}};
+    size_t count{};
+    des.consumeContainer<2, uint16_t>(10000, [&count](const uint16_t*, size_t size) {
+        count += size;
+    });
+    //last batch is not complete
+    EXPECT_THAT(count, Eq(4096u));
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::DataOverflow));
+
+    bitsery::BasicDeserializer<Reader> des2{InputAdapter{ctx.buf.begin(), 11}};
+    count = 0;
+    des2.consumeContainer<uint16_t>(10000, [&des2](uint16_t& v) { des2.value2b(v); }, [&count](uint16_t& v) {
+        EXPECT_THAT(v, Eq(7u));
+        ++count;
+    });
+    //2 bytes for size, and 4.5 elements
+    EXPECT_THAT(count, Eq(4u));
+}
+
+TEST(SerializeConsumeContainer, AggregateFromStream) {
+    std::stringstream stream{};
+    std::vector<int64_t> src(20000, -3);
+    bitsery::Serializer<bitsery::OutputStreamAdapter> ser{stream};
+    ser.container8b(src, 100000);
+    bitsery::AdapterAccess::getWriter(ser).flush();
+
+    bitsery::Deserializer<bitsery::InputStreamAdapter> des{stream};
+    int64_t sum{};
+    des.consumeContainer<8, int64_t>(100000, [&sum](const int64_t* data, size_t size) {
+        for (auto it = data; it != data + size; ++it)
+            sum += *it;
+    });
+    EXPECT_THAT(sum, Eq(-60000));
+    EXPECT_TRUE(bitsery::AdapterAccess::getReader(des).isCompletedSuccessfully());
+}
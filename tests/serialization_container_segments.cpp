@@ -0,0 +1,127 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+#include <bitsery/traits/deque.h>
+#include <array>
+
+using namespace testing;
+
+//fixed capacity ring buffer, consists of max two contiguous segments
+struct RingBuffer {
+    std::array<uint32_t, 8> data{};
+    size_t head{};
+    size_t count{};
+    mutable size_t segmentsCalls{};
+
+    uint32_t& operator[](size_t i) {
+        return data[(head + i) % data.size()];
+    }
+};
+
+namespace bitsery {
+    namespace traits {
+        template <>
+        struct ContainerTraits<RingBuffer> {
+            using TValue = uint32_t;
+            static constexpr bool isResizable = true;
+            static constexpr bool isContiguous = false;
+            static size_t size(const RingBuffer& buf) {
+                return buf.count;
+            }
+            static void resize(RingBuffer& buf, size_t size) {
+                buf.count = size;
+            }
+            template <typename C, typename Fnc>
+            static void forEachSegment(C& buf, Fnc&& fnc) {
+                auto first = (std::min)(buf.count, buf.data.size() - buf.head);
+                ++buf.segmentsCalls;
+                if (first)
+                    fnc(buf.data.data() + buf.head, first);
+                if (buf.count > first)
+                    fnc(buf.data.data(), buf.count - first);
+            }
+        };
+    }
+}
+
+TEST(SerializeContainerSegments, RingBufferIsWrittenBySegments) {
+    SerializationContext ctx;
+    RingBuffer src{};
+    src.head = 6;
+    src.count = 5;
+    for (auto i = 0u; i < src.count; ++i)
+        src[i] = i + 1;
+    ctx.createSerializer().container4b(src, 10);
+
+    //same format as contiguous container
+    std::vector<uint32_t> res{};
+    ctx.createDeserializer().container4b(res, 10);
+    EXPECT_THAT(src.segmentsCalls, Eq(1u));
+    EXPECT_THAT(res, ElementsAre(1u, 2u, 3u, 4u, 5u));
+}
+
+TEST(SerializeContainerSegments, RingBufferIsReadBySegments) {
+    SerializationContext ctx;
+    std::vector<uint32_t> src{5, 4, 3, 2, 1, 0};
+    ctx.createSerializer().container4b(src, 10);
+
+    RingBuffer res{};
+    res.head = 4;
+    ctx.createDeserializer().container4b(res, 10);
+    EXPECT_THAT(res.segmentsCalls, Eq(1u));
+    EXPECT_THAT(res.count, Eq(src.size()));
+    for (auto i = 0u; i < res.count; ++i)
+        EXPECT_THAT(res[i], Eq(src[i]));
+}
+
+TEST(SerializeContainerSegments, LargeDequeSpansMultipleBlocks) {
+    SerializationContext ctx;
+    std::deque<uint16_t> src{};
+    for (auto i = 0; i < 5000; ++i)
+        src.push_front(static_cast<uint16_t>(i * 3));
+    ctx.createSerializer().container2b(src, 10000);
+    std::deque<uint16_t> res{1, 2, 3};
+    ctx.createDeserializer().container2b(res, 10000);
+    EXPECT_THAT(res, ContainerEq(src));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeContainerSegments, DequeWithBitPackingEnabled) {
+    SerializationContext ctx;
+    std::deque<uint32_t> src{};
+    for (auto i = 0u; i < 1000u; ++i)
+        src.push_back(i * 7u);
+    ctx.createSerializer().enableBitPacking([&src](SerializationContext::TSerializer::BPEnabledType& sbp) {
+        sbp.boolValue(true);
+        sbp.container4b(src, 10000);
+    });
+    std::deque<uint32_t> res{};
+    bool b{};
+    ctx.createDeserializer().enableBitPacking([&res, &b](SerializationContext::TDeserializer::BPEnabledType& dbp) {
+        dbp.boolValue(b);
+        dbp.container4b(res, 10000);
+    });
+    EXPECT_TRUE(b);
+    EXPECT_THAT(res, ContainerEq(src));
+}
@@ -30,6 +30,7 @@
 using namespace testing;
 
 using bitsery::ext::Entropy;
+using bitsery::ext::EntropyIndexed;
 
 using BPSer = bitsery::BasicSerializer<bitsery::AdapterWriterBitPackingWrapper<Writer>>;
 using BPDes = bitsery::BasicDeserializer<bitsery::AdapterReaderBitPackingWrapper<Reader>>;
@@ -198,3 +199,104 @@ TEST(SerializeExtensionEntropy, WhenEntropyEncodedThenCustomFunctionNotInvoked)
     EXPECT_THAT(res, Eq(v));
     EXPECT_THAT(ctx.getBufferSize(), Eq(1));
 }
+
+//constructor is constexpr
+static constexpr int32_t EntropyConstValues[3] = {485, 4849, 89};
+static constexpr Entropy<const int32_t[3]> EntropyConst{EntropyConstValues};
+
+TEST(SerializeExtensionEntropy, CanBeUsedAsConstantExpression) {
+    int32_t v = 89;
+    int32_t res{};
+    SerializationContext ctx{};
+    ctx.createSerializer().enableBitPacking([&v](BPSer& ser) {
+        ser.ext<4>(v, EntropyConst);
+    });
+    ctx.createDeserializer().enableBitPacking([&res](BPDes& des) {
+        des.ext<4>(res, EntropyConst);
+    });
+    EXPECT_THAT(res, Eq(v));
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1));
+}
+
+template <typename TExt, typename T>
+size_t serializeAndGetEntropyIndex(const TExt& entropy, size_t size, const T& v) {
+    SerializationContext ctx{};
+    ctx.createSerializer().enableBitPacking([&v, &entropy](BPSer& ser) {
+        ser.ext(v, entropy, [](T& ) {});
+    });
+    size_t res{};
+    ctx.createDeserializer().enableBitPacking([&res, size](BPDes& des) {
+        des.ext(res, bitsery::ext::ValueRange<size_t>{0u, size});
+    });
+    return res;
+}
+
+TEST(SerializeExtensionEntropy, IndexedTableIndexIsSameAsLinearSearch) {
+    std::vector<int32_t> values{};
+    for (auto i = 0; i < 512; ++i)
+        values.push_back(i * 31 - 1000);
+    auto entropy = bitsery::ext::makeEntropyIndexed(values);
+    for (auto v: {-1000, 0, 1, 5, 31 * 511 - 1000, 31 * 100 - 1000, 999999}) {
+        EXPECT_THAT(serializeAndGetEntropyIndex(entropy, values.size(), v),
+                    Eq(bitsery::details::findEntropyIndex(v, values)));
+    }
+}
+
+TEST(SerializeExtensionEntropy, IndexedTableDoesNotDependOnOriginalContainer) {
+    std::vector<int32_t> values{};
+    for (auto i = 0; i < 100; ++i)
+        values.push_back(i * 3);
+    EntropyIndexed<int32_t> entropy{values};
+    values.clear();
+    values.shrink_to_fit();
+    EXPECT_THAT(serializeAndGetEntropyIndex(entropy, 100u, 3 * 70), Eq(71));
+    EXPECT_THAT(serializeAndGetEntropyIndex(entropy, 100u, 1), Eq(0));
+
+    int32_t v = 3 * 42;
+    int32_t res{};
+    SerializationContext ctx{};
+    ctx.createSerializer().enableBitPacking([&v, &entropy](BPSer& ser) {
+        ser.ext<4>(v, entropy);
+    });
+    ctx.createDeserializer().enableBitPacking([&res, &entropy](BPDes& des) {
+        des.ext<4>(res, entropy);
+    });
+    EXPECT_THAT(res, Eq(v));
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1));
+}
+
+TEST(SerializeExtensionEntropy, IndexedTableWithDuplicatesReturnsFirstOccurrence) {
+    std::vector<std::string> values{};
+    for (auto i = 0; i < 100; ++i)
+        values.push_back("value" + std::to_string(i % 50));
+    EntropyIndexed<std::string> entropy{values};
+    EXPECT_THAT(serializeAndGetEntropyIndex(entropy, values.size(), std::string{"value7"}), Eq(8));
+    EXPECT_THAT(serializeAndGetEntropyIndex(entropy, values.size(), std::string{"value49"}), Eq(50));
+    EXPECT_THAT(serializeAndGetEntropyIndex(entropy, values.size(), std::string{"value50"}), Eq(0));
+}
+
+TEST(SerializeExtensionEntropy, IndexedEnumTableIsEntropyEncoded) {
+    std::vector<MyEnumClass> values{};
+    for (auto i = 0; i < 40; ++i)
+        values.push_back(static_cast<MyEnumClass>(i));
+    const auto entropy = bitsery::ext::makeEntropyIndexed(values);
+    std::vector<MyEnumClass> data{MyEnumClass::E5, MyEnumClass::E1, static_cast<MyEnumClass>(39),
+                                  static_cast<MyEnumClass>(100)};
+    for (auto v: data) {
+        EXPECT_THAT(serializeAndGetEntropyIndex(entropy, values.size(), v),
+                    Eq(bitsery::details::findEntropyIndex(v, values)));
+    }
+    std::vector<MyEnumClass> res{};
+    SerializationContext ctx{};
+    ctx.createSerializer().enableBitPacking([&data, &entropy](BPSer& ser) {
+        ser.container(data, 10, [&ser, &entropy](const MyEnumClass& v) {
+            ser.ext<4>(v, entropy);
+        });
+    });
+    ctx.createDeserializer().enableBitPacking([&res, &entropy](BPDes& des) {
+        des.container(res, 10, [&des, &entropy](MyEnumClass& v) {
+            des.ext<4>(v, entropy);
+        });
+    });
+    EXPECT_THAT(res, ContainerEq(data));
+}
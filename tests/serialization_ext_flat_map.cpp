@@ -0,0 +1,116 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/ext/flat_map.h>
+#include <bitsery/ext/std_map.h>
+#include <bitsery/traits/string.h>
+#include <functional>
+#include <map>
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+
+using FlatMap = bitsery::ext::FlatMap;
+using StdMap = bitsery::ext::StdMap;
+
+using testing::Eq;
+using testing::ContainerEq;
+
+using SortedVectorMap = std::vector<std::pair<int32_t, MyStruct1>>;
+
+template <typename S>
+void serializeEntry(S& s, int32_t& key, MyStruct1& value) {
+    s.value4b(key);
+    s.object(value);
+}
+
+TEST(SerializeExtensionFlatMap, SerializeAndDeserializeEquals) {
+    SerializationContext ctx;
+    SortedVectorMap src{{-5, MyStruct1{1, 2}}, {8, MyStruct1{3, 4}}, {874, MyStruct1{-5, 6}}};
+    SortedVectorMap res{};
+    auto& ser = ctx.createSerializer();
+    ser.ext(src, FlatMap{10}, [&ser](int32_t& key, MyStruct1& value) { serializeEntry(ser, key, value); });
+    auto& des = ctx.createDeserializer();
+    des.ext(res, FlatMap{10}, [&des](int32_t& key, MyStruct1& value) { serializeEntry(des, key, value); });
+    EXPECT_THAT(res, ContainerEq(src));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionFlatMap, ExistingElementsAreReplaced) {
+    SerializationContext ctx;
+    std::vector<std::pair<std::string, std::string>> src{{"a", "first"}, {"b", "second"}};
+    std::vector<std::pair<std::string, std::string>> res{{"x", "1"}, {"y", "2"}, {"z", "3"}};
+    auto& ser = ctx.createSerializer();
+    ser.ext(src, FlatMap{10}, [&ser](std::string& key, std::string& value) {
+        ser.text1b(key, 10);
+        ser.text1b(value, 10);
+    });
+    auto& des = ctx.createDeserializer();
+    des.ext(res, FlatMap{10}, [&des](std::string& key, std::string& value) {
+        des.text1b(key, 10);
+        des.text1b(value, 10);
+    });
+    EXPECT_THAT(res, ContainerEq(src));
+}
+
+TEST(SerializeExtensionFlatMap, HasSameFormatAsStdMap) {
+    SerializationContext ctx;
+    std::map<int32_t, MyStruct1> src{{-5, MyStruct1{1, 2}}, {8, MyStruct1{3, 4}}, {874, MyStruct1{-5, 6}}};
+    SortedVectorMap res{};
+    auto& ser = ctx.createSerializer();
+    ser.ext(src, StdMap{10}, [&ser](int32_t& key, MyStruct1& value) { serializeEntry(ser, key, value); });
+    auto& des = ctx.createDeserializer();
+    des.ext(res, FlatMap{10}, [&des](int32_t& key, MyStruct1& value) { serializeEntry(des, key, value); });
+    EXPECT_THAT(res, ContainerEq(SortedVectorMap(src.begin(), src.end())));
+}
+
+TEST(SerializeExtensionFlatMap, WhenKeysAreNotSortedOrUniqueThenInvalidDataError) {
+    SerializationContext ctx;
+    std::map<int32_t, MyStruct1, std::greater<int32_t>> unsorted{{1, MyStruct1{}}, {2, MyStruct1{}}};
+    auto& ser = ctx.createSerializer();
+    ser.ext(unsorted, StdMap{10}, [&ser](int32_t& key, MyStruct1& value) { serializeEntry(ser, key, value); });
+    SortedVectorMap res{};
+    auto& des = ctx.createDeserializer();
+    des.ext(res, FlatMap{10}, [&des](int32_t& key, MyStruct1& value) { serializeEntry(des, key, value); });
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+
+    SerializationContext ctx2;
+    std::multimap<int32_t, MyStruct1> duplicates{{1, MyStruct1{}}, {1, MyStruct1{}}};
+    auto& ser2 = ctx2.createSerializer();
+    ser2.ext(duplicates, StdMap{10}, [&ser2](int32_t& key, MyStruct1& value) { serializeEntry(ser2, key, value); });
+    auto& des2 = ctx2.createDeserializer();
+    des2.ext(res, FlatMap{10}, [&des2](int32_t& key, MyStruct1& value) { serializeEntry(des2, key, value); });
+    EXPECT_THAT(ctx2.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionFlatMap, CustomCompare) {
+    SerializationContext ctx;
+    using Ext = bitsery::ext::BasicFlatMap<std::greater<int32_t>>;
+    SortedVectorMap src{{10, MyStruct1{1, 2}}, {5, MyStruct1{3, 4}}, {-1, MyStruct1{-5, 6}}};
+    SortedVectorMap res{};
+    auto& ser = ctx.createSerializer();
+    ser.ext(src, Ext{10}, [&ser](int32_t& key, MyStruct1& value) { serializeEntry(ser, key, value); });
+    auto& des = ctx.createDeserializer();
+    des.ext(res, Ext{10}, [&des](int32_t& key, MyStruct1& value) { serializeEntry(des, key, value); });
+    EXPECT_THAT(res, ContainerEq(src));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
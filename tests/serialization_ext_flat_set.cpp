@@ -0,0 +1,72 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/ext/flat_set.h>
+#include <bitsery/ext/std_set.h>
+#include <set>
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+
+using FlatSet = bitsery::ext::FlatSet;
+
+using testing::Eq;
+using testing::ContainerEq;
+
+TEST(SerializeExtensionFlatSet, ValuesSyntax) {
+    SerializationContext ctx;
+    std::vector<int32_t> src{-8, 4, 9, 48, 64, 9845};
+    std::vector<int32_t> res{};
+    ctx.createSerializer().ext4b(src, FlatSet{10});
+    ctx.createDeserializer().ext4b(res, FlatSet{10});
+    EXPECT_THAT(res, ContainerEq(src));
+}
+
+TEST(SerializeExtensionFlatSet, ObjectSyntax) {
+    SerializationContext ctx;
+    std::vector<MyStruct1> src{MyStruct1{-874, -456}, MyStruct1{874, 456}, MyStruct1{4894, 0}};
+    std::vector<MyStruct1> res{};
+    ctx.createSerializer().ext(src, FlatSet{10});
+    ctx.createDeserializer().ext(res, FlatSet{10});
+    EXPECT_THAT(res, ContainerEq(src));
+}
+
+TEST(SerializeExtensionFlatSet, HasSameFormatAsStdSet) {
+    SerializationContext ctx;
+    std::set<int32_t> src{54, -484, 841, 79};
+    std::vector<int32_t> res{};
+    ctx.createSerializer().ext4b(src, bitsery::ext::StdSet{10});
+    auto& des = ctx.createDeserializer();
+    des.ext(res, FlatSet{10}, [&des](int32_t& v) {
+        des.value4b(v);
+    });
+    EXPECT_THAT(res, ContainerEq(std::vector<int32_t>(src.begin(), src.end())));
+}
+
+TEST(SerializeExtensionFlatSet, WhenKeysAreNotSortedOrUniqueThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<int32_t> src{1, 3, 3};
+    std::vector<int32_t> res{};
+    ctx.createSerializer().container4b(src, 10);
+    ctx.createDeserializer().ext4b(res, FlatSet{10});
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
@@ -0,0 +1,241 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include <bitsery/ext/front_coding.h>
+#include <bitsery/traits/vector.h>
+#include <bitsery/traits/string.h>
+#include <gmock/gmock.h>
+#include <set>
+#include "serialization_test_utils.h"
+
+using namespace testing;
+using bitsery::ext::FrontCoded;
+using bitsery::ext::FrontCodedStrings;
+
+namespace {
+    std::vector<std::string> makePaths() {
+        std::vector<std::string> res{};
+        for (auto dir: {"include/bitsery/", "include/bitsery/adapter/", "include/bitsery/ext/", "tests/"}) {
+            for (auto i = 0; i < 30; ++i)
+                res.push_back(std::string{dir} + "file_" + std::to_string(i) + ".h");
+        }
+        res.push_back("");
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+}
+
+TEST(SerializeExtensionFrontCoding, PrefixLengthOfDifferentSizes) {
+    using bitsery::details::frontCodingPrefix;
+    const std::string s1 = "abcdefghijklmnopqrstuvwxyz";
+    for (size_t i = 0; i <= s1.size(); ++i) {
+        auto s2 = s1;
+        if (i < s2.size())
+            s2[i] = '_';
+        EXPECT_THAT(frontCodingPrefix(s1.data(), s1.size(), s2.data(), s2.size()), Eq(i));
+        EXPECT_THAT(frontCodingPrefix(s1.data(), s1.size(), s1.data(), i), Eq(i));
+    }
+    const std::u16string w1 = u"abcdefgh";
+    const std::u16string w2 = u"abcdeXgh";
+    EXPECT_THAT(frontCodingPrefix(w1.data(), w1.size(), w2.data(), w2.size()), Eq(5u));
+}
+
+TEST(SerializeExtensionFrontCoding, WritesSharedPrefixAndSuffix) {
+    SerializationContext ctx;
+    std::vector<std::string> t1{"abc", "abcd", "abx", "b"};
+    std::vector<std::string> res1{};
+
+    ctx.createSerializer().ext(t1, FrontCoded{10, 100, 2});
+    ctx.createDeserializer().ext(res1, FrontCoded{10, 100, 2});
+
+    //size, interval, "abc" in full, (3, "d"), "abx" in full (restart), (1, "")
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 1 + (1 + 3) + (1 + 1 + 1) + (1 + 3) + (1 + 1 + 1)));
+    EXPECT_THAT(res1, ContainerEq(t1));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionFrontCoding, VectorRoundTripIsSmallerThanText) {
+    SerializationContext ctx1;
+    const auto t1 = makePaths();
+    std::vector<std::string> res1{"reused", "strings"};
+    ctx1.createSerializer().ext(t1, FrontCoded{1000, 100});
+    ctx1.createDeserializer().ext(res1, FrontCoded{1000, 100});
+    EXPECT_THAT(res1, ContainerEq(t1));
+    EXPECT_TRUE(ctx1.br->isCompletedSuccessfully());
+
+    SerializationContext ctx2;
+    auto &ser = ctx2.createSerializer();
+    ser.container(t1, 1000, [&ser](const std::string &str) {
+        ser.text1b(str, 100);
+    });
+    EXPECT_THAT(ctx1.getBufferSize() * 2, Lt(ctx2.getBufferSize()));
+}
+
+TEST(SerializeExtensionFrontCoding, SetRoundTrip) {
+    SerializationContext ctx;
+    const auto paths = makePaths();
+    std::set<std::string> t1(paths.begin(), paths.end());
+    std::set<std::string> res1{"x"};
+
+    ctx.createSerializer().ext(t1, FrontCoded{1000, 100, 5});
+    ctx.createDeserializer().ext(res1, FrontCoded{1000, 100, 5});
+
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionFrontCoding, UnsortedAndWideStrings) {
+    SerializationContext ctx;
+    std::vector<std::u16string> t1{u"zzz", u"abc", u"abd", u"", u"abd", u"zz"};
+    std::vector<std::u16string> res1{};
+
+    ctx.createSerializer().ext(t1, FrontCoded{10, 10, 4});
+    ctx.createDeserializer().ext(res1, FrontCoded{10, 10, 4});
+
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionFrontCoding, DeserializeToFrontCodedStrings) {
+    SerializationContext ctx;
+    const auto t1 = makePaths();
+    FrontCodedStrings res1{};
+
+    ctx.createSerializer().ext(t1, FrontCoded{1000, 100, 7});
+    ctx.createDeserializer().ext(res1, FrontCoded{1000, 100, 7});
+
+    ASSERT_THAT(res1.size(), Eq(t1.size()));
+    EXPECT_THAT(res1.restartInterval(), Eq(7u));
+    std::string scratch{};
+    for (size_t i = 0; i < t1.size(); ++i) {
+        res1.get(i, scratch);
+        EXPECT_THAT(scratch, Eq(t1[i]));
+    }
+    std::vector<std::string> all{};
+    res1.forEach([&all](const std::string &s) { all.push_back(s); });
+    EXPECT_THAT(all, ContainerEq(t1));
+
+    for (auto &s: t1) {
+        const auto expected = static_cast<size_t>(std::lower_bound(t1.begin(), t1.end(), s) - t1.begin());
+        EXPECT_THAT(res1.lowerBound(s), Eq(expected)) << s;
+        EXPECT_TRUE(res1.contains(s)) << s;
+        const auto missing = s + "~";
+        const auto expectedMissing = static_cast<size_t>(std::lower_bound(t1.begin(), t1.end(), missing) - t1.begin());
+        EXPECT_THAT(res1.lowerBound(missing), Eq(expectedMissing)) << missing;
+        EXPECT_FALSE(res1.contains(missing)) << missing;
+    }
+    EXPECT_THAT(res1.lowerBound("~"), Eq(t1.size()));
+}
+
+TEST(SerializeExtensionFrontCoding, SerializeFrontCodedStrings) {
+    SerializationContext ctx1;
+    const auto t1 = makePaths();
+    FrontCodedStrings view{};
+    ctx1.createSerializer().ext(t1, FrontCoded{1000, 100, 3});
+    ctx1.createDeserializer().ext(view, FrontCoded{1000, 100});
+
+    SerializationContext ctx2;
+    std::vector<std::string> res1{};
+    ctx2.createSerializer().ext(view, FrontCoded{1000, 100});
+    ctx2.createDeserializer().ext(res1, FrontCoded{1000, 100});
+
+    EXPECT_THAT(ctx2.getBufferSize(), Eq(ctx1.getBufferSize()));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionFrontCoding, WhenSharedPrefixIsLongerThanPreviousStringThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<std::string> t1{"abc", "abd"};
+    std::vector<std::string> res1{};
+
+    ctx.createSerializer().ext(t1, FrontCoded{10, 100});
+    ctx.buf[1 + 1 + 1 + 3] = 4;
+    ctx.createDeserializer().ext(res1, FrontCoded{10, 100});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionFrontCoding, WhenStringIsLongerThanMaxThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<std::string> t1{"abc", "abcdef"};
+    FrontCodedStrings res1{};
+
+    ctx.createSerializer().ext(t1, FrontCoded{10, 6});
+    ctx.createDeserializer().ext(res1, FrontCoded{10, 5});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_TRUE(res1.empty());
+}
+
+TEST(SerializeExtensionFrontCoding, EmptyStringsToFrontCodedStrings) {
+    SerializationContext ctx1;
+    std::vector<std::string> t1{"", ""};
+    FrontCodedStrings view{};
+    ctx1.createSerializer().ext(t1, FrontCoded{10, 10});
+    ctx1.createDeserializer().ext(view, FrontCoded{10, 10});
+
+    SerializationContext ctx2;
+    std::vector<std::string> res1{};
+    ctx2.createSerializer().ext(view, FrontCoded{10, 10});
+    ctx2.createDeserializer().ext(res1, FrontCoded{10, 10});
+
+    EXPECT_THAT(view.size(), Eq(2u));
+    EXPECT_THAT(res1, ContainerEq(t1));
+    EXPECT_TRUE(ctx2.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionFrontCoding, RestartIntervalIsLimitedBySize) {
+    SerializationContext ctx;
+    std::vector<std::string> t1{"a", "ab", "abc"};
+    FrontCodedStrings res1{};
+
+    ctx.createSerializer().ext(t1, FrontCoded{10, 10, 16});
+    ctx.createDeserializer().ext(res1, FrontCoded{10, 10});
+
+    EXPECT_THAT(ctx.buf[1], Eq(3));
+    EXPECT_THAT(res1.restartInterval(), Eq(3u));
+    EXPECT_THAT(res1.lowerBound("abc"), Eq(2u));
+}
+
+TEST(SerializeExtensionFrontCoding, WhenRestartIntervalIsLongerThanSizeThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<std::string> t1{"abc", "abd"};
+    FrontCodedStrings res1{};
+
+    ctx.createSerializer().ext(t1, FrontCoded{10, 10});
+    ctx.buf[1] = 3;
+    ctx.createDeserializer().ext(res1, FrontCoded{10, 10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_TRUE(res1.empty());
+}
+
+TEST(SerializeExtensionFrontCoding, WhenRestartIntervalIsZeroThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<std::string> t1{"abc"};
+    std::vector<std::string> res1{};
+
+    ctx.createSerializer().ext(t1, FrontCoded{10, 10});
+    ctx.buf[1] = 0;
+    ctx.createDeserializer().ext(res1, FrontCoded{10, 10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
@@ -0,0 +1,176 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include <bitsery/ext/half_float.h>
+#include <bitsery/traits/array.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include <limits>
+#include "serialization_test_utils.h"
+
+using namespace testing;
+using bitsery::ext::HalfFloatContainer;
+using bitsery::ext::HalfFloatFormat;
+
+namespace {
+    uint32_t bits(float v) {
+        return bitsery::details::floatBits(v);
+    }
+
+    float fromBits(uint32_t v) {
+        return bitsery::details::floatFromBits(v);
+    }
+}
+
+TEST(SerializeExtensionHalfFloat, ScalarConversionOfSpecialValues) {
+    using bitsery::details::floatToHalf;
+    using bitsery::details::halfToFloat;
+    EXPECT_THAT(floatToHalf(0.0f), Eq(0x0000));
+    EXPECT_THAT(floatToHalf(-0.0f), Eq(0x8000));
+    EXPECT_THAT(floatToHalf(1.0f), Eq(0x3C00));
+    EXPECT_THAT(floatToHalf(-2.0f), Eq(0xC000));
+    EXPECT_THAT(floatToHalf(65504.0f), Eq(0x7BFF));
+    EXPECT_THAT(floatToHalf(65520.0f), Eq(0x7C00));
+    EXPECT_THAT(floatToHalf(1e10f), Eq(0x7C00));
+    EXPECT_THAT(floatToHalf(-std::numeric_limits<float>::infinity()), Eq(0xFC00));
+    EXPECT_THAT(floatToHalf(std::numeric_limits<float>::quiet_NaN()) & 0x7E00, Eq(0x7E00));
+    //smallest subnormal, and values around half of it
+    EXPECT_THAT(floatToHalf(std::ldexp(1.0f, -24)), Eq(0x0001));
+    EXPECT_THAT(floatToHalf(std::ldexp(1.0f, -25)), Eq(0x0000));
+    EXPECT_THAT(floatToHalf(std::ldexp(1.5f, -25)), Eq(0x0001));
+    //ties round to even
+    EXPECT_THAT(floatToHalf(1.0f + std::ldexp(1.0f, -11)), Eq(0x3C00));
+    EXPECT_THAT(floatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)), Eq(0x3C02));
+
+    EXPECT_THAT(halfToFloat(0x3C00), Eq(1.0f));
+    EXPECT_THAT(halfToFloat(0x7BFF), Eq(65504.0f));
+    EXPECT_THAT(halfToFloat(0x0001), Eq(std::ldexp(1.0f, -24)));
+    EXPECT_THAT(bits(halfToFloat(0x8000)), Eq(0x80000000u));
+    EXPECT_TRUE(std::isinf(halfToFloat(0xFC00)));
+    EXPECT_TRUE(std::isnan(halfToFloat(0x7E00)));
+}
+
+TEST(SerializeExtensionHalfFloat, AllHalvesRoundTripThroughFloat) {
+    std::vector<uint16_t> halves(65536);
+    for (size_t i = 0; i < halves.size(); ++i)
+        halves[i] = static_cast<uint16_t>(i);
+    std::vector<float> scalar(halves.size());
+    std::vector<float> bulk(halves.size());
+    bitsery::details::halvesToFloatsScalar(halves.data(), scalar.data(), halves.size());
+    bitsery::details::halvesToFloats(halves.data(), bulk.data(), halves.size());
+
+    std::vector<uint16_t> back(halves.size());
+    bitsery::details::floatsToHalves(scalar.data(), back.data(), scalar.size());
+    for (size_t i = 0; i < halves.size(); ++i) {
+        ASSERT_THAT(bits(bulk[i]), Eq(bits(scalar[i]))) << i;
+        //signaling NaNs becomes quiet
+        const auto expected = std::isnan(scalar[i]) ? static_cast<uint16_t>(halves[i] | 0x200u) : halves[i];
+        ASSERT_THAT(back[i], Eq(expected)) << i;
+        ASSERT_THAT(bitsery::details::floatToHalf(scalar[i]), Eq(expected)) << i;
+    }
+}
+
+TEST(SerializeExtensionHalfFloat, BulkEncodingSameAsScalar) {
+    //walk through all exponents with different mantissa patterns
+    std::vector<float> values;
+    for (uint32_t x = 0; x < 0x80000000u; x += 0x1357u)
+        values.push_back(fromBits(x));
+    std::vector<uint16_t> scalar(values.size());
+    std::vector<uint16_t> bulk(values.size());
+    bitsery::details::floatsToHalvesScalar(values.data(), scalar.data(), values.size());
+    bitsery::details::floatsToHalves(values.data(), bulk.data(), values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+        ASSERT_THAT(bulk[i], Eq(scalar[i])) << std::hex << bits(values[i]);
+}
+
+TEST(SerializeExtensionHalfFloat, BFloat16Conversion) {
+    using bitsery::details::floatToBFloat16;
+    using bitsery::details::bfloat16ToFloat;
+    EXPECT_THAT(floatToBFloat16(1.0f), Eq(0x3F80));
+    EXPECT_THAT(floatToBFloat16(-1.0f), Eq(0xBF80));
+    EXPECT_THAT(floatToBFloat16(fromBits(0x3F808000u)), Eq(0x3F80));
+    EXPECT_THAT(floatToBFloat16(fromBits(0x3F818000u)), Eq(0x3F82));
+    EXPECT_THAT(floatToBFloat16(fromBits(0x3F808001u)), Eq(0x3F81));
+    EXPECT_THAT(floatToBFloat16(std::numeric_limits<float>::infinity()), Eq(0x7F80));
+    EXPECT_THAT(floatToBFloat16(std::numeric_limits<float>::max()), Eq(0x7F80));
+    //NaN with payload only in lower bits must stay NaN
+    EXPECT_TRUE(std::isnan(bfloat16ToFloat(floatToBFloat16(fromBits(0x7F800001u)))));
+    EXPECT_THAT(bfloat16ToFloat(0x4049), Eq(3.140625f));
+}
+
+TEST(SerializeExtensionHalfFloat, Float16RoundTrip) {
+    SerializationContext ctx;
+    std::vector<float> t1{};
+    for (auto i = 0; i < 1000; ++i)
+        t1.push_back(static_cast<float>(i) * 0.25f - 100.0f);
+    std::vector<float> res1{};
+
+    ctx.createSerializer().ext(t1, HalfFloatContainer{1000});
+    ctx.createDeserializer().ext(res1, HalfFloatContainer{1000});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(2 + t1.size() * 2));
+    EXPECT_THAT(res1, ContainerEq(t1));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionHalfFloat, BFloat16RoundTrip) {
+    SerializationContext ctx;
+    std::vector<float> t1{1.0f, -3.140625f, 1e30f, -1e-30f, 0.0f, 65536.0f};
+    std::vector<float> res1{};
+    HalfFloatContainer r1{10, HalfFloatFormat::BFloat16};
+
+    ctx.createSerializer().ext(t1, r1);
+    ctx.createDeserializer().ext(res1, r1);
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + t1.size() * 2));
+    ASSERT_THAT(res1.size(), Eq(t1.size()));
+    for (size_t i = 0; i < t1.size(); ++i)
+        EXPECT_THAT(res1[i], FloatNear(t1[i], std::fabs(t1[i]) / 128));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionHalfFloat, FixedSizeContainerHasNoSize) {
+    SerializationContext ctx;
+    std::array<float, 300> t1{};
+    for (size_t i = 0; i < t1.size(); ++i)
+        t1[i] = static_cast<float>(i) / 8.0f;
+    std::array<float, 300> res1{};
+
+    ctx.createSerializer().ext(t1, HalfFloatContainer{300});
+    ctx.createDeserializer().ext(res1, HalfFloatContainer{300});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(t1.size() * 2));
+    EXPECT_TRUE(res1 == t1);
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionHalfFloat, WhenSizeIsMoreThanMaxThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<float> t1(10, 1.0f);
+    std::vector<float> res1{};
+
+    ctx.createSerializer().ext(t1, HalfFloatContainer{10});
+    ctx.createDeserializer().ext(res1, HalfFloatContainer{9});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
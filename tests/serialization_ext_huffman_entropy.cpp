@@ -0,0 +1,239 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/ext/huffman_entropy.h>
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+
+using namespace testing;
+
+using bitsery::ext::Entropy;
+using bitsery::ext::HuffmanEntropy;
+using bitsery::ext::HuffmanTable;
+using bitsery::ext::HuffmanTableTrainer;
+
+using BPSer = bitsery::BasicSerializer<bitsery::AdapterWriterBitPackingWrapper<Writer>>;
+using BPDes = bitsery::BasicDeserializer<bitsery::AdapterReaderBitPackingWrapper<Reader>>;
+
+using TableContext = BasicSerializationContext<bitsery::DefaultConfig, HuffmanTable<int32_t>>;
+using TableBPSer = bitsery::BasicSerializer<bitsery::AdapterWriterBitPackingWrapper<TableContext::TWriter>,
+        HuffmanTable<int32_t>>;
+using TableBPDes = bitsery::BasicDeserializer<bitsery::AdapterReaderBitPackingWrapper<TableContext::TReader>,
+        HuffmanTable<int32_t>>;
+
+//skewed data, where each next value is half as likely as previous
+std::vector<int32_t> createSkewedData() {
+    std::vector<int32_t> data{};
+    for (auto i = 0; i < 1024; ++i) {
+        auto v = 0;
+        for (auto x = i; x & 1; x >>= 1)
+            ++v;
+        data.push_back(v * 10);
+    }
+    return data;
+}
+
+TEST(SerializeExtensionHuffmanEntropy, ValuesInTableAndEscapedValues) {
+    std::vector<int32_t> values{5, 10, 15, 20};
+    std::vector<uint64_t> frequencies{100, 50, 20, 1};
+    HuffmanTable<int32_t> table{values, frequencies, 10};
+    std::vector<int32_t> data{5, 10, 15, 20, 5, -8, 5, 1000000};
+    std::vector<int32_t> res{};
+
+    SerializationContext ctx{};
+    ctx.createSerializer().enableBitPacking([&data, &table](BPSer& ser) {
+        ser.container(data, 100, [&ser, &table](int32_t& v) {
+            ser.ext4b(v, HuffmanEntropy<int32_t>{table});
+        });
+    });
+    ctx.createDeserializer().enableBitPacking([&res, &table](BPDes& des) {
+        des.container(res, 100, [&des, &table](int32_t& v) {
+            des.ext4b(v, HuffmanEntropy<int32_t>{table});
+        });
+    });
+    EXPECT_THAT(res, ContainerEq(data));
+    EXPECT_THAT(ctx.br->isCompletedSuccessfully(), Eq(true));
+}
+
+TEST(SerializeExtensionHuffmanEntropy, CopiedTableDoesntDependOnOriginal) {
+    std::vector<int32_t> values{5, 10, 15};
+    std::vector<uint64_t> frequencies{100, 50, 20};
+    std::unique_ptr<HuffmanTable<int32_t>> original{new HuffmanTable<int32_t>{values, frequencies}};
+    HuffmanTable<int32_t> table{*original};
+    original.reset();
+    EXPECT_THAT(table.values(), ContainerEq(values));
+    EXPECT_THAT(table.findSymbol(10), Eq(2u));
+    EXPECT_THAT(table.findSymbol(7), Eq(0u));
+    EXPECT_THAT(table.value(3), Eq(15));
+}
+
+TEST(SerializeExtensionHuffmanEntropy, MoreFrequentValuesHaveShorterOrEqualCodes) {
+    std::vector<int32_t> values{1, 2, 3, 4, 5, 6};
+    std::vector<uint64_t> frequencies{1000, 500, 250, 125, 60, 30};
+    HuffmanTable<int32_t> table{values, frequencies, 5};
+    EXPECT_THAT(table.codeLength(table.findSymbol(1)), Eq(1));
+    for (auto i = 1u; i < values.size(); ++i)
+        EXPECT_THAT(table.codeLength(table.findSymbol(values[i - 1])),
+                    Le(table.codeLength(table.findSymbol(values[i]))));
+    EXPECT_THAT(table.findSymbol(7), Eq(0));
+}
+
+TEST(SerializeExtensionHuffmanEntropy, CodeLengthIsLimited) {
+    //fibonacci frequencies creates the deepest tree
+    std::vector<int32_t> values{};
+    std::vector<uint64_t> frequencies{};
+    uint64_t f1 = 1, f2 = 1;
+    for (auto i = 0; i < 60; ++i) {
+        values.push_back(i);
+        frequencies.push_back(f1);
+        auto tmp = f1 + f2;
+        f1 = f2;
+        f2 = tmp;
+    }
+    HuffmanTable<int32_t> table{values, frequencies};
+    for (auto v:values)
+        EXPECT_THAT(table.codeLength(table.findSymbol(v)), Le(HuffmanTable<int32_t>::MaxCodeLength));
+
+    std::vector<int32_t> res{};
+    SerializationContext ctx{};
+    ctx.createSerializer().enableBitPacking([&values, &table](BPSer& ser) {
+        ser.container(values, 100, [&ser, &table](int32_t& v) {
+            ser.ext4b(v, HuffmanEntropy<int32_t>{table});
+        });
+    });
+    ctx.createDeserializer().enableBitPacking([&res, &table](BPDes& des) {
+        des.container(res, 100, [&des, &table](int32_t& v) {
+            des.ext4b(v, HuffmanEntropy<int32_t>{table});
+        });
+    });
+    EXPECT_THAT(res, ContainerEq(values));
+}
+
+TEST(SerializeExtensionHuffmanEntropy, TableFromContext) {
+    std::vector<int32_t> values{7, 8};
+    std::vector<uint64_t> frequencies{10, 5};
+    HuffmanTable<int32_t> table{values, frequencies, 1};
+    int32_t v = 8;
+    int32_t res{};
+
+    TableContext ctx{};
+    ctx.createSerializer(&table).enableBitPacking([&v](TableBPSer& ser) {
+        ser.ext4b(v, HuffmanEntropy<int32_t>{});
+    });
+    ctx.createDeserializer(&table).enableBitPacking([&res](TableBPDes& des) {
+        des.ext4b(res, HuffmanEntropy<int32_t>{});
+    });
+    EXPECT_THAT(res, Eq(v));
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1));
+}
+
+TEST(SerializeExtensionHuffmanEntropy, TrainerBuildsTableUsingSerializationFlow) {
+    auto data = createSkewedData();
+    HuffmanTableTrainer<int32_t> trainer{};
+    bitsery::BasicSerializer<bitsery::MeasureSize, HuffmanTableTrainer<int32_t>> trainSer{bitsery::MeasureSize{},
+                                                                                       &trainer};
+    trainSer.container(data, 10000, [&trainSer](int32_t& v) {
+        trainSer.ext4b(v, HuffmanEntropy<int32_t>{});
+    });
+    auto table = trainer.build(4);
+
+    EXPECT_THAT(table.values(), ContainerEq(std::vector<int32_t>{0, 10, 20, 30}));
+    EXPECT_THAT(table.frequencies(), ContainerEq(std::vector<uint64_t>{512, 256, 128, 64}));
+    EXPECT_THAT(table.escapeFrequency(), Eq(64));
+
+    std::vector<int32_t> res{};
+    SerializationContext ctx{};
+    ctx.createSerializer().enableBitPacking([&data, &table](BPSer& ser) {
+        ser.container(data, 10000, [&ser, &table](int32_t& v) {
+            ser.ext4b(v, HuffmanEntropy<int32_t>{table});
+        });
+    });
+    ctx.createDeserializer().enableBitPacking([&res, &table](BPDes& des) {
+        des.container(res, 10000, [&des, &table](int32_t& v) {
+            des.ext4b(v, HuffmanEntropy<int32_t>{table});
+        });
+    });
+    EXPECT_THAT(res, ContainerEq(data));
+}
+
+TEST(SerializeExtensionHuffmanEntropy, SkewedDataIsSmallerThanEntropy) {
+    auto data = createSkewedData();
+    HuffmanTableTrainer<int32_t> trainer{};
+    for (auto v:data)
+        trainer.add(v);
+    auto table = trainer.build(8);
+
+    SerializationContext ctx1{};
+    ctx1.createSerializer().enableBitPacking([&data, &table](BPSer& ser) {
+        ser.container(data, 10000, [&ser, &table](int32_t& v) {
+            ser.ext4b(v, HuffmanEntropy<int32_t>{table});
+        });
+    });
+    const auto& values = table.values();
+    SerializationContext ctx2{};
+    ctx2.createSerializer().enableBitPacking([&data, &values](BPSer& ser) {
+        ser.container(data, 10000, [&ser, &values](int32_t& v) {
+            ser.ext(v, Entropy<const std::vector<int32_t>>{values, false}, [&ser](int32_t& v) {
+                ser.value4b(v);
+            });
+        });
+    });
+    EXPECT_THAT(ctx1.getBufferSize() * 3, Lt(ctx2.getBufferSize() * 2));
+}
+
+TEST(SerializeExtensionHuffmanEntropy, CustomTypeWithoutHash) {
+    std::vector<MyStruct1> values{{1, 2}, {3, 4}};
+    std::vector<uint64_t> frequencies{3, 1};
+    HuffmanTable<MyStruct1> table{values, frequencies};
+    MyStruct1 v1{3, 4};
+    MyStruct1 v2{5, 6};
+    MyStruct1 r1{};
+    MyStruct1 r2{};
+
+    SerializationContext ctx{};
+    ctx.createSerializer().enableBitPacking([&v1, &v2, &table](BPSer& ser) {
+        ser.ext(v1, HuffmanEntropy<MyStruct1>{table});
+        ser.ext(v2, HuffmanEntropy<MyStruct1>{table});
+    });
+    ctx.createDeserializer().enableBitPacking([&r1, &r2, &table](BPDes& des) {
+        des.ext(r1, HuffmanEntropy<MyStruct1>{table});
+        des.ext(r2, HuffmanEntropy<MyStruct1>{table});
+    });
+    EXPECT_THAT(r1, Eq(v1));
+    EXPECT_THAT(r2, Eq(v2));
+}
+
+TEST(SerializeExtensionHuffmanEntropy, WhenCodeIsInvalidThenInvalidDataError) {
+    //only escape symbol exists, so its code is single zero bit
+    std::vector<int32_t> values{};
+    std::vector<uint64_t> frequencies{};
+    HuffmanTable<int32_t> table{values, frequencies};
+    int32_t res{};
+
+    SerializationContext ctx{};
+    ctx.createSerializer().value1b(static_cast<uint8_t>(0xFF));
+    ctx.createDeserializer().enableBitPacking([&res, &table](BPDes& des) {
+        des.ext4b(res, HuffmanEntropy<int32_t>{table});
+    });
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
@@ -0,0 +1,188 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/ext/message_router.h>
+#include <bitsery/traits/string.h>
+#include <bitsery/traits/vector.h>
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+
+using testing::Eq;
+using testing::ContainerEq;
+
+struct OrderMsg {
+    OrderMsg() = default;
+
+    OrderMsg(uint64_t id_, int32_t price_, std::string symbol_)
+        : id{id_}, price{price_}, symbol{std::move(symbol_)} {}
+
+    uint64_t id{};
+    int32_t price{};
+    std::string symbol{};
+};
+
+template <typename S>
+void serialize(S& s, OrderMsg& o) {
+    s.value8b(o.id);
+    s.value4b(o.price);
+    s.text1b(o.symbol, 16);
+}
+
+struct CancelMsg {
+    CancelMsg() = default;
+
+    explicit CancelMsg(uint64_t id_) : id{id_} {}
+
+    uint64_t id{};
+};
+
+template <typename S>
+void serialize(S& s, CancelMsg& o) {
+    s.value8b(o.id);
+}
+
+struct BatchMsg {
+    BatchMsg() = default;
+
+    explicit BatchMsg(std::vector<uint32_t> ids_) : ids{std::move(ids_)} {}
+
+    std::vector<uint32_t> ids{};
+};
+
+template <typename S>
+void serialize(S& s, BatchMsg& o) {
+    s.container4b(o.ids, 100);
+}
+
+using Router = bitsery::ext::MessageRouter<OrderMsg, CancelMsg, BatchMsg>;
+
+static_assert(Router::id<OrderMsg>() == 0, "");
+static_assert(Router::id<CancelMsg>() == 1, "");
+static_assert(Router::id<BatchMsg>() == 2, "");
+static_assert(Router::MessagesCount == 3, "");
+
+struct RecordingHandler {
+    std::vector<std::string> log{};
+
+    void operator()(OrderMsg& msg) {
+        log.push_back("order " + std::to_string(msg.id) + " " + std::to_string(msg.price) + " " + msg.symbol);
+    }
+
+    void operator()(CancelMsg& msg) {
+        log.push_back("cancel " + std::to_string(msg.id));
+    }
+
+    void operator()(BatchMsg& msg) {
+        log.push_back("batch " + std::to_string(msg.ids.size()));
+    }
+};
+
+TEST(SerializeExtensionMessageRouter, WritesCompactIdAndMessage) {
+    SerializationContext ctx;
+    Router::write(ctx.createSerializer(), CancelMsg{7});
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1u + 8u));
+    auto& des = ctx.createDeserializer();
+    uint8_t msgId{};
+    uint64_t id{};
+    des.value1b(msgId);
+    des.value8b(id);
+    EXPECT_THAT(msgId, Eq(1u));
+    EXPECT_THAT(id, Eq(7u));
+}
+
+TEST(SerializeExtensionMessageRouter, DispatchesMessagesToHandlerOverloads) {
+    SerializationContext ctx;
+    auto& ser = ctx.createSerializer();
+    Router::write(ser, OrderMsg{1, 100, "ABC"});
+    Router::write(ser, CancelMsg{1});
+    Router::write(ser, BatchMsg{{1, 2, 3}});
+    Router::write(ser, OrderMsg{2, -5, "XY"});
+
+    Router router{};
+    RecordingHandler handler{};
+    EXPECT_THAT(router.readAll(ctx.createDeserializer(), handler), Eq(4u));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+    EXPECT_THAT(handler.log, ContainerEq(std::vector<std::string>{
+        "order 1 100 ABC", "cancel 1", "batch 3", "order 2 -5 XY"}));
+}
+
+TEST(SerializeExtensionMessageRouter, MessageObjectsAreReused) {
+    SerializationContext ctx;
+    auto& ser = ctx.createSerializer();
+    for (uint64_t i = 0; i < 10; ++i)
+        Router::write(ser, OrderMsg{i, 1, "SYMBOL"});
+
+    Router router{};
+    std::vector<const OrderMsg*> objects{};
+    auto count = router.readAll(ctx.createDeserializer(), [&objects](OrderMsg& msg) {
+        objects.push_back(&msg);
+    });
+    EXPECT_THAT(count, Eq(10u));
+    for (auto p: objects)
+        EXPECT_THAT(p, Eq(objects.front()));
+    EXPECT_THAT(router.pool<OrderMsg>().freeCount(), Eq(1u));
+    EXPECT_THAT(router.pool<CancelMsg>().freeCount(), Eq(0u));
+}
+
+TEST(SerializeExtensionMessageRouter, NestedReadUsesAnotherPooledObject) {
+    SerializationContext ctx;
+    auto& ser = ctx.createSerializer();
+    Router::write(ser, CancelMsg{1});
+    Router::write(ser, CancelMsg{2});
+
+    Router router{};
+    auto& des = ctx.createDeserializer();
+    std::vector<uint64_t> ids{};
+    router.read(des, [&](CancelMsg& outer) {
+        router.read(des, [&](CancelMsg& inner) {
+            ids.push_back(inner.id);
+        });
+        ids.push_back(outer.id);
+    });
+    EXPECT_THAT(ids, ContainerEq(std::vector<uint64_t>{2, 1}));
+    EXPECT_THAT(router.pool<CancelMsg>().freeCount(), Eq(2u));
+}
+
+TEST(SerializeExtensionMessageRouter, WhenMessageIdIsUnknownThenInvalidData) {
+    SerializationContext ctx;
+    ctx.createSerializer().value1b(uint8_t{3});
+    Router router{};
+    RecordingHandler handler{};
+    EXPECT_FALSE(router.read(ctx.createDeserializer(), handler));
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_TRUE(handler.log.empty());
+}
+
+TEST(SerializeExtensionMessageRouter, WhenMessageIsInvalidThenHandlerIsNotCalled) {
+    SerializationContext ctx;
+    auto& ser = ctx.createSerializer();
+    ser.value1b(uint8_t{2});
+    //batch size is larger than max size
+    ser.value1b(uint8_t{101});
+    Router router{};
+    RecordingHandler handler{};
+    EXPECT_THAT(router.readAll(ctx.createDeserializer(), handler), Eq(0u));
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_TRUE(handler.log.empty());
+    EXPECT_THAT(router.pool<BatchMsg>().freeCount(), Eq(1u));
+}
@@ -0,0 +1,384 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <algorithm>
+#include <bitsery/ext/persistent_pointer.h>
+#include <bitsery/traits/vector.h>
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+
+using bitsery::ext::PersistentPointerLinkingContext;
+using bitsery::ext::PersistentSharedPtr;
+
+using testing::Eq;
+using testing::Ne;
+
+using SerContext = BasicSerializationContext<bitsery::DefaultConfig, PersistentPointerLinkingContext>;
+
+struct PNode {
+    int32_t value{};
+    std::shared_ptr<PNode> next{};
+};
+
+template<typename S>
+void serialize(S &s, PNode &o) {
+    s.value4b(o.value);
+    s.ext(o.next, PersistentSharedPtr{});
+}
+
+struct PVersioned {
+    uint32_t ver{};
+    int32_t value{};
+
+    uint32_t version() const {
+        return ver;
+    }
+};
+
+template<typename S>
+void serialize(S &s, PVersioned &o) {
+    s.value4b(o.value);
+}
+
+struct PGraph {
+    std::vector<std::shared_ptr<PNode>> nodes{};
+};
+
+template<typename S>
+void serialize(S &s, PGraph &o) {
+    s.container(o.nodes, 1000, [&s](std::shared_ptr<PNode> &n) {
+        s.ext(n, PersistentSharedPtr{});
+    });
+}
+
+class SerializeExtensionPersistentPointer : public testing::Test {
+public:
+    PersistentPointerLinkingContext sender{};
+    PersistentPointerLinkingContext receiver{};
+
+    //sends one message and returns its size
+    template<typename T>
+    size_t send(const T &data, T &res) {
+        SerContext ctx{};
+        ctx.createSerializer(&sender).object(data);
+        auto size = ctx.getBufferSize();
+        auto &des = ctx.createDeserializer(&receiver);
+        des.object(res);
+        EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::NoError));
+        return size;
+    }
+};
+
+TEST_F(SerializeExtensionPersistentPointer, NullPointer) {
+    std::shared_ptr<PNode> data{};
+    auto res = std::make_shared<PNode>();
+    SerContext ctx{};
+    ctx.createSerializer(&sender).ext(data, PersistentSharedPtr{});
+    ctx.createDeserializer(&receiver).ext(res, PersistentSharedPtr{});
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1u));
+    EXPECT_THAT(res, Eq(nullptr));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, UnchangedObjectsAreSentAsIdOnly) {
+    PGraph data{};
+    for (auto i = 0; i < 10; ++i) {
+        data.nodes.push_back(std::make_shared<PNode>());
+        data.nodes.back()->value = i;
+    }
+    PGraph res{};
+    auto first = send(data, res);
+    ASSERT_THAT(res.nodes.size(), Eq(10u));
+    EXPECT_THAT(res.nodes[9]->value, Eq(9));
+    auto received = res.nodes[3];
+
+    PGraph res2{};
+    auto second = send(data, res2);
+    EXPECT_THAT(second, Eq(1u + 10u));
+    EXPECT_THAT(second, ::testing::Lt(first));
+    //same instances as in previous message
+    EXPECT_THAT(res2.nodes[3], Eq(received));
+    EXPECT_THAT(receiver.receivedObjectsCount(), Eq(10u));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, SameObjectInOneMessageIsSentOnce) {
+    auto node = std::make_shared<PNode>();
+    node->value = 7;
+    PGraph data{};
+    data.nodes = {node, node, node};
+    PGraph res{};
+    auto size = send(data, res);
+    //container size, 3 ids, value and null next
+    EXPECT_THAT(size, Eq(1u + 3u + 4u + 1u));
+    EXPECT_THAT(res.nodes[0], Eq(res.nodes[1]));
+    EXPECT_THAT(res.nodes[0], Eq(res.nodes[2]));
+    EXPECT_THAT(res.nodes[0]->value, Eq(7));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, MarkedChangedObjectIsUpdatedInPlace) {
+    PGraph data{};
+    data.nodes.push_back(std::make_shared<PNode>());
+    data.nodes.push_back(std::make_shared<PNode>());
+    PGraph res{};
+    send(data, res);
+    auto received = res.nodes[1];
+
+    data.nodes[0]->value = 1;
+    data.nodes[1]->value = 2;
+    sender.markChanged(data.nodes[1]);
+    PGraph res2{};
+    auto size = send(data, res2);
+    EXPECT_THAT(size, Eq(1u + 1u + 1u + 4u + 1u));
+    //not marked, so change is not sent
+    EXPECT_THAT(res2.nodes[0]->value, Eq(0));
+    EXPECT_THAT(res2.nodes[1], Eq(received));
+    EXPECT_THAT(received->value, Eq(2));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, VersionedObjectIsResentWhenVersionChanges) {
+    auto data = std::make_shared<PVersioned>();
+    data->value = 5;
+    std::shared_ptr<PVersioned> res{};
+    auto sendOne = [this, &data, &res]() {
+        SerContext ctx{};
+        ctx.createSerializer(&sender).ext(data, PersistentSharedPtr{});
+        ctx.createDeserializer(&receiver).ext(res, PersistentSharedPtr{});
+        EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::NoError));
+        return ctx.getBufferSize();
+    };
+    EXPECT_THAT(sendOne(), Eq(5u));
+    data->value = 6;
+    EXPECT_THAT(sendOne(), Eq(1u));
+    EXPECT_THAT(res->value, Eq(5));
+    ++data->ver;
+    EXPECT_THAT(sendOne(), Eq(5u));
+    EXPECT_THAT(res->value, Eq(6));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, CyclesAreResolved) {
+    auto a = std::make_shared<PNode>();
+    auto b = std::make_shared<PNode>();
+    a->value = 1;
+    a->next = b;
+    b->value = 2;
+    b->next = a;
+    PGraph data{};
+    data.nodes = {a};
+    PGraph res{};
+    send(data, res);
+    auto ra = res.nodes[0];
+    ASSERT_THAT(ra->next, Ne(nullptr));
+    EXPECT_THAT(ra->next->value, Eq(2));
+    EXPECT_THAT(ra->next->next, Eq(ra));
+
+    //only b changes, a is referenced by id
+    b->value = 3;
+    sender.markChanged(b);
+    PGraph res2{};
+    data.nodes = {b};
+    auto size = send(data, res2);
+    EXPECT_THAT(size, Eq(1u + 1u + 4u + 1u));
+    EXPECT_THAT(res2.nodes[0], Eq(ra->next));
+    EXPECT_THAT(ra->next->value, Eq(3));
+    //break cycles
+    a->next.reset();
+    ra->next->next.reset();
+}
+
+TEST_F(SerializeExtensionPersistentPointer, ReleasedObjectsAreEvicted) {
+    PGraph data{};
+    data.nodes.push_back(std::make_shared<PNode>());
+    data.nodes.push_back(std::make_shared<PNode>());
+    PGraph res{};
+    send(data, res);
+    std::weak_ptr<PNode> received = res.nodes[0];
+    res.nodes.clear();
+
+    sender.release(data.nodes[0]);
+    EXPECT_THAT(sender.sentObjectsCount(), Eq(1u));
+    auto evicted = sender.takeEvictions();
+    EXPECT_THAT(evicted, Eq(std::vector<uint64_t>{1u}));
+    EXPECT_THAT(sender.takeEvictions().empty(), Eq(true));
+    receiver.evict(evicted.begin(), evicted.end());
+    EXPECT_THAT(receiver.receivedObjectsCount(), Eq(1u));
+    EXPECT_THAT(received.expired(), Eq(true));
+
+    //released object is sent again in full
+    PGraph res2{};
+    send(data, res2);
+    EXPECT_THAT(res2.nodes[0], Ne(nullptr));
+    EXPECT_THAT(receiver.receivedObjectsCount(), Eq(2u));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, EvictedIdsAreReused) {
+    PGraph data{};
+    for (auto i = 0; i < 3; ++i)
+        data.nodes.push_back(std::make_shared<PNode>());
+    PGraph res{};
+    send(data, res);
+    std::weak_ptr<PNode> received = res.nodes[1];
+    res.nodes.clear();
+
+    sender.release(data.nodes[1]);
+    auto evicted = sender.takeEvictions();
+    EXPECT_THAT(evicted, Eq(std::vector<uint64_t>{2u}));
+    receiver.evict(evicted.begin(), evicted.end());
+
+    //new object gets evicted id, and it is received as new instance
+    data.nodes = {std::make_shared<PNode>()};
+    data.nodes[0]->value = 5;
+    PGraph res2{};
+    auto size = send(data, res2);
+    //container size + id with flag + value + null next
+    EXPECT_THAT(size, Eq(1u + 1u + 4u + 1u));
+    ASSERT_THAT(res2.nodes.size(), Eq(1u));
+    EXPECT_THAT(res2.nodes[0]->value, Eq(5));
+    EXPECT_THAT(received.expired(), Eq(true));
+    EXPECT_THAT(receiver.receivedObjectsCount(), Eq(3u));
+
+    //ids are not growing while objects are replaced
+    for (auto i = 0; i < 200; ++i) {
+        sender.release(data.nodes[0]);
+        evicted = sender.takeEvictions();
+        EXPECT_THAT(evicted, Eq(std::vector<uint64_t>{2u}));
+        receiver.evict(evicted.begin(), evicted.end());
+        data.nodes = {std::make_shared<PNode>()};
+        PGraph res3{};
+        send(data, res3);
+    }
+    EXPECT_THAT(receiver.receivedObjectsCount(), Eq(3u));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, WhenAllIdsAreInUseThenNewObjectIsWrittenAsNull) {
+    PersistentPointerLinkingContext limited{2};
+    PGraph data{};
+    for (auto i = 0; i < 3; ++i)
+        data.nodes.push_back(std::make_shared<PNode>());
+    PGraph res{};
+    {
+        SerContext ctx{};
+        ctx.createSerializer(&limited).object(data);
+        ctx.createDeserializer(&receiver).object(res);
+        EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::NoError));
+    }
+    EXPECT_FALSE(limited.isValid());
+    ASSERT_THAT(res.nodes.size(), Eq(3u));
+    EXPECT_THAT(res.nodes[1], Ne(nullptr));
+    EXPECT_THAT(res.nodes[2], Eq(nullptr));
+
+    //after eviction id is available again
+    limited.release(data.nodes[0]);
+    auto evicted = limited.takeEvictions();
+    receiver.evict(evicted.begin(), evicted.end());
+    data.nodes.erase(data.nodes.begin());
+    data.nodes[1]->value = 7;
+    SerContext ctx{};
+    ctx.createSerializer(&limited).object(data);
+    ctx.createDeserializer(&receiver).object(res);
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::NoError));
+    ASSERT_THAT(res.nodes.size(), Eq(2u));
+    ASSERT_THAT(res.nodes[1], Ne(nullptr));
+    EXPECT_THAT(res.nodes[1]->value, Eq(7));
+    limited.reset();
+    EXPECT_TRUE(limited.isValid());
+}
+
+TEST_F(SerializeExtensionPersistentPointer, CollectEvictsDestroyedObjects) {
+    PGraph data{};
+    for (auto i = 0; i < 4; ++i)
+        data.nodes.push_back(std::make_shared<PNode>());
+    PGraph res{};
+    send(data, res);
+    data.nodes.erase(data.nodes.begin() + 1, data.nodes.begin() + 3);
+    EXPECT_THAT(sender.collect(), Eq(2u));
+    EXPECT_THAT(sender.collect(), Eq(0u));
+    auto evicted = sender.takeEvictions();
+    std::sort(evicted.begin(), evicted.end());
+    EXPECT_THAT(evicted, Eq(std::vector<uint64_t>{2u, 3u}));
+    receiver.evict(evicted.begin(), evicted.end());
+    EXPECT_THAT(receiver.receivedObjectsCount(), Eq(2u));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, DestroyedObjectAddressIsNotReused) {
+    std::shared_ptr<PVersioned> res{};
+    auto sendOne = [this, &res](const std::shared_ptr<PVersioned>& data) {
+        SerContext ctx{};
+        ctx.createSerializer(&sender).ext(data, PersistentSharedPtr{});
+        ctx.createDeserializer(&receiver).ext(res, PersistentSharedPtr{});
+        return ctx.getBufferSize();
+    };
+    auto data = std::make_shared<PVersioned>();
+    data->value = 1;
+    sendOne(data);
+    data.reset();
+    //may or may not get the same address
+    data = std::make_shared<PVersioned>();
+    data->value = 2;
+    EXPECT_THAT(sendOne(data), Eq(5u));
+    EXPECT_THAT(res->value, Eq(2));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, UnknownIdIsInvalidPointer) {
+    auto data = std::make_shared<PNode>();
+    std::shared_ptr<PNode> res{};
+    {
+        SerContext ctx{};
+        ctx.createSerializer(&sender).ext(data, PersistentSharedPtr{});
+        ctx.createDeserializer(&receiver).ext(res, PersistentSharedPtr{});
+    }
+    receiver.reset();
+    SerContext ctx{};
+    ctx.createSerializer(&sender).ext(data, PersistentSharedPtr{});
+    ctx.createDeserializer(&receiver).ext(res, PersistentSharedPtr{});
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidPointer));
+    EXPECT_THAT(res, Eq(nullptr));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, WhenEvictionIsMissedThenIdOfOtherTypeIsInvalidPointer) {
+    auto node = std::make_shared<PNode>();
+    std::shared_ptr<PNode> resNode{};
+    {
+        SerContext ctx{};
+        ctx.createSerializer(&sender).ext(node, PersistentSharedPtr{});
+        ctx.createDeserializer(&receiver).ext(resNode, PersistentSharedPtr{});
+    }
+    sender.release(node);
+    //evictions are not passed to receiver
+    sender.takeEvictions();
+    auto data = std::make_shared<PVersioned>();
+    std::shared_ptr<PVersioned> res{};
+    SerContext ctx{};
+    ctx.createSerializer(&sender).ext(data, PersistentSharedPtr{});
+    ctx.createDeserializer(&receiver).ext(res, PersistentSharedPtr{});
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidPointer));
+    EXPECT_THAT(res, Eq(nullptr));
+}
+
+TEST_F(SerializeExtensionPersistentPointer, ValueOverload) {
+    auto data = std::make_shared<int32_t>(-9);
+    std::shared_ptr<int32_t> res{};
+    SerContext ctx{};
+    ctx.createSerializer(&sender).ext4b(data, PersistentSharedPtr{});
+    ctx.createDeserializer(&receiver).ext4b(res, PersistentSharedPtr{});
+    ASSERT_THAT(res, Ne(nullptr));
+    EXPECT_THAT(*res, Eq(-9));
+}
@@ -0,0 +1,251 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include <bitsery/ext/roaring_set.h>
+#include <gmock/gmock.h>
+#include <random>
+#include <functional>
+#include <set>
+#include "serialization_test_utils.h"
+
+using namespace testing;
+using bitsery::ext::RoaringSet;
+using bitsery::ext::RoaringBitmap;
+
+namespace {
+    //values from all three chunk representations
+    std::set<uint32_t> makeMixedSet() {
+        std::mt19937 rng{7};
+        std::set<uint32_t> res{};
+        //sparse chunk -> array
+        for (auto i = 0; i < 100; ++i)
+            res.insert(rng() % 65536);
+        //dense random chunk -> bitmap
+        for (auto i = 0; i < 30000; ++i)
+            res.insert(65536 * 3 + rng() % 65536);
+        //consecutive ranges -> runs
+        for (uint32_t i = 0; i < 40000; ++i)
+            res.insert(65536 * 7 + 100 + i);
+        for (uint32_t i = 0; i < 50; ++i)
+            res.insert(65536 * 8 + i * 1000);
+        //last possible chunk
+        res.insert(0xFFFFFFFFu);
+        res.insert(0xFFFF0000u);
+        return res;
+    }
+}
+
+template<typename T>
+class SerializeExtensionRoaringSetTyped : public testing::Test {
+public:
+    using TContainer = T;
+    const std::set<uint32_t> values = makeMixedSet();
+    const TContainer src{values.begin(), values.end()};
+    TContainer res{1, 2, 3};
+};
+
+using RoaringSetTypes = ::testing::Types<std::set<uint32_t>, std::unordered_set<uint32_t>,
+        std::multiset<uint32_t>, std::set<uint32_t, std::greater<uint32_t>>>;
+
+TYPED_TEST_CASE(SerializeExtensionRoaringSetTyped, RoaringSetTypes);
+
+TYPED_TEST(SerializeExtensionRoaringSetTyped, RoundTrip) {
+    SerializationContext ctx;
+
+    ctx.createSerializer().ext(this->src, RoaringSet{1000000});
+    ctx.createDeserializer().ext(this->res, RoaringSet{1000000});
+
+    EXPECT_TRUE(this->res == this->src);
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionRoaringSet, EmptySet) {
+    SerializationContext ctx;
+    std::set<uint32_t> t1{};
+    std::set<uint32_t> res1{1};
+
+    ctx.createSerializer().ext(t1, RoaringSet{10});
+    ctx.createDeserializer().ext(res1, RoaringSet{10});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(2));
+    EXPECT_TRUE(res1.empty());
+}
+
+TEST(SerializeExtensionRoaringSet, DenseValuesAreWrittenAsBitmap) {
+    SerializationContext ctx;
+    std::set<uint32_t> t1{};
+    for (uint32_t i = 0; i < 65536; ++i)
+        t1.insert(i * 2);
+    std::set<uint32_t> res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{100000});
+    ctx.createDeserializer().ext(res1, RoaringSet{100000});
+
+    //size + chunks count + 2 bitmap chunks with key and type
+    EXPECT_THAT(ctx.getBufferSize(), Eq(4 + 1 + 2 * (3 + 8192)));
+    EXPECT_TRUE(res1 == t1);
+}
+
+TEST(SerializeExtensionRoaringSet, ConsecutiveValuesAreWrittenAsRuns) {
+    SerializationContext ctx;
+    std::set<uint32_t> t1{};
+    for (uint32_t i = 1000; i < 60000; ++i)
+        t1.insert(i);
+    std::set<uint32_t> res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{100000});
+    ctx.createDeserializer().ext(res1, RoaringSet{100000});
+
+    //size + chunks count + key + type + runs count + run
+    EXPECT_THAT(ctx.getBufferSize(), Eq(4 + 1 + 2 + 1 + 1 + 4));
+    EXPECT_TRUE(res1 == t1);
+}
+
+TEST(SerializeExtensionRoaringSet, DuplicatesInMultisetAreWrittenOnce) {
+    SerializationContext ctx;
+    std::multiset<uint32_t> t1{1, 1, 2, 70000, 70000, 70001};
+    std::set<uint32_t> res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{10});
+    ctx.createDeserializer().ext(res1, RoaringSet{10});
+
+    EXPECT_THAT(res1, ContainerEq(std::set<uint32_t>{1, 2, 70000, 70001}));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionRoaringSet, Uint16Values) {
+    SerializationContext ctx;
+    std::set<uint16_t> t1{0, 5, 6, 7, 65535};
+    std::set<uint16_t> res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{10});
+    ctx.createDeserializer().ext(res1, RoaringSet{10});
+
+    EXPECT_TRUE(res1 == t1);
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionRoaringSet, DeserializeToBitmapView) {
+    SerializationContext ctx;
+    const auto t1 = makeMixedSet();
+    RoaringBitmap res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{1000000});
+    ctx.createDeserializer().ext(res1, RoaringSet{1000000});
+
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+    EXPECT_THAT(res1.size(), Eq(t1.size()));
+    EXPECT_THAT(res1.chunksCount(), Eq(5u));
+    std::vector<uint32_t> values{};
+    res1.forEach([&values](uint32_t v) { values.push_back(v); });
+    ASSERT_THAT(values.size(), Eq(t1.size()));
+    EXPECT_TRUE(std::equal(values.begin(), values.end(), t1.begin()));
+
+    std::mt19937 rng{1};
+    for (auto i = 0; i < 100000; ++i) {
+        const auto v = i % 2 ? rng() : static_cast<uint32_t>(rng() % (65536 * 9));
+        ASSERT_THAT(res1.contains(v), Eq(t1.count(v) == 1)) << v;
+    }
+    for (auto v: t1)
+        ASSERT_TRUE(res1.contains(v)) << v;
+}
+
+TEST(SerializeExtensionRoaringSet, SerializeBitmapView) {
+    SerializationContext ctx1;
+    const auto t1 = makeMixedSet();
+    RoaringBitmap view{};
+    ctx1.createSerializer().ext(t1, RoaringSet{1000000});
+    ctx1.createDeserializer().ext(view, RoaringSet{1000000});
+
+    SerializationContext ctx2;
+    std::set<uint32_t> res1{};
+    ctx2.createSerializer().ext(view, RoaringSet{1000000});
+    ctx2.createDeserializer().ext(res1, RoaringSet{1000000});
+
+    EXPECT_THAT(ctx2.getBufferSize(), Eq(ctx1.getBufferSize()));
+    EXPECT_TRUE(res1 == t1);
+}
+
+TEST(SerializeExtensionRoaringSet, WhenSizeIsMoreThanMaxThenInvalidDataError) {
+    SerializationContext ctx;
+    std::set<uint32_t> t1{1, 2, 3};
+    std::set<uint32_t> res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{3});
+    ctx.createDeserializer().ext(res1, RoaringSet{2});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionRoaringSet, WhenSizeDoesntMatchValuesThenInvalidDataError) {
+    SerializationContext ctx;
+    std::set<uint32_t> t1{1, 2, 3};
+    RoaringBitmap res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{10});
+    ctx.buf[0] = 4;
+    ctx.createDeserializer().ext(res1, RoaringSet{10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_TRUE(res1.empty());
+}
+
+TEST(SerializeExtensionRoaringSet, WhenChunksCountDoesntMatchSizeThenInvalidDataError) {
+    std::set<uint32_t> t1{1, 2};
+    //chunks count is second byte, after size
+    for (uint8_t chunks: {uint8_t{3}, uint8_t{0}}) {
+        SerializationContext ctx;
+        RoaringBitmap res1{};
+        ctx.createSerializer().ext(t1, RoaringSet{10});
+        ctx.buf[1] = chunks;
+        ctx.createDeserializer().ext(res1, RoaringSet{10});
+
+        EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+        EXPECT_TRUE(res1.empty());
+        EXPECT_THAT(res1.chunksCount(), Eq(0u));
+    }
+}
+
+TEST(SerializeExtensionRoaringSet, WhenArrayIsNotSortedThenInvalidDataError) {
+    SerializationContext ctx;
+    std::set<uint32_t> t1{1, 5, 9};
+    std::set<uint32_t> res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{10});
+    //size, chunks count, key, type, count, then values
+    ctx.buf[6] = 10;
+    ctx.createDeserializer().ext(res1, RoaringSet{10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionRoaringSet, WhenChunkKeyIsOutOfRangeForUint16ThenInvalidDataError) {
+    SerializationContext ctx;
+    std::set<uint32_t> t1{65536};
+    std::set<uint16_t> res1{};
+
+    ctx.createSerializer().ext(t1, RoaringSet{10});
+    ctx.createDeserializer().ext(res1, RoaringSet{10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
@@ -0,0 +1,223 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include <bitsery/ext/run_length.h>
+#include <bitsery/traits/array.h>
+#include <bitsery/traits/list.h>
+#include <gmock/gmock.h>
+#include <cmath>
+#include "serialization_test_utils.h"
+
+using namespace testing;
+using bitsery::ext::BasicRunLength;
+using bitsery::ext::RunLength;
+
+template<typename T>
+class SerializeExtensionRunLengthTyped : public testing::Test {
+};
+
+TYPED_TEST_CASE(SerializeExtensionRunLengthTyped, FundamentalValueTypes);
+
+TYPED_TEST(SerializeExtensionRunLengthTyped, RoundTripForDifferentRunLengths) {
+    uint32_t seed{};
+    for (size_t maxRun: {1u, 3u, 40u, 1000u, 100000u}) {
+        SerializationContext ctx;
+        auto t1 = makeValueRuns<TypeParam>(5000, maxRun, maxRun / 2, ++seed);
+        std::vector<TypeParam> res1(3);
+
+        ctx.createSerializer().template ext<sizeof(TypeParam)>(t1, RunLength{5000});
+        ctx.createDeserializer().template ext<sizeof(TypeParam)>(res1, RunLength{5000});
+
+        EXPECT_THAT(res1, ContainerEq(t1)) << maxRun;
+        EXPECT_TRUE(ctx.br->isCompletedSuccessfully()) << maxRun;
+    }
+}
+
+TEST(SerializeExtensionRunLength, WritesLengthAndValueForEachRun) {
+    SerializationContext ctx;
+    std::vector<uint16_t> t1{5, 5, 5, 7};
+    t1.insert(t1.end(), 200, 9);
+    std::vector<uint16_t> res1{};
+
+    ctx.createSerializer().ext2b(t1, RunLength{1000});
+    ctx.createDeserializer().ext2b(res1, RunLength{1000});
+
+    //size + mode + (1 byte length + value) * 2 + (2 bytes length + value)
+    EXPECT_THAT(ctx.getBufferSize(), Eq(2 + 1 + 3 * 2 + 2 + 2));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionRunLength, FixedSizeContainerHasNoSize) {
+    SerializationContext ctx;
+    std::array<uint8_t, 64> t1{};
+    t1[63] = 1;
+    std::array<uint8_t, 64> res1{};
+    res1.fill(5);
+
+    ctx.createSerializer().ext1b(t1, RunLength{64});
+    ctx.createDeserializer().ext1b(res1, RunLength{64});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 4));
+    EXPECT_TRUE(res1 == t1);
+}
+
+TEST(SerializeExtensionRunLength, FloatsAreComparedBitwise) {
+    SerializationContext ctx;
+    std::vector<float> t1{0.0f, 0.0f, -0.0f, -0.0f};
+    std::vector<float> res1{};
+
+    ctx.createSerializer().ext4b(t1, RunLength{10});
+    ctx.createDeserializer().ext4b(res1, RunLength{10});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 1 + 2 * 5));
+    EXPECT_FALSE(std::signbit(res1[1]));
+    EXPECT_TRUE(std::signbit(res1[2]));
+}
+
+TEST(SerializeExtensionRunLength, NonContiguousContainer) {
+    SerializationContext ctx;
+    std::list<int32_t> t1(100, 3);
+    t1.push_back(4);
+    t1.insert(t1.end(), 5, 3);
+    std::list<int32_t> res1{};
+
+    ctx.createSerializer().ext4b(t1, RunLength{1000});
+    ctx.createDeserializer().ext4b(res1, RunLength{1000});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 1 + 3 * 5));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionRunLength, ObjectsAreSerializedOncePerRun) {
+    SerializationContext ctx;
+    std::vector<MyStruct1> t1(30, MyStruct1{1, 2});
+    t1.emplace_back(3, 4);
+    t1.insert(t1.end(), 10, MyStruct1{1, 2});
+    std::vector<MyStruct1> res1{};
+
+    ctx.createSerializer().ext(t1, RunLength{100});
+    ctx.createDeserializer().ext(res1, RunLength{100});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 1 + 3 * (1 + MyStruct1::SIZE)));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionRunLength, CustomComparatorAndLambda) {
+    SerializationContext ctx;
+    std::vector<MyStruct1> t1{{1, 2}, {1, 3}, {1, 4}, {2, 2}};
+    std::vector<MyStruct1> res1{};
+    auto sameFirst = [](const MyStruct1 &lhs, const MyStruct1 &rhs) { return lhs.i1 == rhs.i1; };
+    BasicRunLength<decltype(sameFirst)> r1{10, sameFirst};
+
+    ctx.createSerializer().ext(t1, r1, [](MyStruct1 &v) {
+        //only first element of a run is serialized
+        EXPECT_THAT(v.i2, Eq(2));
+    });
+    ctx.createDeserializer().ext(res1, r1, [](MyStruct1 &v) {
+        v.i2 = 5;
+    });
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 1 + 2));
+    EXPECT_THAT(res1, ElementsAre(MyStruct1{0, 5}, MyStruct1{0, 5}, MyStruct1{0, 5}, MyStruct1{0, 5}));
+}
+
+TEST(SerializeExtensionRunLength, ValuesWithoutRunsAreWrittenDensely) {
+    SerializationContext ctx;
+    std::vector<uint16_t> t1{1, 2, 3, 3, 4, 5};
+    std::vector<uint16_t> res1{};
+
+    ctx.createSerializer().ext2b(t1, RunLength{10});
+    ctx.createDeserializer().ext2b(res1, RunLength{10});
+
+    //size + mode + values
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 1 + 6 * 2));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionRunLength, NonContiguousValuesWithoutRunsAreWrittenDensely) {
+    SerializationContext ctx;
+    std::list<int32_t> t1{1, 2, 3, 4};
+    std::list<int32_t> res1{};
+
+    ctx.createSerializer().ext4b(t1, RunLength{10});
+    ctx.createDeserializer().ext4b(res1, RunLength{10});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 1 + 4 * 4));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionRunLength, ObjectsWithoutRunsAreWrittenDensely) {
+    SerializationContext ctx;
+    std::vector<MyStruct1> t1{{1, 2}, {1, 2}, {3, 4}, {5, 6}};
+    std::vector<MyStruct1> res1{};
+
+    ctx.createSerializer().ext(t1, RunLength{10});
+    ctx.createDeserializer().ext(res1, RunLength{10});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 1 + 4 * MyStruct1::SIZE));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionRunLength, WhenModeIsInvalidThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<uint8_t> t1{1, 1, 1, 1, 2};
+    std::vector<uint8_t> res1{};
+    ctx.createSerializer().ext1b(t1, RunLength{10});
+    ctx.buf[1] = 2;
+    ctx.createDeserializer().ext1b(res1, RunLength{10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionRunLength, WhenRunIsLongerThanContainerThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<uint8_t> t1{1, 1, 1, 1, 2};
+    std::vector<uint8_t> res1{};
+    ctx.createSerializer().ext1b(t1, RunLength{10});
+    ctx.buf[2] = 6;
+    ctx.createDeserializer().ext1b(res1, RunLength{10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionRunLength, WhenRunIsEmptyThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<uint8_t> t1{1, 1, 1, 1, 2};
+    std::vector<uint8_t> res1{};
+    ctx.createSerializer().ext1b(t1, RunLength{10});
+    ctx.buf[2] = 0;
+    ctx.createDeserializer().ext1b(res1, RunLength{10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionRunLength, WhenSizeIsMoreThanMaxThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<uint8_t> t1(10);
+    std::vector<uint8_t> res1{};
+
+    ctx.createSerializer().ext1b(t1, RunLength{10});
+    ctx.createDeserializer().ext1b(res1, RunLength{9});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
@@ -0,0 +1,200 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include <bitsery/ext/sparse.h>
+#include <bitsery/traits/array.h>
+#include <bitsery/traits/list.h>
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+
+using namespace testing;
+using bitsery::ext::Sparse;
+
+template<typename T>
+class SerializeExtensionSparseTyped : public testing::Test {
+};
+
+TYPED_TEST_CASE(SerializeExtensionSparseTyped, FundamentalValueTypes);
+
+TYPED_TEST(SerializeExtensionSparseTyped, RoundTripForAllDensities) {
+    for (size_t every: {1u, 2u, 7u, 50u, 1000u, 100000u}) {
+        SerializationContext ctx;
+        auto t1 = makeValueRuns<TypeParam>(3000, 1, every - 1, static_cast<uint32_t>(every));
+        std::vector<TypeParam> res1(5, static_cast<TypeParam>(1));
+
+        ctx.createSerializer().ext(t1, Sparse{3000});
+        ctx.createDeserializer().ext(res1, Sparse{3000});
+
+        EXPECT_THAT(res1, ContainerEq(t1)) << every;
+        EXPECT_TRUE(ctx.br->isCompletedSuccessfully()) << every;
+        EXPECT_THAT(ctx.getBufferSize(), Le(2 + 1 + t1.size() * sizeof(TypeParam))) << every;
+    }
+}
+
+TEST(SerializeExtensionSparse, EmptyContainer) {
+    SerializationContext ctx;
+    std::vector<int32_t> t1{};
+    std::vector<int32_t> res1{1, 2, 3};
+
+    ctx.createSerializer().ext(t1, Sparse{10});
+    ctx.createDeserializer().ext(res1, Sparse{10});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(2));
+    EXPECT_THAT(res1, ContainerEq(t1));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionSparse, DenseContainerHasOneByteOverhead) {
+    SerializationContext ctx;
+    std::array<int32_t, 100> t1{};
+    for (size_t i = 0; i < t1.size(); ++i)
+        t1[i] = static_cast<int32_t>(i + 1);
+    std::array<int32_t, 100> res1{};
+
+    ctx.createSerializer().ext(t1, Sparse{100});
+    ctx.createDeserializer().ext(res1, Sparse{100});
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + 100 * 4));
+    EXPECT_TRUE(res1 == t1);
+}
+
+TEST(SerializeExtensionSparse, HalfFilledContainerUsesBitmap) {
+    SerializationContext ctx;
+    auto t1 = makeValueRuns<int>(1000, 1, 1, 1);
+    std::vector<int> res1{};
+
+    ctx.createSerializer().ext(t1, Sparse{1000});
+    ctx.createDeserializer().ext(res1, Sparse{1000});
+
+    //size + mode + bitmap + values
+    EXPECT_THAT(ctx.getBufferSize(), Eq(2 + 1 + 125 + 500 * 4));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionSparse, VerySparseContainerUsesIndices) {
+    SerializationContext ctx;
+    auto t1 = makeValueRuns<int>(1000, 1, 99, 1);
+    std::vector<int> res1{};
+
+    ctx.createSerializer().ext(t1, Sparse{1000});
+    ctx.createDeserializer().ext(res1, Sparse{1000});
+
+    //size + mode + count + deltas + values
+    EXPECT_THAT(ctx.getBufferSize(), Eq(2 + 1 + 1 + 10 + 10 * 4));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionSparse, NegativeZeroIsNotDefault) {
+    SerializationContext ctx;
+    std::vector<float> t1(100);
+    t1[10] = -0.0f;
+    std::vector<float> res1{};
+
+    ctx.createSerializer().ext(t1, Sparse{100});
+    ctx.createDeserializer().ext(res1, Sparse{100});
+
+    EXPECT_TRUE(std::signbit(res1[10]));
+    EXPECT_FALSE(std::signbit(res1[11]));
+}
+
+TEST(SerializeExtensionSparse, NonRandomAccessContainer) {
+    SerializationContext ctx;
+    std::list<int> t1(700);
+    *std::next(t1.begin(), 3) = 1;
+    *std::next(t1.begin(), 300) = 2;
+    t1.back() = 3;
+    std::list<int> res1{};
+
+    ctx.createSerializer().ext(t1, Sparse{1000});
+    ctx.createDeserializer().ext(res1, Sparse{1000});
+
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionSparse, WhenSizeIsMoreThanMaxThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<int> t1(10);
+    std::vector<int> res1{};
+
+    ctx.createSerializer().ext(t1, Sparse{10});
+    ctx.createDeserializer().ext(res1, Sparse{9});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionSparse, WhenModeIsInvalidThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<int> res1{};
+    ctx.createSerializer().ext(std::vector<int>(3), Sparse{10});
+    ctx.buf[1] = 3;
+    ctx.createDeserializer().ext(res1, Sparse{10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionSparse, WhenIndexIsOutOfRangeThenInvalidDataError) {
+    SerializationContext ctx;
+    auto t1 = makeValueRuns<int>(1000, 1, 99, 1);
+    std::vector<int> res1{};
+    ctx.createSerializer().ext(t1, Sparse{1000});
+    //shift all indices, so that last one points past the end
+    ctx.buf[2 + 1 + 1] = 127;
+    ctx.createDeserializer().ext(res1, Sparse{1000});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionSparse, WhenBitmapHasBitsAfterEndThenInvalidDataError) {
+    SerializationContext ctx;
+    auto t1 = makeValueRuns<int>(10, 1, 1, 1);
+    std::vector<int> res1{};
+    ctx.createSerializer().ext(t1, Sparse{10});
+    ctx.buf[1 + 1 + 1] |= 0x80;
+    ctx.createDeserializer().ext(res1, Sparse{10});
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_THAT(res1, Eq(std::vector<int>(10)));
+}
+
+TEST(SerializeExtensionSparse, WorksWithBitPackingEnabled) {
+    using BPSer = bitsery::BasicSerializer<bitsery::AdapterWriterBitPackingWrapper<Writer>>;
+    using BPDes = bitsery::BasicDeserializer<bitsery::AdapterReaderBitPackingWrapper<Reader>>;
+    SerializationContext ctx;
+    auto t1 = makeValueRuns<int>(100, 1, 2, 1);
+    std::vector<int> res1{};
+    bool b1{true};
+    bool res2{};
+
+    ctx.createSerializer().enableBitPacking([&t1, &b1](BPSer& ser) {
+        ser.boolValue(b1);
+        ser.ext(t1, Sparse{100});
+    });
+    ctx.createDeserializer().enableBitPacking([&res1, &res2](BPDes& des) {
+        des.boolValue(res2);
+        des.ext(res1, Sparse{100});
+    });
+
+    EXPECT_TRUE(res2);
+    EXPECT_THAT(res1, ContainerEq(t1));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
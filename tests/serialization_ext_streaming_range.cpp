@@ -0,0 +1,170 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <bitsery/ext/streaming_range.h>
+#include <bitsery/traits/list.h>
+#include <list>
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+
+using StreamingRange = bitsery::ext::StreamingRange;
+
+using testing::Eq;
+using testing::ContainerEq;
+
+//single pass range, that generates values on the fly
+//no default member initializers, so that it is an aggregate in C++11
+struct Generator {
+    uint32_t count;
+
+    struct Iterator {
+        using iterator_category = std::input_iterator_tag;
+        using value_type = uint32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const uint32_t*;
+        using reference = const uint32_t&;
+
+        uint32_t current;
+
+        reference operator*() const {
+            return current;
+        }
+        Iterator& operator++() {
+            ++current;
+            return *this;
+        }
+        bool operator!=(const Iterator& other) const {
+            return current != other.current;
+        }
+        bool operator==(const Iterator& other) const {
+            return current == other.current;
+        }
+    };
+
+    Iterator begin() {
+        return Iterator{0};
+    }
+    Iterator end() {
+        return Iterator{count};
+    }
+};
+
+TEST(SerializeExtensionStreamingRange, ValuesAreWrittenInChunksTerminatedByZeroChunk) {
+    SerializationContext ctx;
+    std::vector<int32_t> src{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    std::vector<int32_t> res{100, 200};
+    ctx.createSerializer().ext4b(src, StreamingRange{3});
+    ctx.createDeserializer().ext4b(res, StreamingRange{3});
+    EXPECT_THAT(res, ContainerEq(src));
+    //chunks: 3, 3, 3, 1, 0
+    EXPECT_THAT(ctx.getBufferSize(), Eq(src.size() * 4 + 5));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionStreamingRange, EmptyRange) {
+    SerializationContext ctx;
+    std::vector<int32_t> src{};
+    std::vector<int32_t> res{1, 2};
+    ctx.createSerializer().ext4b(src, StreamingRange{3});
+    ctx.createDeserializer().ext4b(res, StreamingRange{3});
+    EXPECT_THAT(res.size(), Eq(0u));
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1u));
+}
+
+TEST(SerializeExtensionStreamingRange, InputRangeIsReadLazily) {
+    SerializationContext ctx;
+    Generator gen{1000};
+    auto& ser = ctx.createSerializer();
+    ser.ext(gen, StreamingRange{64}, [&ser](uint32_t& v) {
+        ser.value4b(v);
+    });
+
+    auto& des = ctx.createDeserializer();
+    auto range = bitsery::ext::readStreamingRange<uint32_t>(des, StreamingRange{64}, [&des](uint32_t& v) {
+        des.value4b(v);
+    });
+    uint64_t sum{};
+    uint32_t expected{};
+    bool ordered = true;
+    for (auto& v: range) {
+        ordered = ordered && v == expected++;
+        sum += v;
+    }
+    EXPECT_TRUE(ordered);
+    EXPECT_THAT(range.count(), Eq(1000u));
+    EXPECT_THAT(sum, Eq(999u * 1000u / 2u));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionStreamingRange, ObjectsToNotContiguousContainer) {
+    SerializationContext ctx;
+    std::list<MyStruct1> src{MyStruct1{1, 2}, MyStruct1{3, 4}, MyStruct1{5, 6}};
+    std::list<MyStruct1> res{};
+    ctx.createSerializer().ext(src, StreamingRange{2});
+    ctx.createDeserializer().ext(res, StreamingRange{2});
+    EXPECT_THAT(res, ContainerEq(src));
+}
+
+TEST(SerializeExtensionStreamingRange, WhenChunkOrTotalSizeIsTooLargeThenInvalidDataError) {
+    SerializationContext ctx;
+    std::vector<int32_t> src{1, 2, 3, 4, 5};
+    std::vector<int32_t> res{};
+    ctx.createSerializer().ext4b(src, StreamingRange{5});
+    ctx.createDeserializer().ext4b(res, StreamingRange{4});
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+
+    SerializationContext ctx2;
+    ctx2.createSerializer().ext4b(src, StreamingRange{2});
+    ctx2.createDeserializer().ext4b(res, StreamingRange{2, 4});
+    EXPECT_THAT(ctx2.br->error(), Eq(bitsery::ReaderError::InvalidData));
+
+    SerializationContext ctx3;
+    ctx3.createSerializer().ext4b(src, StreamingRange{2});
+    auto& des = ctx3.createDeserializer();
+    auto range = bitsery::ext::readStreamingRange<int32_t>(des, StreamingRange{2, 4}, [&des](int32_t& v) {
+        des.value4b(v);
+    });
+    size_t count{};
+    for (auto it = range.begin(); it != range.end(); ++it)
+        ++count;
+    EXPECT_THAT(count, Eq(4u));
+    EXPECT_THAT(ctx3.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeExtensionStreamingRange, WhenDataIsTruncatedThenReaderStops) {
+    SerializationContext ctx;
+    Generator gen{100};
+    ctx.createSerializer().ext4b(gen, StreamingRange{10});
+    ctx.bw->flush();
+
+    bitsery::BasicDeserializer<Reader> des{InputAdapter{ctx.buf.begin(), 50}};
+    auto range = bitsery::ext::readStreamingRange<uint32_t>(des, StreamingRange{10}, [&des](uint32_t& v) {
+        des.value4b(v);
+    });
+    size_t count{};
+    for (auto it = range.begin(); it != range.end(); ++it)
+        ++count;
+    //first chunk takes 41 bytes, second chunk size 1 byte, and 2 more elements fits in 50 bytes
+    EXPECT_THAT(count, Eq(12u));
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::DataOverflow));
+}
@@ -0,0 +1,176 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+
+#include <bitsery/ext/value_range_container.h>
+#include <bitsery/traits/array.h>
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+
+using namespace testing;
+using bitsery::ext::BitsConstraint;
+using bitsery::ext::ValueRange;
+using bitsery::ext::ValueRangeContainer;
+
+using BPSer = bitsery::BasicSerializer<bitsery::AdapterWriterBitPackingWrapper<Writer>>;
+using BPDes = bitsery::BasicDeserializer<bitsery::AdapterReaderBitPackingWrapper<Reader>>;
+
+template <typename T, typename ... Args>
+Buffer serializeElementByElement(const std::vector<T>& data, Args&& ... args) {
+    SerializationContext ctx;
+    ValueRange<T> r{std::forward<Args>(args)...};
+    ctx.createSerializer().enableBitPacking([&data, &r](BPSer& ser) {
+        ser.container(data, 10000, [&ser, &r](const T& v) {
+            ser.ext(v, r);
+        });
+    });
+    ctx.bw->flush();
+    ctx.buf.resize(ctx.getBufferSize());
+    return ctx.buf;
+}
+
+TEST(SerializeExtensionValueRangeContainer, IntegerSameAsElementByElement) {
+    SerializationContext ctx;
+    std::vector<int> t1{};
+    for (auto i = 0; i < 1000; ++i)
+        t1.push_back((i * 37) % 101 - 50);
+    std::vector<int> res1{};
+    ValueRangeContainer<int> r1{10000, -50, 50};
+
+    ctx.createSerializer().enableBitPacking([&t1, &r1](BPSer& ser) {
+        ser.ext(t1, r1);
+    });
+    ctx.createDeserializer().enableBitPacking([&res1, &r1](BPDes& des) {
+        des.ext(res1, r1);
+    });
+
+    auto expected = serializeElementByElement(t1, -50, 50);
+    EXPECT_THAT(ctx.getBufferSize(), Eq(expected.size()));
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), ctx.buf.begin()));
+    EXPECT_THAT(res1, ContainerEq(t1));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeExtensionValueRangeContainer, EnumSameAsElementByElement) {
+    SerializationContext ctx;
+    std::vector<MyEnumClass> t1{MyEnumClass::E2, MyEnumClass::E4, MyEnumClass::E3, MyEnumClass::E2, MyEnumClass::E4};
+    std::vector<MyEnumClass> res1{};
+    ValueRangeContainer<MyEnumClass> r1{10, MyEnumClass::E2, MyEnumClass::E4};
+
+    ctx.createSerializer().enableBitPacking([&t1, &r1](BPSer& ser) {
+        ser.ext(t1, r1);
+    });
+    ctx.createDeserializer().enableBitPacking([&res1, &r1](BPDes& des) {
+        des.ext(res1, r1);
+    });
+
+    auto expected = serializeElementByElement(t1, MyEnumClass::E2, MyEnumClass::E4);
+    EXPECT_THAT(ctx.getBufferSize(), Eq(expected.size()));
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), ctx.buf.begin()));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionValueRangeContainer, FloatCanBeReadByElementByElement) {
+    SerializationContext ctx;
+    constexpr float min{-1.0f};
+    constexpr float max{1.0f};
+    constexpr size_t bits{12};
+    std::vector<float> t1{};
+    for (auto i = 0; i < 777; ++i)
+        t1.push_back(min + (max - min) * static_cast<float>(i) / 776.0f);
+    std::vector<float> res1{};
+    ValueRangeContainer<float> r1{1000, min, max, BitsConstraint{bits}};
+
+    ctx.createSerializer().enableBitPacking([&t1, &r1](BPSer& ser) {
+        ser.ext(t1, r1);
+    });
+    ValueRange<float> r2{min, max, BitsConstraint{bits}};
+    ctx.createDeserializer().enableBitPacking([&res1, &r2](BPDes& des) {
+        des.container(res1, 1000, [&des, &r2](float& v) {
+            des.ext(v, r2);
+        });
+    });
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(serializeElementByElement(t1, min, max, BitsConstraint{bits}).size()));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+    ASSERT_THAT(res1.size(), Eq(t1.size()));
+    for (size_t i = 0; i < t1.size(); ++i)
+        EXPECT_THAT(res1[i], FloatNear(t1[i], 2 * (max - min) / (1u << bits)));
+}
+
+TEST(SerializeExtensionValueRangeContainer, DoubleWithMoreThan32BitsPerValue) {
+    SerializationContext ctx;
+    constexpr double min{50.0};
+    constexpr double max{100000.0};
+    constexpr size_t bits{50};
+    std::vector<double> t1{50.0, 38741.0, 100000.0, 777.777};
+    std::vector<double> res1{};
+    ValueRangeContainer<double> r1{10, min, max, BitsConstraint{bits}};
+
+    ctx.createSerializer().enableBitPacking([&t1, &r1](BPSer& ser) {
+        ser.ext(t1, r1);
+    });
+    ctx.createDeserializer().enableBitPacking([&res1, &r1](BPDes& des) {
+        des.ext(res1, r1);
+    });
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + (4 * bits + 7) / 8));
+    ASSERT_THAT(res1.size(), Eq(t1.size()));
+    for (size_t i = 0; i < t1.size(); ++i)
+        EXPECT_THAT(res1[i], DoubleNear(t1[i], 2 * (max - min) / (1ull << bits)));
+}
+
+TEST(SerializeExtensionValueRangeContainer, FixedSizeContainerDoesntWriteSize) {
+    SerializationContext ctx;
+    std::array<uint32_t, 5> t1{4, 5, 6, 7, 8};
+    std::array<uint32_t, 5> res1{};
+    ValueRangeContainer<uint32_t> r1{5, 4u, 11u};
+
+    ctx.createSerializer().enableBitPacking([&t1, &r1](BPSer& ser) {
+        ser.ext(t1, r1);
+    });
+    ctx.createDeserializer().enableBitPacking([&res1, &r1](BPDes& des) {
+        des.ext(res1, r1);
+    });
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(2));
+    EXPECT_THAT(res1, ContainerEq(t1));
+}
+
+TEST(SerializeExtensionValueRangeContainer, WhenDataIsInvalidThenReturnMinimumRangeValue) {
+    SerializationContext ctx;
+    ValueRangeContainer<int> r1{10, 4, 10};//6 is max, but 3bits required
+    std::vector<int> res1{};
+    uint8_t size{2};
+    uint8_t tmp{0xFF};//write all 1 so when reading 3 bits we get 7
+
+    ctx.createSerializer().enableBitPacking([&tmp, &size](BPSer& ser) {
+        ser.value1b(size);
+        ser.value1b(tmp);
+    });
+    ctx.createDeserializer().enableBitPacking([&res1, &r1](BPDes& des) {
+        des.ext(res1, r1);
+    });
+
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+    EXPECT_THAT(res1, ElementsAre(4, 4));
+}
@@ -0,0 +1,199 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+#include <bitsery/ext/value_range.h>
+#include <bitsery/adapter/stream.h>
+#include <sstream>
+
+using namespace testing;
+
+struct FixedBlockMessage {
+    int32_t id{};
+    uint8_t flags{};
+    int16_t x{};
+    int16_t y{};
+    double price{};
+    float weights[3]{};
+    MyStruct1 s1{};
+
+    static constexpr size_t SIZE = 4 + 1 + 2 + 2 + 8 + 3 * 4 + MyStruct1::SIZE;
+
+    bool operator == (const FixedBlockMessage& rhs) const {
+        return id == rhs.id && flags == rhs.flags && x == rhs.x && y == rhs.y && price == rhs.price
+            && std::equal(std::begin(weights), std::end(weights), std::begin(rhs.weights)) && s1 == rhs.s1;
+    }
+};
+
+template <typename S>
+void serializeFields(S& s, FixedBlockMessage& o) {
+    s.value4b(o.id);
+    s.value1b(o.flags);
+    s.value2b(o.x);
+    s.value2b(o.y);
+    s.value8b(o.price);
+    s.container4b(o.weights);
+    s.object(o.s1);
+}
+
+template <typename S>
+void serialize(S& s, FixedBlockMessage& o) {
+    s.template fixedBlock<FixedBlockMessage::SIZE>([&o](typename S::template FixedBlockType<FixedBlockMessage::SIZE>& fs) {
+        serializeFields(fs, o);
+    });
+}
+
+FixedBlockMessage createFixedBlockMessage() {
+    FixedBlockMessage res{};
+    res.id = -8457;
+    res.flags = 0x81;
+    res.x = 254;
+    res.y = -3;
+    res.price = 5486.125;
+    res.weights[0] = 0.5f;
+    res.weights[1] = -1.25f;
+    res.weights[2] = 1e10f;
+    res.s1 = MyStruct1{97, -54612};
+    return res;
+}
+
+TEST(SerializeFixedBlock, WritesSameBytesAsRegularSerialization) {
+    auto data = createFixedBlockMessage();
+    SerializationContext ctx1;
+    ctx1.createSerializer().object(data);
+    SerializationContext ctx2;
+    serializeFields(ctx2.createSerializer(), data);
+    ctx1.bw->flush();
+    ctx2.bw->flush();
+
+    EXPECT_THAT(ctx1.getBufferSize(), Eq(FixedBlockMessage::SIZE));
+    EXPECT_THAT(ctx2.getBufferSize(), Eq(FixedBlockMessage::SIZE));
+    EXPECT_TRUE(std::equal(ctx1.buf.begin(), ctx1.buf.begin() + FixedBlockMessage::SIZE, ctx2.buf.begin()));
+}
+
+TEST(SerializeFixedBlock, MultipleBlocks) {
+    std::vector<FixedBlockMessage> data(100, createFixedBlockMessage());
+    for (auto i = 0u; i < data.size(); ++i)
+        data[i].id = static_cast<int32_t>(i);
+    std::vector<FixedBlockMessage> res{};
+
+    SerializationContext ctx;
+    ctx.createSerializer().container(data, 1000);
+    ctx.createDeserializer().container(res, 1000);
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(1 + FixedBlockMessage::SIZE * data.size()));
+    EXPECT_THAT(res, ContainerEq(data));
+    EXPECT_TRUE(ctx.br->isCompletedSuccessfully());
+}
+
+TEST(SerializeFixedBlock, WhenNotEnoughDataThenDataOverflowAndZeroValues) {
+    auto data = createFixedBlockMessage();
+    SerializationContext ctx;
+    ctx.createSerializer().object(data);
+    ctx.bw->flush();
+    InputAdapter adapter{ctx.buf.begin(), FixedBlockMessage::SIZE - 1};
+    bitsery::BasicDeserializer<Reader> des{std::move(adapter)};
+    auto res = createFixedBlockMessage();
+    des.object(res);
+
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::DataOverflow));
+    EXPECT_THAT(res, Eq(FixedBlockMessage{}));
+}
+
+TEST(SerializeFixedBlock, ErrorsInsideBlockArePropagatedToReader) {
+    SerializationContext ctx;
+    auto& ser = ctx.createSerializer();
+    ser.value4b(int32_t{-1});
+    ser.value1b(uint8_t{5});
+    int32_t v{};
+    uint8_t ch{};
+    ctx.createDeserializer().fixedBlock<5>([&v, &ch](bitsery::BasicDeserializer<Reader>::FixedBlockType<5>& fs) {
+        fs.value4b(v);
+        bitsery::AdapterAccess::getReader(fs).setError(bitsery::ReaderError::InvalidData);
+        fs.value1b(ch);
+    });
+    EXPECT_THAT(ctx.br->error(), Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(SerializeFixedBlock, WhenBitPackingIsEnabledThenBlockIsWrittenUnaligned) {
+    auto data = createFixedBlockMessage();
+    auto res = FixedBlockMessage{};
+    bitsery::ext::ValueRange<uint8_t> range{uint8_t{0}, uint8_t{7}};
+    uint8_t v1 = 5;
+    uint8_t v2 = 3;
+    uint8_t r1{};
+    uint8_t r2{};
+
+    SerializationContext ctx;
+    ctx.createSerializer().enableBitPacking([&](bitsery::Serializer<OutputAdapter>::BPEnabledType& sbp) {
+        sbp.ext(v1, range);
+        sbp.object(data);
+        sbp.ext(v2, range);
+    });
+    ctx.createDeserializer().enableBitPacking([&](bitsery::BasicDeserializer<Reader>::BPEnabledType& dbp) {
+        dbp.ext(r1, range);
+        dbp.object(res);
+        dbp.ext(r2, range);
+    });
+
+    EXPECT_THAT(ctx.getBufferSize(), Eq(FixedBlockMessage::SIZE + 1));
+    EXPECT_THAT(r1, Eq(v1));
+    EXPECT_THAT(res, Eq(data));
+    EXPECT_THAT(r2, Eq(v2));
+}
+
+struct FixedBlockNonDefaultEndiannessConfig: public bitsery::DefaultConfig {
+    static constexpr bitsery::EndiannessType NetworkEndianness =
+        bitsery::details::getSystemEndianness() == bitsery::EndiannessType::LittleEndian
+        ? bitsery::EndiannessType::BigEndian
+        : bitsery::EndiannessType::LittleEndian;
+};
+
+TEST(SerializeFixedBlock, SwapsBytesWhenNetworkEndiannessIsDifferent) {
+    auto data = createFixedBlockMessage();
+    auto res = FixedBlockMessage{};
+    BasicSerializationContext<FixedBlockNonDefaultEndiannessConfig, void> ctx1;
+    ctx1.createSerializer().object(data);
+    ctx1.createDeserializer().object(res);
+    EXPECT_THAT(res, Eq(data));
+
+    BasicSerializationContext<FixedBlockNonDefaultEndiannessConfig, void> ctx2;
+    ctx2.createSerializer().value4b(data.id);
+    ctx2.bw->flush();
+    EXPECT_TRUE(std::equal(ctx2.buf.begin(), ctx2.buf.begin() + 4, ctx1.buf.begin()));
+}
+
+TEST(SerializeFixedBlock, WhenAdapterDoesntProvideDirectAccessThenBlockIsWrittenAndReadAtOnce) {
+    auto data = createFixedBlockMessage();
+    FixedBlockMessage res{};
+    std::stringstream stream{};
+    bitsery::Serializer<bitsery::OutputStreamAdapter> ser{bitsery::OutputStreamAdapter{stream}};
+    ser.object(data);
+    bitsery::AdapterAccess::getWriter(ser).flush();
+    EXPECT_THAT(stream.str().size(), Eq(FixedBlockMessage::SIZE));
+
+    auto state = bitsery::quickDeserialization(bitsery::InputStreamAdapter{stream}, res);
+    EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(state.second);
+    EXPECT_THAT(res, Eq(data));
+}
@@ -0,0 +1,219 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+#include <bitsery/counters_hooks.h>
+#include <thread>
+
+using namespace testing;
+
+struct RecordingHooks: bitsery::NoHooks {
+    static constexpr bool Enabled = true;
+    static std::vector<std::string> events;
+
+    template<typename T, typename TWriter>
+    static void onSerializeObjectBegin(const TWriter& w) {
+        events.push_back("ser begin " + std::to_string(sizeof(T)) + " at " + std::to_string(w.writtenBytesCount()));
+    }
+
+    template<typename T, typename TWriter>
+    static void onSerializeObjectEnd(const TWriter& w) {
+        events.push_back("ser end " + std::to_string(sizeof(T)) + " at " + std::to_string(w.writtenBytesCount()));
+    }
+
+    template<typename T, typename TReader>
+    static void onDeserializeObjectBegin(const TReader&) {
+        events.push_back("des begin " + std::to_string(sizeof(T)));
+    }
+
+    template<typename T, typename TReader>
+    static void onDeserializeObjectEnd(const TReader&) {
+        events.push_back("des end " + std::to_string(sizeof(T)));
+    }
+
+    static void onContainerSize(size_t size) {
+        events.push_back("container " + std::to_string(size));
+    }
+
+    static void onReaderError(bitsery::ReaderError error) {
+        events.push_back("error " + std::to_string(static_cast<int>(error)));
+    }
+
+    template<typename TWriter>
+    static void onFlush(const TWriter& w) {
+        events.push_back("flush " + std::to_string(w.writtenBytesCount()));
+    }
+
+    static void onSessionBegin() {
+        events.push_back("session begin");
+    }
+
+    static void onSessionEnd() {
+        events.push_back("session end");
+    }
+};
+
+std::vector<std::string> RecordingHooks::events{};
+
+struct RecordingHooksConfig: bitsery::DefaultConfig {
+    using Hooks = RecordingHooks;
+};
+
+struct RecordingHooksSessionsConfig: RecordingHooksConfig {
+    static constexpr bool BufferSessionsEnabled = true;
+};
+
+struct CountersHooksConfig: bitsery::DefaultConfig {
+    using Hooks = bitsery::ThreadCountersHooks;
+};
+
+//config written from scratch, without Hooks and ValidationOnly
+struct ConfigWithoutHooks {
+    static constexpr bitsery::EndiannessType NetworkEndianness = bitsery::EndiannessType::LittleEndian;
+    static constexpr bool BufferSessionsEnabled = true;
+    using InternalContext = std::tuple<>;
+};
+
+using RecordingContext = BasicSerializationContext<RecordingHooksConfig, void>;
+using CountersContext = BasicSerializationContext<CountersHooksConfig, void>;
+
+class SerializationHooks: public Test {
+public:
+    void SetUp() override {
+        RecordingHooks::events.clear();
+    }
+};
+
+TEST_F(SerializationHooks, SerializerNotifiesObjectsContainerSizeAndFlush) {
+    std::vector<MyStruct1> data{{1, 2}, {3, 4}};
+    RecordingContext ctx{};
+    ctx.createSerializer().container(data, 10);
+    ctx.bw->flush();
+    EXPECT_THAT(RecordingHooks::events, ContainerEq(std::vector<std::string>{
+            "container 2",
+            "ser begin 8 at 1",
+            "ser end 8 at 9",
+            "ser begin 8 at 9",
+            "ser end 8 at 17",
+            "flush 17"}));
+}
+
+TEST_F(SerializationHooks, DeserializerNotifiesObjectsAndContainerSize) {
+    std::vector<MyStruct1> data{{1, 2}};
+    RecordingContext ctx{};
+    ctx.createSerializer().container(data, 10);
+    auto& des = ctx.createDeserializer();
+    RecordingHooks::events.clear();
+    des.container(data, 10);
+    EXPECT_THAT(RecordingHooks::events, ContainerEq(std::vector<std::string>{
+            "container 1",
+            "des begin 8",
+            "des end 8"}));
+}
+
+TEST_F(SerializationHooks, ReaderErrorIsNotifiedOnceWhenDataOverflows) {
+    RecordingContext ctx{};
+    ctx.createSerializer().value1b(uint8_t{1});
+    auto& des = ctx.createDeserializer();
+    RecordingHooks::events.clear();
+    uint32_t v{};
+    des.value4b(v);
+    des.value4b(v);
+    EXPECT_THAT(RecordingHooks::events, ContainerEq(std::vector<std::string>{
+            "error " + std::to_string(static_cast<int>(bitsery::ReaderError::DataOverflow))}));
+}
+
+TEST_F(SerializationHooks, ReaderErrorIsNotifiedOnceWhenErrorIsSet) {
+    RecordingContext ctx{};
+    ctx.createSerializer().value1b(uint8_t{1});
+    ctx.createDeserializer();
+    RecordingHooks::events.clear();
+    ctx.br->setError(bitsery::ReaderError::InvalidData);
+    ctx.br->setError(bitsery::ReaderError::InvalidPointer);
+    EXPECT_THAT(RecordingHooks::events, ContainerEq(std::vector<std::string>{
+            "error " + std::to_string(static_cast<int>(bitsery::ReaderError::InvalidData))}));
+}
+
+TEST_F(SerializationHooks, SessionsAreNotified) {
+    BasicSerializationContext<RecordingHooksSessionsConfig, void> ctx{};
+    auto& ser = ctx.createSerializer();
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    w.beginSession();
+    ser.value1b(uint8_t{1});
+    w.endSession();
+    auto& des = ctx.createDeserializer();
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    r.beginSession();
+    uint8_t v{};
+    des.value1b(v);
+    r.endSession();
+    auto& events = RecordingHooks::events;
+    EXPECT_THAT(std::count(events.begin(), events.end(), "session begin"), Eq(2));
+    EXPECT_THAT(std::count(events.begin(), events.end(), "session end"), Eq(2));
+}
+
+TEST(SerializationHooksConfig, WhenConfigDoesntDefineHooksThenNoHooksAreUsed) {
+    std::vector<MyStruct1> data{{1, 2}, {3, 4}};
+    std::vector<MyStruct1> res{};
+    BasicSerializationContext<ConfigWithoutHooks, void> ctx{};
+    auto& ser = ctx.createSerializer();
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    w.beginSession();
+    ser.container(data, 10);
+    w.endSession();
+    auto& des = ctx.createDeserializer();
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    r.beginSession();
+    des.container(res, 10);
+    r.endSession();
+    EXPECT_THAT(res, ContainerEq(data));
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+}
+
+TEST(SerializationThreadCountersHooks, CountersAreSummedFromAllThreads) {
+    auto before = bitsery::ThreadCountersHooks::snapshot();
+    auto work = [] {
+        std::vector<MyStruct1> data{{1, 2}, {3, 4}};
+        CountersContext ctx{};
+        ctx.createSerializer().object(data[0]);
+        ctx.createDeserializer().container(data, 1);
+    };
+    work();
+    std::thread t{work};
+    t.join();
+    auto after = bitsery::ThreadCountersHooks::snapshot();
+
+    EXPECT_THAT(after.objectsSerialized - before.objectsSerialized, Eq(2u));
+    EXPECT_THAT(after.flushes - before.flushes, Eq(2u));
+    //container size is read from object data, so there is not enough data for container element
+    auto errorIndex = static_cast<size_t>(bitsery::ReaderError::DataOverflow);
+    EXPECT_THAT(after.readerErrors[errorIndex] - before.readerErrors[errorIndex], Eq(2u));
+
+    auto it = std::find_if(after.messageTypes.begin(), after.messageTypes.end(),
+                           [](const bitsery::ThreadCountersHooks::MessageTypeBytes& t) {
+        return t.name == "MyStruct1";
+    });
+    ASSERT_THAT(it, Ne(after.messageTypes.end()));
+    EXPECT_THAT(it->messages, Eq(2u));
+    EXPECT_THAT(it->bytes, Eq(2 * MyStruct1::SIZE));
+}
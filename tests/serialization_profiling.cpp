@@ -0,0 +1,171 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+#include <bitsery/profiling_writer.h>
+#include <bitsery/ext/value_range.h>
+#include <bitsery/traits/string.h>
+#include <sstream>
+
+using namespace testing;
+
+using ProfilingSerializer = bitsery::BasicSerializer<bitsery::ProfilingWriter>;
+
+struct ProfiledData {
+    std::vector<MyStruct2> items{};
+    std::string name{};
+    uint8_t level{};
+};
+
+template <typename S>
+void serialize(S& s, ProfiledData& o) {
+    s.container(o.items, 10);
+    s.text1b(o.name, 100);
+    s.enableBitPacking([&o](typename S::BPEnabledType& sbp) {
+        sbp.ext(o.level, bitsery::ext::ValueRange<uint8_t>{uint8_t{0}, uint8_t{15}});
+    });
+}
+
+ProfiledData createProfiledData() {
+    ProfiledData data{};
+    data.items.emplace_back(MyStruct2::V1, MyStruct1{1, 2});
+    data.items.emplace_back(MyStruct2::V2, MyStruct1{3, 4});
+    data.name = "abc";
+    data.level = 5;
+    return data;
+}
+
+std::string foldedStacks(const bitsery::ProfilingWriter& w, bitsery::ProfilingMetric metric) {
+    std::stringstream ss{};
+    w.writeFoldedStacks(ss, metric);
+    return ss.str();
+}
+
+TEST(SerializeProfiling, OnlyProfilingWriterReceivesScopeNotifications) {
+    EXPECT_TRUE(bitsery::details::IsProfilingWriter<bitsery::ProfilingWriter>::value);
+    EXPECT_FALSE(bitsery::details::IsProfilingWriter<bitsery::MeasureSize>::value);
+    EXPECT_FALSE(bitsery::details::IsProfilingWriter<Writer>::value);
+    EXPECT_TRUE(std::is_empty<bitsery::details::ProfileScope<Writer>>::value);
+}
+
+TEST(SerializeProfiling, WrittenBytesCountIsSameAsMeasureSize) {
+    auto data = createProfiledData();
+    ProfilingSerializer ser{bitsery::ProfilingWriter{}};
+    ser.object(data);
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    w.flush();
+    bitsery::BasicSerializer<bitsery::MeasureSize> measureSer{bitsery::MeasureSize{}};
+    measureSer.object(data);
+    auto& mw = bitsery::AdapterAccess::getWriter(measureSer);
+    mw.flush();
+    EXPECT_THAT(w.writtenBytesCount(), Eq(mw.writtenBytesCount()));
+}
+
+TEST(SerializeProfiling, BitsAreAttributedToCallPath) {
+    auto data = createProfiledData();
+    ProfilingSerializer ser{bitsery::ProfilingWriter{}};
+    ser.object(data);
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    auto& nodes = w.nodes();
+    //root, data, container, item, enum, struct1, int, text, ext
+    ASSERT_THAT(nodes.size(), Eq(9u));
+    auto& dataNode = nodes[nodes[0].childs[0]];
+    EXPECT_THAT(dataNode.calls, Eq(1u));
+    EXPECT_THAT(dataNode.totalBits, Eq((1 + 2 * MyStruct2::SIZE + 1 + 3) * 8 + 4));
+    EXPECT_THAT(dataNode.childs.size(), Eq(3u));
+
+    auto& containerNode = nodes[dataNode.childs[0]];
+    //container size is attributed to container itself
+    EXPECT_THAT(containerNode.selfBits, Eq(8u));
+    auto& itemNode = nodes[containerNode.childs[0]];
+    EXPECT_THAT(itemNode.calls, Eq(2u));
+    EXPECT_THAT(itemNode.totalBits, Eq(2 * MyStruct2::SIZE * 8));
+    EXPECT_THAT(itemNode.selfBits, Eq(0u));
+
+    auto& textNode = nodes[dataNode.childs[1]];
+    EXPECT_THAT(textNode.selfBits, Eq(4u * 8));
+    auto& extNode = nodes[dataNode.childs[2]];
+    EXPECT_THAT(extNode.totalBits, Eq(4u));
+}
+
+TEST(SerializeProfiling, FoldedStacksContainsSelfBitsForEachPath) {
+    auto data = createProfiledData();
+    ProfilingSerializer ser{bitsery::ProfilingWriter{}};
+    ser.object(data);
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    w.flush();
+    auto folded = foldedStacks(w, bitsery::ProfilingMetric::Bits);
+    std::vector<std::string> lines{};
+    std::stringstream ss{folded};
+    for (std::string line; std::getline(ss, line);)
+        lines.push_back(line);
+    ASSERT_THAT(lines.size(), Eq(5u));
+    EXPECT_THAT(lines[0], StartsWith("object<ProfiledData>;container<std::vector<MyStruct2"));
+    EXPECT_THAT(lines[0], EndsWith(" 8"));
+    EXPECT_THAT(lines[1], EndsWith(";object<MyStruct2>;value<MyStruct2::MyEnum> 64"));
+    EXPECT_THAT(lines[2], EndsWith(";object<MyStruct2>;object<MyStruct1>;value<int> 128"));
+    EXPECT_THAT(lines[3], StartsWith("object<ProfiledData>;text<std::"));
+    EXPECT_THAT(lines[3], EndsWith(" 32"));
+    EXPECT_THAT(lines[4], Eq("object<ProfiledData>;ext<bitsery::ext::ValueRange<unsigned char>> 4"));
+    //alignment on flush is not part of any call
+    EXPECT_THAT(w.nodes()[0].selfBits, Eq(4u));
+
+    EXPECT_THAT(foldedStacks(w, bitsery::ProfilingMetric::Time), Eq(""));
+}
+
+TEST(SerializeProfiling, JsonContainsCallTreeAndTypes) {
+    MyStruct1 data{1, 2};
+    ProfilingSerializer ser{bitsery::ProfilingWriter{}};
+    ser.object(data);
+    std::stringstream ss{};
+    bitsery::AdapterAccess::getWriter(ser).writeJson(ss);
+    EXPECT_THAT(ss.str(), Eq(
+            "{\"clock\":false,\"tree\":"
+            "{\"name\":\"root\",\"calls\":0,\"bits\":64,\"selfBits\":0,\"time\":0,\"selfTime\":0,\"childs\":["
+            "{\"name\":\"object<MyStruct1>\",\"calls\":1,\"bits\":64,\"selfBits\":0,\"time\":0,\"selfTime\":0,\"childs\":["
+            "{\"name\":\"value<int>\",\"calls\":2,\"bits\":64,\"selfBits\":64,\"time\":0,\"selfTime\":0,\"childs\":[]}"
+            "]}]},"
+            "\"types\":["
+            "{\"name\":\"object<MyStruct1>\",\"calls\":1,\"selfBits\":0,\"selfTime\":0},"
+            "{\"name\":\"value<int>\",\"calls\":2,\"selfBits\":64,\"selfTime\":0}"
+            "]}"));
+}
+
+TEST(SerializeProfiling, JsonStringEscapesQuotesBackslashAndControlCharacters) {
+    std::stringstream ss{};
+    bitsery::details::writeJsonString(ss, std::string("a\"b\\c\n\x01\x1f d"));
+    EXPECT_THAT(ss.str(), Eq("\"a\\\"b\\\\c\\u000a\\u0001\\u001f d\""));
+}
+
+TEST(SerializeProfiling, ClockMeasuresTimeForEachCall) {
+    auto data = createProfiledData();
+    bitsery::BasicSerializer<bitsery::BasicProfilingWriter<bitsery::DefaultConfig, bitsery::ProfilingSteadyClock>>
+            ser{bitsery::BasicProfilingWriter<bitsery::DefaultConfig, bitsery::ProfilingSteadyClock>{}};
+    ser.object(data);
+    auto& nodes = bitsery::AdapterAccess::getWriter(ser).nodes();
+    auto& dataNode = nodes[nodes[0].childs[0]];
+    uint64_t childsTime{};
+    for (auto child: dataNode.childs)
+        childsTime += nodes[child].totalTime;
+    EXPECT_THAT(dataNode.totalTime, Eq(dataNode.selfTime + childsTime));
+}
@@ -0,0 +1,177 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+#include <bitsery/ext/pointer.h>
+
+using namespace testing;
+
+using Serializer = bitsery::BasicSerializer<Writer>;
+using Deserializer = bitsery::BasicDeserializer<Reader>;
+
+template <typename TSerializer>
+size_t flushAndGetSize(TSerializer& ser) {
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    w.flush();
+    return w.writtenBytesCount();
+}
+
+TEST(SerializationReset, SerializerResetToNewBufferWritesSameBytes) {
+    MyStruct1 data{7, -3};
+    Buffer buf1{};
+    Buffer buf2{};
+    Serializer ser{OutputAdapter{buf1}};
+    ser.object(data);
+    auto size1 = flushAndGetSize(ser);
+    ser.reset(OutputAdapter{buf2});
+    ser.object(data);
+    auto size2 = flushAndGetSize(ser);
+    EXPECT_THAT(size2, Eq(size1));
+    buf1.resize(size1);
+    buf2.resize(size2);
+    EXPECT_THAT(buf2, ContainerEq(buf1));
+}
+
+TEST(SerializationReset, DeserializerResetClearsErrorState) {
+    Buffer buf{};
+    auto size = bitsery::quickSerialization(OutputAdapter{buf}, MyStruct1{1, 2});
+    MyStruct1 res{};
+    Deserializer des{InputAdapter{buf.begin(), size - 1}};
+    des.object(res);
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    EXPECT_THAT(r.error(), Eq(bitsery::ReaderError::DataOverflow));
+
+    des.reset(InputAdapter{buf.begin(), size});
+    des.object(res);
+    EXPECT_THAT(r.error(), Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+    EXPECT_THAT(res, Eq(MyStruct1{1, 2}));
+}
+
+TEST(SerializationReset, SessionsAreClearedAfterReset) {
+    using SessionsWriter = bitsery::AdapterWriter<OutputAdapter, SessionsEnabledConfig>;
+    using SessionsReader = bitsery::AdapterReader<InputAdapter, SessionsEnabledConfig>;
+    Buffer buf1{};
+    Buffer buf2{};
+    bitsery::BasicSerializer<SessionsWriter> ser{OutputAdapter{buf1}};
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    auto write = [&ser, &w](int32_t v) {
+        w.beginSession();
+        ser.value4b(v);
+        w.endSession();
+        w.flush();
+        return w.writtenBytesCount();
+    };
+    auto size1 = write(1);
+    ser.reset(OutputAdapter{buf2});
+    auto size2 = write(2);
+    EXPECT_THAT(size2, Eq(size1));
+
+    bitsery::BasicDeserializer<SessionsReader> des{InputAdapter{buf1.begin(), size1}};
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    auto read = [&des, &r]() {
+        int32_t v{};
+        r.beginSession();
+        des.value4b(v);
+        r.endSession();
+        return v;
+    };
+    EXPECT_THAT(read(), Eq(1));
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+    des.reset(InputAdapter{buf2.begin(), size2});
+    EXPECT_THAT(read(), Eq(2));
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+}
+
+struct ResetPointers {
+    MyStruct1 value{};
+    MyStruct1* observer{};
+};
+
+template <typename S>
+void serialize(S& s, ResetPointers& o) {
+    s.ext(o.value, bitsery::ext::ReferencedByPointer{});
+    s.ext(o.observer, bitsery::ext::PointerObserver{});
+}
+
+struct ConfigWithPointerLinkingContext: bitsery::DefaultConfig {
+    using InternalContext = std::tuple<bitsery::ext::PointerLinkingContext>;
+};
+
+TEST(SerializationReset, InternalContextIsResetBetweenMessages) {
+    using PtrWriter = bitsery::AdapterWriter<OutputAdapter, ConfigWithPointerLinkingContext>;
+    using PtrReader = bitsery::AdapterReader<InputAdapter, ConfigWithPointerLinkingContext>;
+    ResetPointers data1{};
+    data1.value = MyStruct1{1, 2};
+    data1.observer = &data1.value;
+    ResetPointers data2{};
+    data2.value = MyStruct1{3, 4};
+    data2.observer = &data2.value;
+
+    Buffer buf1{};
+    Buffer buf2{};
+    bitsery::BasicSerializer<PtrWriter> ser{OutputAdapter{buf1}};
+    ser.object(data1);
+    auto size1 = flushAndGetSize(ser);
+    ser.reset(OutputAdapter{buf2});
+    ser.object(data2);
+    auto size2 = flushAndGetSize(ser);
+    //pointer ids start from beginning for each message
+    EXPECT_THAT(size2, Eq(size1));
+
+    ResetPointers res{};
+    bitsery::BasicDeserializer<PtrReader> des{InputAdapter{buf1.begin(), size1}};
+    des.object(res);
+    auto& r = bitsery::AdapterAccess::getReader(des);
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+    EXPECT_THAT(res.value, Eq(data1.value));
+    EXPECT_THAT(res.observer, Eq(&res.value));
+
+    ResetPointers res2{};
+    des.reset(InputAdapter{buf2.begin(), size2});
+    des.object(res2);
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+    EXPECT_THAT(res2.value, Eq(data2.value));
+    EXPECT_THAT(res2.observer, Eq(&res2.value));
+}
+
+TEST(SerializationReset, CachedSerializationAndDeserialization) {
+    Buffer buf{};
+    for (auto i = 0; i < 3; ++i) {
+        MyStruct1 data{i, -i};
+        auto size = bitsery::cachedSerialization(OutputAdapter{buf}, data);
+        MyStruct1 res{};
+        auto state = bitsery::cachedDeserialization(InputAdapter{buf.begin(), size}, res);
+        EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+        EXPECT_TRUE(state.second);
+        EXPECT_THAT(res, Eq(data));
+    }
+    //error state is not carried to next call
+    MyStruct1 res{};
+    auto state = bitsery::cachedDeserialization(InputAdapter{buf.begin(), 1}, res);
+    EXPECT_THAT(state.first, Eq(bitsery::ReaderError::DataOverflow));
+    auto size = bitsery::cachedSerialization(OutputAdapter{buf}, MyStruct1{5, 6});
+    state = bitsery::cachedDeserialization(InputAdapter{buf.begin(), size}, res);
+    EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+    EXPECT_THAT(res, Eq(MyStruct1{5, 6}));
+}
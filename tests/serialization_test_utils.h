@@ -24,7 +24,10 @@
 #ifndef BITSERY_SERIALIZER_TEST_UTILS_H
 #define BITSERY_SERIALIZER_TEST_UTILS_H
 
+#include <algorithm>
 #include <memory>
+#include <random>
+#include <gmock/gmock.h>
 #include <bitsery/bitsery.h>
 #include <bitsery/traits/vector.h>
 #include <bitsery/adapter/buffer.h>
@@ -61,6 +64,25 @@ enum class MyEnumClass:int32_t {
     E1, E2, E3, E4, E5, E6
 };
 
+//value types for typed tests of extensions, that work with containers of fundamental types
+using FundamentalValueTypes = ::testing::Types<uint8_t, int16_t, int32_t, uint64_t, float, double, MyEnumClass>;
+
+//runs of equal non default values with random length from 1 to maxRun, each followed by `gap` default values.
+//values are small positive numbers, and consecutive runs always have different values
+template <typename T>
+std::vector<T> makeValueRuns(size_t size, size_t maxRun, size_t gap, uint32_t seed) {
+    std::mt19937 rng{seed};
+    std::vector<T> res{};
+    auto value = 0;
+    while (res.size() < size) {
+        const auto len = (std::min)(size - res.size(), static_cast<size_t>(rng() % maxRun + 1));
+        value = (value + static_cast<int>(rng() % 4)) % 5 + 1;
+        res.insert(res.end(), len, static_cast<T>(value));
+        res.insert(res.end(), (std::min)(size - res.size(), gap), T{});
+    }
+    return res;
+}
+
 struct MyStruct2 {
     enum MyEnum {
         V1, V2, V3, V4, V5, V6
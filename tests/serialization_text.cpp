@@ -110,6 +110,123 @@ TEST(SerializeText, CArraySerializesTextLength) {
     EXPECT_THAT(r1, ContainerEq(t1));
 }
 
+//buffer that fills new elements with garbage, when resized for overwrite
+struct OverwriteBuffer {
+    std::vector<char> data{};
+    size_t overwriteResizes{};
+
+    char* begin() {
+        return data.data();
+    }
+    char* end() {
+        return data.data() + data.size();
+    }
+};
+
+namespace bitsery {
+    namespace traits {
+        template <>
+        struct ContainerTraits<OverwriteBuffer> {
+            using TValue = char;
+            static constexpr bool isResizable = true;
+            static constexpr bool isContiguous = true;
+            static size_t size(const OverwriteBuffer& buf) {
+                return buf.data.size();
+            }
+            static void resize(OverwriteBuffer& buf, size_t size) {
+                buf.data.resize(size);
+            }
+            static void resizeForOverwrite(OverwriteBuffer& buf, size_t size) {
+                ++buf.overwriteResizes;
+                buf.data.resize(size, 'x');
+            }
+        };
+
+        template <>
+        struct TextTraits<OverwriteBuffer> {
+            using TValue = char;
+            static constexpr bool addNUL = false;
+            static size_t length(const OverwriteBuffer& buf) {
+                return buf.data.size();
+            }
+        };
+    }
+}
+
+TEST(SerializeText, WhenResizeForOverwriteIsDefinedThenItIsUsedForTextAndContainer) {
+    SerializationContext ctx;
+    std::string t1 = "some random text";
+    ctx.createSerializer().text1b(t1, 1000);
+    ctx.createSerializer().container1b(t1, 1000);
+
+    OverwriteBuffer res1{};
+    OverwriteBuffer res2{};
+    auto& des = ctx.createDeserializer();
+    des.text1b(res1, 1000);
+    des.container1b(res2, 1000);
+
+    EXPECT_THAT(res1.overwriteResizes, Eq(1u));
+    EXPECT_THAT(res2.overwriteResizes, Eq(1u));
+    EXPECT_THAT(std::string(res1.data.begin(), res1.data.end()), StrEq(t1));
+    EXPECT_THAT(std::string(res2.data.begin(), res2.data.end()), StrEq(t1));
+}
+
+TEST(SerializeText, WhenResizedForOverwriteAndReadFailsThenElementsAreCleared) {
+    SerializationContext ctx;
+    std::string t1 = "some random text";
+    ctx.createSerializer().text1b(t1, 1000);
+    ctx.bw->flush();
+
+    OverwriteBuffer res{};
+    bitsery::BasicDeserializer<Reader> des{InputAdapter{ctx.buf.begin(), 5}};
+    des.text1b(res, 1000);
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::DataOverflow));
+    EXPECT_THAT(res.data, Each(Eq('\0')));
+}
+
+#if defined(__cpp_lib_string_resize_and_overwrite)
+TEST(SerializeText, StdStringIsReadInsideResizeAndOverwrite) {
+    static_assert(bitsery::details::HasResizeAndOverwrite<std::string>::value, "");
+    SerializationContext ctx;
+    std::string t1(10000, 'a');
+    ctx.createSerializer().text1b(t1, 100000);
+    ctx.createSerializer().container1b(t1, 100000);
+    std::string res1 = "previous";
+    std::string res2{};
+    auto& des = ctx.createDeserializer();
+    des.text1b(res1, 100000);
+    des.container1b(res2, 100000);
+    EXPECT_THAT(res1, StrEq(t1));
+    EXPECT_THAT(res2, StrEq(t1));
+}
+
+TEST(SerializeText, WhenStdStringReadFailsThenCharactersAreCleared) {
+    SerializationContext ctx;
+    std::string t1(1000, 'a');
+    ctx.createSerializer().text1b(t1, 10000);
+    ctx.bw->flush();
+
+    std::string res = "previous";
+    bitsery::BasicDeserializer<Reader> des{InputAdapter{ctx.buf.begin(), 100}};
+    des.text1b(res, 10000);
+    EXPECT_THAT(bitsery::AdapterAccess::getReader(des).error(), Eq(bitsery::ReaderError::DataOverflow));
+    EXPECT_THAT(res.size(), Eq(t1.size()));
+    EXPECT_THAT(res, Each(Eq('\0')));
+}
+#endif
+
+TEST(SerializeText, VectorWithDefaultInitAllocator) {
+    using Bytes = std::vector<uint8_t, bitsery::traits::DefaultInitAllocator<uint8_t>>;
+    SerializationContext ctx;
+    Bytes data(1000);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<uint8_t>(i * 7);
+    ctx.createSerializer().container1b(data, 10000);
+    Bytes res{};
+    ctx.createDeserializer().container1b(res, 10000);
+    EXPECT_THAT(res, ContainerEq(data));
+}
+
 #ifndef NDEBUG
 TEST(SerializeText, WhenCArrayNotNullterminatedThenAssert) {
     SerializationContext ctx;
@@ -0,0 +1,203 @@
+//MIT License
+//
+//Copyright (c) 2018 Mindaugas Vinkelis
+//
+//Permission is hereby granted, free of charge, to any person obtaining a copy
+//of this software and associated documentation files (the "Software"), to deal
+//in the Software without restriction, including without limitation the rights
+//to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//copies of the Software, and to permit persons to whom the Software is
+//furnished to do so, subject to the following conditions:
+//
+//The above copyright notice and this permission notice shall be included in all
+//copies or substantial portions of the Software.
+//
+//THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+//SOFTWARE.
+
+#include <gmock/gmock.h>
+#include "serialization_test_utils.h"
+#include <bitsery/ext/value_range.h>
+#include <bitsery/traits/string.h>
+#include <random>
+
+using namespace testing;
+
+struct ValidationMessage {
+    uint32_t id{};
+    std::string name{};
+    std::vector<MyStruct1> items{};
+    std::vector<uint16_t> samples{};
+    bool flag{};
+    uint8_t level{};
+    //enum with fixed underlying type, so that any fuzzed value is valid
+    MyEnumClass kind{};
+    MyStruct1 s1{};
+
+    bool operator == (const ValidationMessage& rhs) const {
+        return id == rhs.id && name == rhs.name && items == rhs.items && samples == rhs.samples
+            && flag == rhs.flag && level == rhs.level && kind == rhs.kind && s1 == rhs.s1;
+    }
+};
+
+template <typename S>
+void serializeMessage(S& s, ValidationMessage& o, size_t maxNameSize, uint8_t maxLevel) {
+    s.value4b(o.id);
+    s.text1b(o.name, maxNameSize);
+    s.container(o.items, 10);
+    s.container2b(o.samples, 30);
+    s.boolValue(o.flag);
+    s.enableBitPacking([&o, maxLevel](typename S::BPEnabledType& sbp) {
+        sbp.ext(o.level, bitsery::ext::ValueRange<uint8_t>{uint8_t{0}, maxLevel});
+        sbp.value4b(o.kind);
+        sbp.object(o.s1);
+    });
+}
+
+template <typename S>
+void serialize(S& s, ValidationMessage& o) {
+    serializeMessage(s, o, 20, 10);
+}
+
+//serialize without limits that are used for deserialization
+size_t serializeInvalidMessage(Buffer& buf, ValidationMessage& data) {
+    bitsery::Serializer<OutputAdapter> ser{OutputAdapter{buf}};
+    serializeMessage(ser, data, 100, 15);
+    auto& w = bitsery::AdapterAccess::getWriter(ser);
+    w.flush();
+    return w.writtenBytesCount();
+}
+
+ValidationMessage createValidationMessage(std::mt19937& rnd) {
+    ValidationMessage res{};
+    res.id = static_cast<uint32_t>(rnd());
+    res.name.resize(rnd() % 20, 'a');
+    res.items.resize(rnd() % 10);
+    for (auto& item: res.items)
+        item = MyStruct1{static_cast<int32_t>(rnd()), static_cast<int32_t>(rnd())};
+    res.samples.resize(rnd() % 30);
+    for (auto& v: res.samples)
+        v = static_cast<uint16_t>(rnd());
+    res.flag = rnd() % 2 == 0;
+    res.level = static_cast<uint8_t>(rnd() % 11);
+    res.kind = MyEnumClass::E3;
+    res.s1 = MyStruct1{static_cast<int32_t>(rnd()), 5};
+    return res;
+}
+
+using UnsafeInputAdapter = bitsery::UnsafeInputBufferAdapter<Buffer>;
+
+TEST(DeserializeValidation, ValidDataIsAcceptedAndCanBeDeserializedUsingUnsafeAdapter) {
+    std::mt19937 rnd{7};
+    auto data = createValidationMessage(rnd);
+    Buffer buf{};
+    auto size = bitsery::quickSerialization(OutputAdapter{buf}, data);
+
+    ValidationMessage scratch{};
+    auto state = bitsery::quickValidation(InputAdapter{buf.begin(), size}, scratch);
+    EXPECT_THAT(state.first, Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(state.second);
+    //scratch object is not filled with data
+    EXPECT_THAT(scratch.items.size(), Eq(0u));
+    EXPECT_THAT(scratch.name.size(), Eq(0u));
+
+    ValidationMessage res{};
+    auto resState = bitsery::quickDeserialization(UnsafeInputAdapter{buf.begin(), size}, res);
+    EXPECT_THAT(resState.first, Eq(bitsery::ReaderError::NoError));
+    EXPECT_THAT(res, Eq(data));
+}
+
+TEST(DeserializeValidation, WhenSizeExceedsMaxSizeThenInvalidData) {
+    ValidationMessage data{};
+    data.name.resize(25, 'x');
+    Buffer buf{};
+    auto size = serializeInvalidMessage(buf, data);
+    ValidationMessage scratch{};
+    auto state = bitsery::quickValidation(InputAdapter{buf.begin(), size}, scratch);
+    EXPECT_THAT(state.first, Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(DeserializeValidation, WhenValueIsOutOfRangeThenInvalidData) {
+    ValidationMessage data{};
+    data.level = 15;
+    Buffer buf{};
+    auto size = serializeInvalidMessage(buf, data);
+    ValidationMessage scratch{};
+    auto state = bitsery::quickValidation(InputAdapter{buf.begin(), size}, scratch);
+    EXPECT_THAT(state.first, Eq(bitsery::ReaderError::InvalidData));
+}
+
+TEST(DeserializeValidation, SessionsAreValidatedWithSameConfig) {
+    using SessionsValidator = bitsery::BasicDeserializer<
+        bitsery::AdapterReader<InputAdapter, bitsery::ValidationConfig<SessionsEnabledConfig>>>;
+    BasicSerializationContext<SessionsEnabledConfig, void> ctx;
+    auto& ser = ctx.createSerializer();
+    auto& w = *ctx.bw;
+    std::string str{"some text"};
+    w.beginSession();
+    ser.text1b(str, 100);
+    ser.value4b(uint32_t{5});
+    w.endSession();
+    w.flush();
+
+    //validate with older version, that only knows about text
+    SessionsValidator validator{InputAdapter{ctx.buf.begin(), w.writtenBytesCount()}};
+    auto& r = bitsery::AdapterAccess::getReader(validator);
+    std::string scratch{};
+    r.beginSession();
+    validator.text1b(scratch, 100);
+    r.endSession();
+    EXPECT_THAT(r.error(), Eq(bitsery::ReaderError::NoError));
+    EXPECT_TRUE(r.isCompletedSuccessfully());
+    EXPECT_THAT(scratch.size(), Eq(0u));
+}
+
+TEST(DeserializeValidation, FuzzValidationHasSameResultAsDeserialization) {
+    std::mt19937 rnd{12345};
+    size_t accepted{};
+    size_t rejected{};
+    for (auto i = 0; i < 3000; ++i) {
+        auto data = createValidationMessage(rnd);
+        Buffer buf{};
+        auto size = bitsery::quickSerialization(OutputAdapter{buf}, data);
+        switch (rnd() % 4) {
+            case 0:
+                //truncate
+                size = rnd() % (size + 1);
+                break;
+            case 1:
+                //add garbage at the end
+                buf.resize(size + 1 + rnd() % 10);
+                size = buf.size();
+                break;
+            default: {
+                //flip random bytes
+                auto count = 1 + rnd() % 3;
+                for (auto j = 0u; j < count; ++j)
+                    buf[rnd() % size] = static_cast<char>(rnd());
+            }
+        }
+
+        ValidationMessage res{};
+        auto expected = bitsery::quickDeserialization(InputAdapter{buf.begin(), size}, res);
+        ValidationMessage scratch{};
+        auto state = bitsery::quickValidation(InputAdapter{buf.begin(), size}, scratch);
+        ASSERT_THAT(state, Eq(expected)) << "iteration " << i;
+
+        if (state.first == bitsery::ReaderError::NoError && state.second) {
+            ++accepted;
+            ValidationMessage unsafeRes{};
+            bitsery::quickDeserialization(UnsafeInputAdapter{buf.begin(), size}, unsafeRes);
+            ASSERT_THAT(unsafeRes, Eq(res)) << "iteration " << i;
+        } else {
+            ++rejected;
+        }
+    }
+    EXPECT_THAT(accepted, Gt(100u));
+    EXPECT_THAT(rejected, Gt(100u));
+}